@@ -14,7 +14,9 @@ MxxRu::Cpp::lib_target("frl.lib.debug.rb")\
 	global_cpp_compiler_option( "-Wall" )
 	end
 
+	if "mswin" == toolset.tag( "target_os" )
 	required_prj( "frl.dependency.vendors.opc_foundation.debug.rb" )
+	end
 	target("frl_d")
 
 	global_include_path("../../../include")
@@ -24,14 +26,21 @@ MxxRu::Cpp::lib_target("frl.lib.debug.rb")\
 	lib_path( "#{ENV['BOOST_HOME']}" + "/stage/lib" )
 
 	# if you using version MinGW != 3.4.5, you maybe need correct libs name
-	if "vc" != toolset.name
+	if "mswin" != toolset.tag( "target_os" )
+		lib("boost_thread")
+		lib("boost_system")
+		lib("boost_chrono")
+		lib("pthread")
+	elsif "vc" != toolset.name
 		lib("libboost_thread-mgw34-mt-sd")
 		lib("libboost_filesystem-mgw34-mt-sd")
 		lib("libboost_system-mgw34-mt-sd")
+		lib("libboost_chrono-mgw34-mt-sd")
 	else
 		# Visual C++ compiler supports auto-linking
 	end
 
+	if "mswin" == toolset.tag( "target_os" )
 	lib( "shell32" )
 	lib( "oleaut32" )
 	lib( "kernel32" )
@@ -39,8 +48,19 @@ MxxRu::Cpp::lib_target("frl.lib.debug.rb")\
 	lib( "ole32" )
 	lib( "user32" )
 	lib( "uuid" )
+	end
 	
 	obj_placement( MxxRu::Cpp::CustomSubdirObjPlacement.new( "../../../output/frl_lib",\
 	"../../../output/frl_lib/obj/#{mxx_runtime_mode}/1/2/3" ) )
+	if "mswin" == toolset.tag( "target_os" )
 	cpp_sources Dir.glob( "../../../src/**/*.cpp" )
+	else
+	# only platform independent part of library (OPC address space core, update scheduling)
+	cpp_source( "../../../src/frl_exception.cpp" )
+	cpp_source( "../../../src/frl_string.cpp" )
+	cpp_sources Dir.glob( "../../../src/sys/*.cpp" )
+	cpp_sources Dir.glob( "../../../src/opc/address_space/*.cpp" )
+	cpp_source( "../../../src/opc/frl_opc_update_scheduler.cpp" )
+	cpp_source( "../../../src/opc/frl_opc_executor.cpp" )
+	end
 }
@@ -0,0 +1,9 @@
+#!/bin/sh
+# Build platform independent part of library (OPC address space core),
+# its unit tests and benchmark.
+export MXX_RU_CPP_TOOLSET=gcc_linux
+cd debug
+ruby frl.lib.debug.rb
+ruby frl.test.opc_address_space.debug.rb
+ruby frl.test.opc_address_space_bench.debug.rb
+cd ..
@@ -0,0 +1,9 @@
+#!/bin/sh
+# Build platform independent part of library (OPC address space core),
+# its unit tests and benchmark.
+export MXX_RU_CPP_TOOLSET=gcc_linux
+cd release
+ruby frl.lib.release.rb
+ruby frl.test.opc_address_space.release.rb
+ruby frl.test.opc_address_space_bench.release.rb
+cd ..
@@ -0,0 +1,14 @@
+require 'mxx_ru/cpp'
+
+MxxRu::Cpp::exe_target("frl.test.opc_address_space_bench.release.rb")\
+{
+	required_prj( "frl.lib.release.rb" )
+	target("test_opc_address_space_bench")
+	include_path("../../../test/opc_address_space_bench")
+	runtime_mode( MxxRu::Cpp::RUNTIME_RELEASE )
+	rtl_mode( MxxRu::Cpp::RTL_STATIC )
+	threading_mode( MxxRu::Cpp::THREADING_MULTI )
+	obj_placement( MxxRu::Cpp::CustomSubdirObjPlacement.new( "../../../output/test/opc_address_space_bench",\
+	"../../../output/test/opc_address_space_bench/obj/#{mxx_runtime_mode}/1/2/3" ) )
+	cpp_sources Dir.glob( "../../../test/opc_address_space_bench/**/*.cpp" )
+}
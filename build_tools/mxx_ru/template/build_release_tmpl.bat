@@ -6,6 +6,7 @@ ruby frl.test.os_win32_registry.release.rb
 ruby frl.test.lexical_cast.release.rb
 ruby frl.test.logging.release.rb
 ruby frl.test.opc_address_space.release.rb
+ruby frl.test.opc_address_space_bench.release.rb
 ruby frl.test.opc_write_event_subscribe.release.rb
 ruby frl.test.opc_test.release.rb
 ruby frl.test.poor_xml.release.rb
@@ -6,7 +6,10 @@ def test_setup()
 	lib_path( "#{ENV['BOOST_HOME']}" + "/stage/lib" )
 
 	# if you using version MinGW != 3.4.5, you maybe need correct libs name
-	if "vc" != toolset.name
+	if "mswin" != toolset.tag( "target_os" )
+		define( "BOOST_TEST_DYN_LINK" )
+		lib("boost_unit_test_framework")
+	elsif "vc" != toolset.name
 		if Mxx_ru::Cpp::RUNTIME_DEBUG != mxx_runtime_mode
 			lib("libboost_unit_test_framework-mgw34-mt-s")
 		else
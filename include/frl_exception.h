@@ -34,15 +34,13 @@ protected:
 	String function;
 	String file;
 	std::string whatDescription;	
-	UShort stackDepth;
-
-	// Static members.
-	static Exception *last;
-	static String msFunctionStack[ FRL_CALL_STACK_DEPTH ];
-	static UShort msStackDepth;
+	std::vector< String > callStack; // guarded functions of thread at creation, outer first
 
 	// Default constructor.
 	Exception();
+
+	// Copy guarded functions of current thread.
+	void saveCallStack();
 public:
 
 	// Constructor.
@@ -84,13 +82,13 @@ public:
 	// Return string with only function name of exception.
 	const String& GetFunction( void ) const throw() { return function; }
 
-	// Retrieves a pointer to the last exception created.		
-	static Exception* GetLastException(void) throw() { return last; }
+	// Retrieves a pointer to the last exception created by current thread.
+	static Exception* GetLastException(void) throw();
 
-	// Pushed a function on the stack.
+	// Pushed a function on the stack of current thread.
 	static void pushFunction( const String& strFuncName ) throw();
 	
-	// Pops a function from the stack.
+	// Pops a function from the stack of current thread.
 	static void popFunction() throw();
 	
 	// Class for automatically push/pop the function name for unwinding stack.
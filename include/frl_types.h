@@ -9,6 +9,10 @@
 	#include <Windows.h>
 #endif // FRL_PLATFORM_WIN32
 
+#if( FRL_PLATFORM == FRL_PLATFORM_LINUX )
+	#include <pthread.h>
+#endif // FRL_PLATFORM_LINUX
+
 namespace frl{
 
 // Redefinitions types of variables
@@ -101,12 +105,12 @@ namespace io{ namespace fs{
 
 // Definitions types variables for works with file system
 #if( FRL_PLATFORM ==  FRL_PLATFORM_LINUX )
-	typedef frl::Int FileDerscriptor;	// File handle
+	typedef frl::Int FileDescriptor;	// File handle
 	typedef frl::Long FileOffset;		// File offset (position)
 	typedef size_t FileRWCount; // Number read-write simbols in read-write operations
 
-	const Descriptor InvalidFileDescriptor = -1;	// Invalid file handle
-	const Offset InvalidFileOffset = -1;		// Invalid file offset (position)
+	const FileDescriptor InvalidFileDescriptor = -1;	// Invalid file handle
+	const FileOffset InvalidFileOffset = -1;		// Invalid file offset (position)
 #endif // FRL_PLATFORM_LINUX
 
 #if( FRL_PLATFORM ==  FRL_PLATFORM_WIN32 )
@@ -1,37 +1,50 @@
 #ifndef frl_opc_addr_space_crawler_h_
 #define frl_opc_addr_space_crawler_h_
-#include "frl_platform.h"
-#if( FRL_PLATFORM == FRL_PLATFORM_WIN32 )
 #include <vector>
 #include "frl_types.h"
 #include "frl_exception.h"
+#include "opc/address_space/frl_opc_name_pattern.h"
+#include "opc/address_space/frl_opc_value.h"
 
 namespace frl{ namespace opc{ namespace address_space{
 
 class Tag;
+class AddressSpace;
 struct TagBrowseInfo;
+
+// Position in tree of address space. Every browse holds current
+// namespace version, so reconfiguration may go on concurrently.
+// Branches are found segment by segment in sorted children (tree of
+// address space is trie of path segments). TagBrowseInfo refers to IDs
+// of tags, so caller holds version (AddressSpace::getVersion) while using it.
 class AddrSpaceCrawler
 {
 private:
+	AddressSpace *space;
 	Tag *curPos;
 	Tag *root;
 public:
 
+	// Crawler of opcAddressSpace.
 	AddrSpaceCrawler();
+
+	explicit AddrSpaceCrawler( AddressSpace &space_ );
 	
 	void goToRoot();
 
 	Bool goUp();
 
-	void goDown( const String &path );
+	// Path is relative to current branch, one or more segments.
+	// Return False (position is not changed) if branch not exist.
+	Bool goDown( const String &path );
 
-	void goTo( const String &fullPath );
+	Bool goTo( const String &fullPath );
 
 	String getCurPosPath();
 
 	void browseBranches( std::vector< String > &branches );
 
-	void browseLeafs( std::vector< String > &leafs, DWORD accessFilter = 0 );
+	void browseLeafs( std::vector< String > &leafs, UInt accessFilter = 0, DataType dataType = data_type::EMPTY );
 	
 	void browseLeafs( std::vector< TagBrowseInfo > &leafsArr );
 	
@@ -39,11 +52,18 @@ public:
 	
 	void browse( std::vector< TagBrowseInfo > &arr );
 
+	// Page of current branch, see Tag::browsePage.
+	Bool browsePage(	std::vector< TagBrowseInfo > &arr,
+							UInt filter,
+							const String &fromID,
+							size_t maxCount,
+							const NamePattern &nameFilter,
+							String &nextID );
+
 }; // class AddrSpaceCrawler
 
 } // namespace address_space
 } // namespace opc
 } // namespace frl
 
-#endif // FRL_PLATFORM_WIN32
 #endif // frl_opc_addr_space_crawler_h_
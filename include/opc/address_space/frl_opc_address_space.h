@@ -1,30 +1,102 @@
 #ifndef frl_opc_address_space_h_
 #define frl_opc_address_space_h_
-#include "frl_platform.h"
-#if( FRL_PLATFORM == FRL_PLATFORM_WIN32 )
 #include <vector>
 #include <map>
 #include "opc/address_space/frl_opc_tag.h"
+#include "opc/address_space/frl_opc_tag_index.h"
+#include "opc/address_space/frl_opc_tag_arena.h"
+#include "opc/address_space/frl_opc_tag_handle.h"
+#include "opc/address_space/frl_opc_snapshot.h"
+#include "opc/address_space/frl_opc_namespace_version.h"
 #include "frl_exception.h"
 #include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/atomic.hpp>
+#include <boost/thread/mutex.hpp>
 #include "frl_singleton.h"
 
 namespace frl{ namespace opc{ namespace address_space{
 
+// Description of leaf for bulk creation (AddressSpace::addLeafs).
+struct LeafDefinition
+{
+	String fullPath;
+	DataType dataType;
+	UInt accessRights;
+	UInt scanRate;
+
+	LeafDefinition();
+	LeafDefinition( const String &fullPath_,
+						DataType dataType_ = data_type::EMPTY,
+						UInt accessRights_ = access_rights::READABLE,
+						UInt scanRate_ = 0 );
+};
+
+// Reconfiguration (adding and removal of tags) does not block readers:
+// every change is collected aside and published atomically as new
+// NamespaceVersion. Lookups by ID see tags of published versions only,
+// reader of whole tree (browsing of all leafs, snapshot) holds version
+// and does not see tags created after it. Writers are serialized.
+// Removed tag stays allocated while any version older than removal is held,
+// so pointer to tag is safe while version taken before lookup is held;
+// TagHandle is safe to keep without version.
 class AddressSpace : private boost::noncopyable
 {
 private:
+	// Changes of one reconfiguration: serializes writers and publishes
+	// new version when leaves scope (tags created before exception too).
+	class Update : private boost::noncopyable
+	{
+	private:
+		AddressSpace &space;
+		boost::mutex::scoped_lock guard;
+		boost::shared_ptr< NamespaceVersion > next;
+	public:
+		explicit Update( AddressSpace &space_ );
+
+		~Update();
+	}; // class Update
+	friend class Update;
+
 	String delimiter;
 	Tag *rootTag;
 	Bool init;
-	std::map< String, Tag* > nameLeafCache;
-	std::map< String, Tag* > nameBranchCache;
+	TagArena arena;
+	TagHandleTable handles;
+	TagIndex nameLeafCache;
+	TagIndex nameBranchCache;
+	TagAttributesIndex attributes; // of leafs
+	boost::mutex updateGuard;
+	boost::shared_ptr< NamespaceVersion > current; // changed only by writer under updateGuard
+	boost::atomic< UInt > publishedVersion; // number of current version
+	std::map< Tag*, Tag::Children* > drafts; // new arrays of children of update in progress
+	std::vector< Tag* > removedTags; // tops of subtrees removed by update in progress
+
+	Bool isValidPath( const PathView &fullPath ) const;
+	Tag* placeTag( Tag *parent, const String &fullPath, Bool isBranch );
+	Tag* createTag( Tag *parent, const String &fullPath, Bool isBranch );
+	Tag* createBranchPath( const PathView &fullPath );
+	Tag::Children& draftChildren( Tag *branch );
+	void publish( const boost::shared_ptr< NamespaceVersion > &next );
+	Bool isPublished( const Tag *tag ) const;
+	void saveTag(	const Tag *tag, UInt parent, UInt maxVersion,
+						std::vector< snapshot::Record > &records, String &pool ) const;
+	void checkSnapshot( const char *image, size_t size ) const;
+	void collectLeafs(	const std::vector< UInt > &slots, UInt accessFilter, DataType dataType,
+							UInt maxVersion, std::vector< String > &namesList ) const;
+	void checkMerge( const Tag *source ) const;
+	void moveChildren( Tag *target, Tag *source, std::vector< Tag* > &moved, std::vector< Tag* > &dropped );
 
 public:
 
 	FRL_EXCEPTION_CLASS( NotFinalConstruct );
 	FRL_EXCEPTION_CLASS( InvalidBranchName );
 	FRL_EXCEPTION_CLASS( InvalidLeafName );
+	FRL_EXCEPTION_CLASS( InvalidSnapshot );
+	FRL_EXCEPTION_CLASS( SnapshotFileError );
+	FRL_EXCEPTION_CLASS( IsNotEmpty );
+	FRL_EXCEPTION_CLASS( DifferentDelimiter );
+	FRL_EXCEPTION_CLASS( InvalidParameter );
 
 	AddressSpace();
 
@@ -32,33 +104,121 @@ public:
 
 	const String& getDelimiter() const;
 
+	// Delimiter is one character, '.' if it is empty.
+	// Throw InvalidParameter if it is longer.
 	void finalConstruct( const String &delimiter_ );
 
 	void addBranch( const String &fullPath );
 
-	Tag* getBranch( const String& fullPath );
+	Tag* getBranch( const PathView &fullPath );
 
 	Tag* getLeaf( const String& fullPath );
 
 	Tag* getTag( const String &fullPath );
 
+	// Non-throwing lookup: return NULL if tag not exist.
+	// Part of other ID may be passed as PathView without copying.
+	Tag* findBranch( const PathView &fullPath ) const;
+
+	Tag* findLeaf( const PathView &fullPath ) const;
+
+	Tag* findTag( const PathView &fullPath ) const;
+
 	Tag* addLeaf( const String& fullPath, Bool createPath = False );
 
-	Bool isExistBranch( const String &name ) const;
+	// Bulk creation of leafs: definitions are sorted, missing branches
+	// created once, tags allocated from contiguous arena.
+	// All definitions checked before anything is created, so on exception
+	// (InvalidLeafName, Tag::IsExistTag, Tag::IsNotBranch) address space is not changed.
+	// added[i] is leaf created for leafs[i].
+	void addLeafs( const std::vector< LeafDefinition > &leafs, std::vector< Tag* > &added );
+
+	void addLeafs( const std::vector< LeafDefinition > &leafs );
+
+	// Remove leaf or branch with all its sub-branches and leafs.
+	// Handles of removed tags become stale, listeners are notified
+	// and unsubscribed. Throw Tag::NotExistTag if tag not exist
+	// (root branch can not be removed).
+	void removeTag( const String &fullPath );
+
+	// Move all tags of part into this address space: part is separate
+	// address space built by other thread (for example subtree of one device),
+	// so parts are built in parallel and merged at the end. Branches of part
+	// which exist here already are merged with existing ones, tags keep their
+	// addresses and get new handles. Part stays empty and is not read by
+	// anybody during merge. Throw DifferentDelimiter, Tag::IsExistTag or
+	// Tag::IsNotBranch before anything is moved.
+	void merge( AddressSpace &part );
+
+	// Parts are merged one by one, parts before failed one stay merged.
+	void merge( const std::vector< AddressSpace* > &parts );
+
+	// Handle of tag created by address space, null handle for other tags.
+	TagHandle getHandle( const Tag *tag ) const;
 
-	Bool isExistLeaf( const String &name ) const;
+	// Return NULL if tag of handle was removed.
+	Tag* findTag( const TagHandle &handle ) const;
 
-	Bool isExistTag( const String &name ) const;
+	Bool isExistBranch( const PathView &name ) const;
+
+	Bool isExistLeaf( const PathView &name ) const;
+
+	Bool isExistTag( const PathView &name ) const;
 
 	Tag* getRootBranch();
 
-	void getAllLeafs( std::vector< String > &namesList, DWORD accessFilter ) const;
+	// Leafs in order of tree. Leafs with access filter are taken from
+	// secondary index when few of them match.
+	void getAllLeafs( std::vector< String > &namesList, UInt accessFilter ) const;
+
+	// Full IDs of leafs with all rights of accessFilter (0 - any) and
+	// canonical type dataType (data_type::EMPTY - any) in no particular order.
+	// Only matching leafs are visited (see TagAttributesIndex).
+	void findLeafs( std::vector< String > &namesList, UInt accessFilter, DataType dataType ) const;
+
+	// Full IDs of leafs matched by pattern, see Tag::browseAllLeafs.
+	void getAllLeafs( std::vector< String > &namesList, const NamePattern &pattern, UInt accessFilter ) const;
+
+	// Next at most maxCount leafs after leaf afterID, see Tag::browseAllLeafs.
+	void getLeafsPage(	std::vector< String > &namesList,
+							const NamePattern &pattern,
+							UInt accessFilter,
+							const String &afterID,
+							size_t maxCount ) const;
+
+	// Walk all tags and estimate used memory.
+	MemoryUsage getMemoryUsage() const;
+
+	// Current version: arrays of children which reader reached and
+	// tags which reader found stay unchanged and allocated while version is held.
+	// Browsing of branch (Tag::browse*) must be done under version.
+	NamespaceVersionPtr getVersion() const;
+
+	// Binary image of whole tree: IDs, data types, access rights,
+	// scan rates, last values, qualities and time stamps (see snapshot::Header).
+	void saveSnapshot( std::vector< char > &image ) const;
+
+	// Throw SnapshotFileError if file can not be written.
+	void saveSnapshot( const String &fileName ) const;
+
+	// Build tree from image. Address space must be empty, finalConstruct
+	// is called with delimiter of image if it was not called before.
+	// Whole image is checked before anything is created:
+	// throw InvalidSnapshot (address space is not changed) or IsNotEmpty.
+	void loadSnapshot( const char *image, size_t size );
+
+	// Image file is mapped into memory, not read.
+	// Throw SnapshotFileError if file can not be opened.
+	void loadSnapshot( const String &fileName );
 
 	Bool isInit() const;
 };
 
 } // namespace address_space
 
+// Default address space of process. Components which work with address
+// space (servers, crawlers, groups, sampling) take instance to work with,
+// so independent address spaces may live side by side.
 typedef SingletonMeyers< address_space::AddressSpace > opcAddressSpace;
 
 namespace private_
@@ -69,5 +229,4 @@ namespace private_
 } // namespace opc
 } // FatRat Library
 
-#endif // FRL_PLATFORM_WIN32
 #endif // frl_opc_address_space_h_
@@ -0,0 +1,67 @@
+#ifndef frl_opc_change_queue_h_
+#define frl_opc_change_queue_h_
+#include <vector>
+#include <boost/atomic.hpp>
+#include <boost/function.hpp>
+#include <boost/thread/mutex.hpp>
+#include "frl_types.h"
+#include "opc/address_space/frl_opc_tag_listener.h"
+
+namespace frl{ namespace opc{ namespace address_space{
+
+// Keys of changed items, collected by tag listeners for consumer
+// (group update), so consumer processes only changed items instead of
+// scanning all. Memory of queue is reused, so after warm up push does not allocate.
+class ChangeQueue : private boost::noncopyable
+{
+private:
+	boost::mutex guard;
+	std::vector< UInt > keys;
+	boost::function< void() > wakeUp;
+public:
+	void push( UInt key );
+
+	// Called when key is pushed into empty queue, so consumer which has
+	// nothing to do may sleep until change. Called under lock of queue.
+	void setWakeUp( const boost::function< void() > &wakeUp_ );
+
+	// Move collected keys to changed (previous content of changed is dropped,
+	// its memory is used for next keys).
+	void take( std::vector< UInt > &changed );
+
+	size_t size();
+}; // class ChangeQueue
+
+// Listener which puts its key into ChangeQueue.
+// Item is queued once until consumer clears dirty flag,
+// so burst of changes of one tag costs one entry.
+class QueuedTagListener : public TagListener
+{
+private:
+	ChangeQueue *queue;
+	UInt key;
+	boost::atomic< Bool > dirty;
+public:
+	QueuedTagListener();
+
+	~QueuedTagListener();
+
+	// Listener and its key go to queue on every change of tag.
+	void setQueue( ChangeQueue *queue_, UInt key_ );
+
+	// Queue item without change of tag (for example, to send initial value).
+	void markChanged();
+
+	Bool isDirty() const;
+
+	// Called by consumer before reading tag: next change queues item again.
+	void clearDirty();
+
+	virtual void onTagChange( const Tag *changed );
+}; // class QueuedTagListener
+
+} // namespace address_space
+} // namespace opc
+} // FatRat Library
+
+#endif // frl_opc_change_queue_h_
@@ -0,0 +1,56 @@
+#ifndef frl_opc_deadband_filter_h_
+#define frl_opc_deadband_filter_h_
+#include <vector>
+#include "frl_types.h"
+
+namespace frl{ namespace opc{ namespace address_space{
+
+// Percent deadband of OPC DA: change of analog item is sent only if its value
+// differs from last sent value by more than deadband percent of EU range.
+// Changes of one group update are added together and checked by one pass
+// over flat arrays, memory of arrays is reused by next updates.
+class DeadbandFilter
+{
+private:
+	std::vector< Double > sent;
+	std::vector< Double > current;
+	std::vector< Double > threshold;
+	std::vector< UChar > passed;
+	ULong checked;
+	ULong suppressed;
+public:
+	// Threshold of change which is sent anyway.
+	static const Double noDeadband;
+
+	DeadbandFilter();
+
+	// Least difference of values which is sent, noDeadband if percent
+	// is not positive or EU range is empty.
+	static Double getThreshold( Float percent, Double lowEU, Double highEU );
+
+	// Drop changes of previous check.
+	void clear();
+
+	// Return index of change for isPassed.
+	size_t add( Double sentValue, Double currentValue, Double threshold_ );
+
+	// Check all added changes.
+	void run();
+
+	// Change must be sent (valid after run).
+	Bool isPassed( size_t index ) const;
+
+	size_t size() const;
+
+	// Number of changes checked by all runs.
+	ULong getChecked() const;
+
+	// Number of changes which were not sent due to deadband.
+	ULong getSuppressed() const;
+}; // class DeadbandFilter
+
+} // namespace address_space
+} // namespace opc
+} // FatRat Library
+
+#endif // frl_opc_deadband_filter_h_
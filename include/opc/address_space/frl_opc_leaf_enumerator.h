@@ -0,0 +1,52 @@
+#ifndef frl_opc_leaf_enumerator_h_
+#define frl_opc_leaf_enumerator_h_
+#include <vector>
+#include "frl_types.h"
+#include "opc/address_space/frl_opc_name_pattern.h"
+
+namespace frl{ namespace opc{ namespace address_space{
+
+class AddressSpace;
+
+const size_t defaultLeafsChunk = 256;
+
+// Lazy enumeration of leafs of whole address space (flat browsing).
+// Leafs are collected by chunks when requested; enumerator keeps
+// only current chunk and ID of the last collected leaf, so memory
+// does not depend on size of address space.
+// Address space must outlive enumerator.
+class LeafEnumerator
+{
+private:
+	const AddressSpace *space;
+	NamePattern pattern;
+	UInt accessFilter;
+	size_t chunkSize;
+	std::vector< String > chunk;
+	size_t chunkPos;
+	Bool finished;
+
+	Bool fill();
+public:
+	LeafEnumerator(	const AddressSpace &space_,
+						const NamePattern &pattern_ = NamePattern(),
+						UInt accessFilter_ = 0,
+						size_t chunkSize_ = defaultLeafsChunk );
+
+	// Return False if enumeration is over.
+	Bool next( String &id );
+
+	Bool hasNext();
+
+	// Return number of skipped leafs.
+	size_t skip( size_t count );
+
+	// Start from the first leaf.
+	void reset();
+}; // class LeafEnumerator
+
+} // namespace address_space
+} // namespace opc
+} // FatRat Library
+
+#endif // frl_opc_leaf_enumerator_h_
@@ -0,0 +1,68 @@
+#ifndef frl_opc_name_pattern_h_
+#define frl_opc_name_pattern_h_
+#include <vector>
+#include "frl_types.h"
+#include "opc/address_space/frl_opc_path_view.h"
+
+namespace frl{ namespace opc{ namespace address_space{
+
+// OPC filter of element names (syntax of Visual Basic LIKE operator):
+// '*' - zero or more chars, '?' - any char, '#' - digit,
+// [abc], [a-z] - char from set, [!abc] - char not from set.
+// Pattern parsed once, then matched against many names without allocations.
+class NamePattern
+{
+private:
+	enum OpType
+	{
+		LITERAL,
+		ANY_CHAR,
+		DIGIT,
+		CHAR_SET,
+		ANY_STRING
+	};
+
+	struct Op
+	{
+		OpType type;
+		Char symbol; // LITERAL
+		Bool negate; // CHAR_SET
+		size_t setBegin; // CHAR_SET: ranges [setBegin, setEnd) in ranges
+		size_t setEnd;
+	};
+
+	std::vector< Op > program;
+	std::vector< std::pair< Char, Char > > ranges;
+	String prefix;
+	size_t tailBegin; // chars after the last '*' are matched from end of name
+	Bool caseSensitive;
+
+	void compile( const String &pattern );
+	Bool matchOne( const Op &op, Char symbol ) const;
+	Bool run( const PathView &str, Bool partial ) const;
+public:
+	// Match all names.
+	NamePattern();
+
+	explicit NamePattern( const String &pattern, Bool caseSensitive_ = True );
+
+	// True if pattern accepts any name (empty pattern or "*").
+	Bool isMatchAll() const;
+
+	// Literal beginning of every matching name (empty for case insensitive pattern).
+	const String& getPrefix() const;
+
+	Bool match( const PathView &str ) const;
+
+	// False if no name beginning with str can match
+	// (used to skip whole branches).
+	Bool matchBeginning( const PathView &str ) const;
+
+	Bool operator()( const String &str ) const;
+}; // class NamePattern
+
+} // namespace address_space
+} // namespace opc
+} // FatRat Library
+
+#endif // frl_opc_name_pattern_h_
@@ -0,0 +1,53 @@
+#ifndef frl_opc_namespace_version_h_
+#define frl_opc_namespace_version_h_
+#include <vector>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include "frl_types.h"
+#include "opc/address_space/frl_opc_tag_index.h"
+
+namespace frl{ namespace opc{ namespace address_space{
+
+class Tag;
+class TagArena;
+class AddressSpace;
+
+// Number of version which sees all tags.
+const UInt lastVersion = 0xFFFFFFFF;
+
+// One published state of address space tree (see AddressSpace::getVersion).
+// Reconfiguration never changes arrays of children in place: new arrays
+// are published and replaced ones are retired to version which was current
+// before. Every version keeps next one alive, so retired array is freed
+// only when nobody holds this or any older version. Removed tags and
+// replaced tables of indexes are retired the same way, tags are destroyed
+// and returned to arena, so versions must be released before address space.
+class NamespaceVersion : private boost::noncopyable
+{
+private:
+	friend class AddressSpace;
+
+	UInt number;
+	TagArena *arena;
+	std::vector< std::vector< Tag* >* > retired;
+	std::vector< Tag* > removed; // tops of removed subtrees
+	std::vector< TagIndex::Table* > replacedTables;
+	boost::shared_ptr< NamespaceVersion > next;
+
+	static void disposeTag( Tag *tag, TagArena *arena );
+public:
+	NamespaceVersion( UInt number_, TagArena *arena_ );
+
+	~NamespaceVersion();
+
+	// Tags created by later versions are not visible for readers of this one.
+	UInt getNumber() const;
+}; // class NamespaceVersion
+
+typedef boost::shared_ptr< const NamespaceVersion > NamespaceVersionPtr;
+
+} // namespace address_space
+} // namespace opc
+} // FatRat Library
+
+#endif // frl_opc_namespace_version_h_
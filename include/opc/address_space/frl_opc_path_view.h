@@ -0,0 +1,89 @@
+#ifndef frl_opc_path_view_h_
+#define frl_opc_path_view_h_
+#include "frl_types.h"
+
+namespace frl{ namespace opc{ namespace address_space{
+
+// Item ID or part of it (branch path, segment) referring to characters
+// of other string: nothing is copied, so string must outlive view.
+class PathView
+{
+private:
+	const Char *first;
+	size_t length;
+public:
+	PathView();
+
+	PathView( const String &str );
+
+	// Zero terminated string.
+	PathView( const Char *str );
+
+	PathView( const Char *str, size_t length_ );
+
+	const Char* data() const;
+
+	size_t size() const;
+
+	Bool empty() const;
+
+	Char operator[]( size_t pos ) const;
+
+	// First length_ symbols.
+	PathView prefix( size_t length_ ) const;
+
+	// Symbols from pos to the end.
+	PathView suffix( size_t pos ) const;
+
+	// Return String::npos if symbol not found.
+	size_t find( Char symbol, size_t from = 0 ) const;
+
+	size_t rfind( Char symbol ) const;
+
+	Bool startsWith( const PathView &other ) const;
+
+	int compare( const PathView &other ) const;
+
+	Bool operator == ( const PathView &other ) const;
+
+	Bool operator != ( const PathView &other ) const;
+
+	Bool operator < ( const PathView &other ) const;
+
+	String toString() const;
+
+	// Path of parent branch, empty for tags of root branch.
+	PathView getParent( Char delimiter ) const;
+
+	// Last segment of path.
+	PathView getShortName( Char delimiter ) const;
+
+	// Not empty and has no empty segments.
+	Bool isValid( Char delimiter ) const;
+}; // class PathView
+
+// Splits path into segments separated by delimiter, segments refer to path.
+class PathTokenizer
+{
+private:
+	PathView path;
+	Char delimiter;
+	size_t pos; // begin of next segment, String::npos - no more segments
+	size_t walked; // end of last segment
+public:
+	PathTokenizer( const PathView &path_, Char delimiter_ );
+
+	// Return False if there are no more segments.
+	Bool next( PathView &segment );
+
+	// Path up to the end of last segment returned by next.
+	PathView getWalked() const;
+
+	Bool isLast() const;
+}; // class PathTokenizer
+
+} // namespace address_space
+} // namespace opc
+} // FatRat Library
+
+#endif // frl_opc_path_view_h_
@@ -0,0 +1,111 @@
+#ifndef frl_opc_sampling_scheduler_h_
+#define frl_opc_sampling_scheduler_h_
+#include <vector>
+#include <map>
+#include <boost/noncopyable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/thread.hpp>
+#include "frl_types.h"
+#include "opc/address_space/frl_opc_tag_handle.h"
+
+namespace frl{ namespace opc{ namespace address_space{
+
+class Tag;
+class AddressSpace;
+
+// Source of tag values (device, channel of device), see SamplingScheduler.
+class SamplingDriver
+{
+public:
+	virtual ~SamplingDriver();
+
+	// Read tags from device now and write their values.
+	// Called by thread of scheduler with all tags of driver which are due,
+	// tags stay allocated during call even if they are removed meanwhile.
+	virtual void sample( const std::vector< Tag* > &tags ) = 0;
+}; // class SamplingDriver
+
+// Central acquisition by scan rates of tags (Tag::getScanRate,
+// tags with zero rate are sampled with default rate).
+// Tags of one driver with same rate form batch, batches are placed into
+// timer wheel with slots of tick milliseconds, so one tick costs
+// as much as batches due in it. Due tags of every driver are passed to it
+// by one call. Change of scan rate of tag is taken into account at next
+// sample, removed tags are dropped.
+class SamplingScheduler : private boost::noncopyable
+{
+private:
+	struct Batch
+	{
+		SamplingDriver *driver;
+		UInt rate; // in ticks
+		ULong due; // tick of next sample
+		UInt visits; // samples of batch, counts samples of tags without demand
+		std::vector< TagHandle > tags;
+	};
+	typedef std::map< std::pair< SamplingDriver*, UInt >, Batch* > Batches;
+	typedef std::map< SamplingDriver*, std::vector< Tag* > > Calls;
+
+	AddressSpace &space;
+	UInt tick;
+	UInt defaultRate;
+	Bool demandDriven;
+	UInt idleRate; // in ticks, 0 - tags without demand are not sampled
+	boost::mutex guard; // batches and wheel
+	boost::mutex sampleGuard; // held while drivers are called
+	Batches batches;
+	std::vector< std::vector< Batch* > > slots; // slot of batch is its due tick modulo number of slots
+	std::vector< Batch* > pending; // batches of processed slot
+	ULong currentTick;
+	Calls calls; // reused between ticks
+	boost::thread worker;
+	boost::mutex stopGuard;
+	boost::condition_variable stopCondition;
+	Bool stopped;
+
+	UInt getRate( Tag *tag ) const;
+	Batch* getBatch( SamplingDriver *driver, UInt rate );
+	void schedule( Batch *batch );
+	void collect( Batch *batch, ULong now, std::vector< std::pair< SamplingDriver*, TagHandle > > &moved );
+	void run();
+public:
+	// tick_ - resolution of scheduler in milliseconds.
+	SamplingScheduler( AddressSpace &space_, UInt tick_ = 10, UInt defaultRate_ = 1000 );
+
+	~SamplingScheduler();
+
+	// Sample tag by driver (every tag is added once for driver).
+	// First sample is taken at next tick if driver had no tags with this rate.
+	void add( Tag *tag, SamplingDriver *driver );
+
+	void remove( Tag *tag, SamplingDriver *driver );
+
+	// Remove all tags of driver. Sampling by driver which is in progress
+	// is finished before return, so must not be called from SamplingDriver::sample.
+	void remove( SamplingDriver *driver );
+
+	// Sample everything due at time now (milliseconds from any fixed moment,
+	// must not decrease). Missed samples are not repeated.
+	void process( ULong now );
+
+	// Tags nobody demands (see Tag::isDemanded) are sampled not more often
+	// than every idleRate_ milliseconds (0 - not sampled at all), so drivers
+	// whose tags are not watched are not called. Tag is sampled at next
+	// sample of its rate after it is demanded.
+	void setDemandDriven( Bool demandDriven_, UInt idleRate_ = 0 );
+
+	// Thread which calls process every tick.
+	void start();
+
+	void stop();
+
+	// Number of groups of tags with same driver and rate.
+	size_t getBatchesNumber();
+}; // class SamplingScheduler
+
+} // namespace address_space
+} // namespace opc
+} // FatRat Library
+
+#endif // frl_opc_sampling_scheduler_h_
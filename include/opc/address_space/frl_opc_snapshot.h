@@ -0,0 +1,59 @@
+#ifndef frl_opc_snapshot_h_
+#define frl_opc_snapshot_h_
+#include "frl_types.h"
+#include "opc/address_space/frl_opc_value.h"
+
+namespace frl{ namespace opc{ namespace address_space{
+
+// Binary image of address space (AddressSpace::saveSnapshot).
+// Header, array of fixed size records of tags, then pool of strings.
+// Records refer to parents and strings by indexes and offsets only,
+// so image is used directly from memory mapped file.
+// Byte order and size of Char are those of writer.
+namespace snapshot
+{
+	const UInt signature = 0x534C5246; // "FRLS"
+	const UInt version = 2;
+	const UInt noParent = 0xFFFFFFFF; // children of root
+	const UShort branchFlag = 1;
+	const UShort analogFlag = 2; // leaf has EU range
+
+	struct Header
+	{
+		UInt signature;
+		UInt version;
+		UInt charSize;
+		UInt delimiter;
+		UInt tagsNumber;
+		UInt recordSize;
+		ULong stringsSize; // in Chars
+	};
+
+	// Tags in depth-first order, children of branch ordered by ID,
+	// so parent always precedes its children.
+	struct Record
+	{
+		ULong data; // raw scalar value
+		ULong timeStamp;
+		Double lowEU; // of analog leaf
+		Double highEU;
+		UInt parent; // index of parent record or noParent
+		UInt idOffset; // in Chars from begin of pool
+		UInt idLength;
+		UInt strOffset; // string value
+		UInt strLength;
+		UInt accessRights;
+		UInt scanRate;
+		UShort flags;
+		UShort quality;
+		DataType requestedDataType;
+		DataType valueType;
+		UInt reserved;
+	};
+} // namespace snapshot
+
+} // namespace address_space
+} // namespace opc
+} // FatRat Library
+
+#endif // frl_opc_snapshot_h_
@@ -1,22 +1,102 @@
 #ifndef frl_opc_tag_h_
 #define frl_opc_tag_h_
-#include "frl_platform.h"
-#if( FRL_PLATFORM == FRL_PLATFORM_WIN32 )
-#include <map>
-#include "../dependency/vendors/opc_foundation/opcda.h"
+#include <vector>
 #include "frl_types.h"
 #include "frl_exception.h"
-#include "os/win32/com/frl_os_win32_com_variant.h"
+#include "opc/address_space/frl_opc_value.h"
+#include "opc/address_space/frl_opc_time_stamp.h"
+#include "opc/address_space/frl_opc_value_cell.h"
+#include "opc/address_space/frl_opc_name_pattern.h"
+#include "opc/address_space/frl_opc_tag_listener.h"
+#include "opc/address_space/frl_opc_namespace_version.h"
+#include "opc/address_space/frl_opc_tag_handle.h"
+#include "opc/address_space/frl_opc_path_view.h"
+#include "opc/address_space/frl_opc_tag_attributes_index.h"
 #include <boost/noncopyable.hpp>
+#include <boost/atomic.hpp>
 #include <boost/function.hpp>
 
 namespace frl{ namespace opc{ namespace address_space{
 
+// Values are equal to OPC_READABLE and OPC_WRITEABLE.
+namespace access_rights
+{
+	const UInt READABLE = 1;
+	const UInt WRITEABLE = 2;
+} // namespace access_rights
+
+// Values are equal to OPC_QUALITY_* masks.
+namespace quality
+{
+	const UShort BAD = 0x00;
+	const UShort UNCERTAIN = 0x40;
+	const UShort GOOD = 0xC0;
+} // namespace quality
+
+// Values are equal to OPC_PROPERTY_* identifiers.
+namespace property
+{
+	const UInt DATATYPE = 1;
+	const UInt VALUE = 2;
+	const UInt QUALITY = 3;
+	const UInt TIMESTAMP = 4;
+	const UInt ACCESS_RIGHTS = 5;
+	const UInt SCAN_RATE = 6;
+	const UInt EU_TYPE = 7;
+	const UInt HIGH_EU = 102;
+	const UInt LOW_EU = 103;
+} // namespace property
+
+// Values are equal to OPCEUTYPE values.
+namespace eu_type
+{
+	const UInt NO_ENUM = 0;
+	const UInt ANALOG = 1;
+} // namespace eu_type
+
+// Values are equal to OPC_BROWSE_FILTER_* values.
+namespace browse_filter
+{
+	const UInt ALL = 1;
+	const UInt BRANCHES = 2;
+	const UInt LEAFS = 3;
+} // namespace browse_filter
+
 class Tag;
+class AddressSpace;
+
+// Order of children by full ID.
+struct TagIDLess
+{
+	Bool operator()( const Tag *lhv, const Tag *rhv ) const;
+	Bool operator()( const Tag *lhv, const String &rhv ) const;
+	Bool operator()( const String &lhv, const Tag *rhv ) const;
+	Bool operator()( const Tag *lhv, const PathView &rhv ) const;
+	Bool operator()( const PathView &lhv, const Tag *rhv ) const;
+};
+
+// Approximate memory used by tags, see AddressSpace::getMemoryUsage.
+struct MemoryUsage
+{
+	size_t leafsNumber;
+	size_t branchesNumber;
+	size_t tagsSize; // tag objects
+	size_t idsSize; // heap part of tag IDs
+	size_t childrenSize; // children arrays of branches
+	size_t subscriptionsSize;
+	size_t indexesSize; // hash indexes by ID
+
+	MemoryUsage();
+	size_t getTotalSize() const;
+	double getBytesPerTag() const;
+};
+
+// IDs refer to ID of tag (nothing is copied by browsing), so they are
+// valid while namespace version taken before browse is held.
 struct TagBrowseInfo
 {
-	String shortID;
-	String fullID;
+	PathView shortID;
+	PathView fullID;
 	Bool isLeaf;
 	Tag* tagPtr;
 };
@@ -24,62 +104,127 @@ struct TagBrowseInfo
 class Tag : private boost::noncopyable
 {
 private:
-	String id;
-	String shortID;
+	friend class AddressSpace;
+	friend class NamespaceVersion;
+	friend class TagListener;
+
+	// Array of children ordered by ID. Published array is never changed:
+	// AddressSpace publishes new one (see NamespaceVersion),
+	// so readers browse it without locks.
+	typedef std::vector< Tag* > Children;
+
+	// Function subscribed to OPC writes, one of two is set.
+	// Nodes are linked in order of subscription and freed with tag only,
+	// so they are walked without locks.
+	struct OpcWriteSubscriber
+	{
+		boost::function< void() > change;
+		boost::function< void( const address_space::Tag* const ) > changeCb;
+		boost::atomic< OpcWriteSubscriber* > next;
+	};
+
+	// Range of engineering units of analog tag.
+	struct EURange
+	{
+		Double low;
+		Double high;
+	};
+
+	// Hot part: everything needed by read and write goes first
+	// (one cache line for tags placed in TagArena).
+	ValueCell value;
+	UInt accessRights;
 	Bool is_Branch;
-	VARTYPE requestedDataType;
-	DWORD accessRights;
-	String delimiter;
+	Bool in_arena; // placed in TagArena, must be destroyed without delete
+	DataType requestedDataType;
 	Tag *parent;
-	std::map< String, Tag* > tagsNameCache;
-	os::win32::com::Variant value;
-	WORD quality;
-	FILETIME timeStamp;
-	DWORD scanRate;
-
-	Bool is_opc_change_subscr;
-	boost::function< void() > opc_change;
-
-	Bool is_opc_change_subscr_cb;
-	boost::function< void( const address_space::Tag* const ) > opc_change_cb;
+	UInt scanRate;
+	Char delimiter; // same for whole address space, so only one symbol stored
+	DataType indexedType; // canonical type known by attributesIndex
+	boost::atomic< TagListener* > listeners; // head of intrusive list, NULL - nobody listens
+
+	// Cold part.
+	UInt handle; // slot in TagHandleTable of address space, noTagSlot - none
+	UInt version; // number of namespace version which created tag
+	String id;
+	boost::atomic< Children* > children; // NULL for leafs
+	boost::atomic< OpcWriteSubscriber* > opcWriteSubscribers; // NULL if nobody subscribed
+	EURange *euRange; // NULL - tag is not analog
+	boost::atomic< UInt > demand; // number of active items of active groups
+	boost::atomic< TagAttributesIndex* > attributesIndex; // NULL - tag is not indexed
 
 	Tag* addTag( const String &name, Bool is_Branch_ );
 	Tag* getTag( const String &name );
 
-	typedef std::map< String, Tag* >::value_type& map_element;
+	String browseChildren( std::vector< TagBrowseInfo > &arr, Bool leafs, const String &fromID,
+								size_t maxCount, const NamePattern &nameFilter ) const;
+
+	const Children* getChildren() const;
+
+	// Insert child into array ordered by ID.
+	// Children added in sorted order are inserted in constant time.
+	static void insertChild( Children &where, Tag *child );
+
+	// Visible for reader of version maxVersion.
+	Bool isVisible( UInt maxVersion ) const;
+
+	// Call listeners after change of value, quality or time stamp.
+	// Listeners are called under lock of their stripe (see TagListener::onTagChange).
+	void notifyListeners();
+
+	// Call subscribers of writes of OPC clients (devices).
+	void notifyOPCWrite();
+
+	// Append node to list of subscribers of OPC writes.
+	void addOpcWriteSubscriber( OpcWriteSubscriber *subscriber );
+
+	// Notify listeners about removal of tag and unsubscribe them.
+	void releaseListeners();
+
+	// Unlink listener if it listens to tag, tag is not touched otherwise
+	// (it may be removed and freed already). Return False if listener
+	// listened to no tag or to other tag.
+	static Bool unlinkListener( Tag *tag, TagListener *listener );
+
+	// Pass access rights and canonical type to attributesIndex.
+	void updateAttributes();
 public:	
 
 	FRL_EXCEPTION_CLASS( IsExistTag );
 	FRL_EXCEPTION_CLASS( NotExistTag );
 	FRL_EXCEPTION_CLASS( IsNotBranch );
 	FRL_EXCEPTION_CLASS ( IsNotLeaf );
-	FRL_EXCEPTION_CLASS ( AlreadySubscribe );
 
+	// Only first symbol of delimiter_ is used.
 	Tag( Bool is_Branch_, const String &delimiter_ );
 
 	~Tag();
 
+	// ID must not be changed after tag was added to parent branch.
 	void setID( const String& newID );
 
 	const String& getID() const;
 
-	const String& getShortID() const;
+	String getShortID() const;
+
+	// Short ID as part of full ID, without copying.
+	PathView getShortName() const;
 
 	Bool isBranch() const;
 
 	Bool isLeaf() const;
 
-	void setRequestedDataType( VARTYPE newType );
+	void setRequestedDataType( DataType newType );
 
-	VARTYPE getReguestedDataType();
+	DataType getReguestedDataType();
 
-	void setCanonicalDataType( VARTYPE newType );
+	void setCanonicalDataType( DataType newType );
 
-	VARTYPE getCanonicalDataType() const;
+	DataType getCanonicalDataType() const;
 
-	void setAccessRights( DWORD newAccessRights );
+	void setAccessRights( UInt newAccessRights );
 
-	DWORD getAccessRights();
+	UInt getAccessRights();
 
 	void isWritable( Bool writeable );
 
@@ -87,6 +232,8 @@ public:
 	
 	Bool isReadable() const;
 
+	// Array of children is replaced and freed at once, so tags must not be
+	// added this way to branch browsed concurrently (use AddressSpace).
 	Tag* addLeaf( const String &name );
 
 	Bool isExistTag( const String &name );
@@ -97,39 +244,91 @@ public:
 
 	Tag* getLeaf( const String &name );
 
+	// Return NULL if child tag not exist (name is full ID of child).
+	Tag* findChild( const PathView &name ) const;
+
+	// Child by its short ID, return NULL if not exist.
+	Tag* findChildByName( const PathView &shortID ) const;
+
+	// Walk down by segments of path relative to this branch
+	// (nothing is copied), return NULL if some segment not exist.
+	Tag* findDescendant( const PathView &relativePath ) const;
+
 	Tag* getParent();
 
 	void setParent( Tag* parent_ );
 
 	void browseBranches( std::vector< String > &branches );
 
-	void browseLeafs( std::vector< String > &leaf, DWORD accessFilter = 0 );
+	// Short IDs of leafs with all rights of accessFilter (0 - any)
+	// and canonical type dataType (data_type::EMPTY - any).
+	void browseLeafs( std::vector< String > &leaf, UInt accessFilter = 0, DataType dataType = data_type::EMPTY );
+
+	// Full IDs of all leafs in this branch and its sub-branches.
+	// Tags created after version maxVersion are skipped.
+	void browseAllLeafs( std::vector< String > &leafs, UInt accessFilter = 0, UInt maxVersion = lastVersion ) const;
+
+	// Full IDs of leafs matched by pattern in depth-first order, starting after
+	// leaf afterID (empty string - from beginning) in O(depth * log n)
+	// and stopping when leafs has maxCount elements (0 - no limit).
+	// Literal prefix of pattern selects children by range of sorted IDs,
+	// so subtrees which can not contain matching IDs are not visited.
+	void browseAllLeafs(	std::vector< String > &leafs,
+							const NamePattern &pattern,
+							UInt accessFilter = 0,
+							const String &afterID = String(),
+							size_t maxCount = 0,
+							UInt maxVersion = lastVersion ) const;
+
+	Value read() const;
+
+	// Consistent snapshot of value, quality and time stamp
+	// (safe to call while other thread writes to tag).
+	void read( Value &toValue, UShort &toQuality, TimeStamp &toTimeStamp ) const;
 
-	const os::win32::com::Variant& read() const;
+	void writeFromOPC( const Value &newVal );
 
-	void writeFromOPC( const os::win32::com::Variant &newVal );
+	// Value, quality and time stamp written by OPC client are changed
+	// together, so readers and listeners see them at once.
+	void writeFromOPC( const Value &newVal, UShort quality_, const TimeStamp &ts );
 
-	void write( const os::win32::com::Variant &newVal );
+	void write( const Value &newVal );
 
-	void setQuality( WORD quality_ );
+	// Change value, quality and time stamp together, listeners are called once.
+	void write( const Value &newVal, UShort quality_, const TimeStamp &ts );
 
-	WORD getQuality() const;
+	void setQuality( UShort quality_ );
 
-	const FILETIME& getTimeStamp() const;
+	UShort getQuality() const;
 
-	void setTimeStamp( const FILETIME& ts );
+	TimeStamp getTimeStamp() const;
 
-	void setScanRate( DWORD scanRate_ );
+	void setTimeStamp( const TimeStamp& ts );
 
-	DWORD getScanRate();
+	void setScanRate( UInt scanRate_ );
 
-	Bool isValidProperties( DWORD propertyID );
+	UInt getScanRate();
 
-	Bool checkAccessRight( DWORD checkingAccessRight );
+	// Tag becomes analog: its value is expected in range from lowEU to highEU,
+	// percent deadband of OPC items refers to this range.
+	// Range must be set before tag is read by clients.
+	void setEURange( Double lowEU, Double highEU );
 
-	std::vector< DWORD > getAvailableProperties() const;
+	Bool isAnalog() const;
 
-	HRESULT getPropertyValue( DWORD propID, VARIANT &toValue );
+	// Range of analog tag, 0 for other tags.
+	Double getLowEU() const;
+
+	Double getHighEU() const;
+
+	Bool isValidProperties( UInt propertyID );
+
+	Bool checkAccessRight( UInt checkingAccessRight ) const;
+
+	std::vector< UInt > getAvailableProperties() const;
+
+	// Return False if propID is not valid property identifier.
+	Bool getPropertyValue( UInt propID, Value &toValue ) const;
 
 	void browseLeafs( std::vector< TagBrowseInfo > &leafsArr );
 
@@ -137,14 +336,50 @@ public:
 
 	void browse( std::vector< TagBrowseInfo > &arr );
 
+	// One page of children: leafs first, then branches (as browse does),
+	// each group ordered by ID. Browsing starts from child fromID
+	// (empty string - from beginning) in O(log n) and stops after
+	// maxCount elements (0 - no limit). nameFilter is applied to short IDs,
+	// children out of range of its literal prefix are not visited.
+	// nextID is continuation point for next page (empty if nothing left).
+	// Return False if fromID is not child of this branch of browsed kind.
+	Bool browsePage(	std::vector< TagBrowseInfo > &arr,
+							UInt filter,
+							const String &fromID,
+							size_t maxCount,
+							const NamePattern &nameFilter,
+							String &nextID ) const;
+
+	// Functions are called after every change of value by OPC client;
+	// any number of functions may be subscribed. Subscription allocates
+	// one node for function, notification does not allocate.
 	void subscribeToOpcChange( const boost::function< void() > &function_ );
 
 	void subscribeToOpcChange( const boost::function< void( const address_space::Tag* const ) > &function_ );
+
+	// Listener is notified about every change of value, quality or time stamp
+	// (listener subscribed to other tag is moved to this one).
+	void addListener( TagListener *listener );
+
+	void removeListener( TagListener *listener );
+
+	Bool hasListeners() const;
+
+	// Active item of active group refers to tag: drivers may skip tags
+	// nobody demands (see SamplingScheduler::setDemandDriven).
+	// Every addDemand must be paired with releaseDemand.
+	void addDemand();
+
+	void releaseDemand();
+
+	Bool isDemanded() const;
+
+	// Add memory used by tag and its children to usage.
+	void getMemoryUsage( MemoryUsage &usage ) const;
 };
 
 } // namespace address_space
 } // namespace opc
 } // FatRat Library
 
-#endif // FRL_PLATFORM_WIN32
 #endif // frl_opc_tag_h_
@@ -0,0 +1,58 @@
+#ifndef frl_opc_tag_arena_h_
+#define frl_opc_tag_arena_h_
+#include <vector>
+#include <boost/noncopyable.hpp>
+#include <boost/thread/mutex.hpp>
+#include "frl_types.h"
+
+namespace frl{ namespace opc{ namespace address_space{
+
+class Tag;
+
+// Storage for tags created by address space: tags are placed in large
+// contiguous blocks instead of separate heap allocations,
+// every tag is aligned to cache line.
+// Arena does not call destructors - owner of tag (parent branch)
+// destroys it in place; memory released together with arena.
+// Memory of removed tags is linked into free list and reused.
+class TagArena : private boost::noncopyable
+{
+private:
+	std::vector< char* > blocks;
+	size_t used;
+	size_t capacity;
+	size_t allocatedSize;
+	char *current; // first tag of last block
+	boost::mutex freeGuard; // tags are freed by thread which released last namespace version
+	void *freeTags; // every free tag keeps pointer to next one
+
+	void addBlock( size_t tagsNumber );
+public:
+	TagArena();
+
+	~TagArena();
+
+	// Guarantee that next tagsNumber allocations take place in one block
+	// (freed tags are reused first).
+	void reserve( size_t tagsNumber );
+
+	// Raw memory for one Tag object.
+	void* allocate();
+
+	// Return memory of destroyed tag to arena.
+	void deallocate( void *tag );
+
+	// Take all blocks of other arena with tags placed in them (and its
+	// free tags), other arena becomes empty. Tags are released to this arena
+	// from now. Nothing is allocated by other arena meanwhile.
+	void adopt( TagArena &other );
+
+	// Number of bytes allocated from system.
+	size_t getAllocatedSize() const;
+}; // class TagArena
+
+} // namespace address_space
+} // namespace opc
+} // FatRat Library
+
+#endif // frl_opc_tag_arena_h_
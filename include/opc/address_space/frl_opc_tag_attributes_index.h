@@ -0,0 +1,64 @@
+#ifndef frl_opc_tag_attributes_index_h_
+#define frl_opc_tag_attributes_index_h_
+#include <vector>
+#include <map>
+#include <boost/noncopyable.hpp>
+#include <boost/thread/mutex.hpp>
+#include "frl_types.h"
+#include "opc/address_space/frl_opc_value.h"
+
+namespace frl{ namespace opc{ namespace address_space{
+
+// Secondary indexes of leafs by access rights and canonical data type.
+// Leafs are numbered by slots of TagHandleTable, every attribute value
+// has bitmap of slots, so query like "all writable R8 leafs" tests
+// 64 leafs by one word and never touches leafs which do not match.
+class TagAttributesIndex : private boost::noncopyable
+{
+private:
+	typedef std::vector< ULong > Bitmap;
+	typedef std::map< DataType, Bitmap > TypeBitmaps;
+	struct Attributes
+	{
+		UInt accessRights;
+		DataType dataType;
+		Bool indexed;
+
+		Attributes();
+	};
+
+	mutable boost::mutex guard;
+	Bitmap leafs;
+	Bitmap readable;
+	Bitmap writable;
+	TypeBitmaps types;
+	std::vector< Attributes > slots;
+	size_t count;
+
+	static void setBit( Bitmap &bitmap, UInt slot, Bool value );
+public:
+	TagAttributesIndex();
+
+	// Leaf in slot has such attributes from now.
+	void update( UInt slot, UInt accessRights, DataType dataType );
+
+	void remove( UInt slot );
+
+	void clear();
+
+	// Slots of leafs with all access rights of accessFilter (0 - any)
+	// and with data type dataType (data_type::EMPTY - any) in ascending order.
+	void find( UInt accessFilter, DataType dataType, std::vector< UInt > &found ) const;
+
+	// Number of indexed leafs.
+	size_t size() const;
+
+	// Size of bitmaps in bytes.
+	size_t getMemorySize() const;
+}; // class TagAttributesIndex
+
+} // namespace address_space
+} // namespace opc
+} // FatRat Library
+
+#endif // frl_opc_tag_attributes_index_h_
@@ -0,0 +1,95 @@
+#ifndef frl_opc_tag_handle_h_
+#define frl_opc_tag_handle_h_
+#include <boost/atomic.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/scoped_array.hpp>
+#include "frl_types.h"
+
+namespace frl{ namespace opc{ namespace address_space{
+
+class Tag;
+
+// Reference to tag which survives removal of tag: slot of removed tag
+// gets new generation, so stale handle is resolved to NULL
+// (see AddressSpace::findTag). Default handle refers to nothing.
+struct TagHandle
+{
+	UInt index;
+	UInt generation;
+
+	TagHandle();
+
+	TagHandle( UInt index_, UInt generation_ );
+
+	Bool isNull() const;
+
+	Bool operator == ( const TagHandle &rhv ) const;
+
+	Bool operator != ( const TagHandle &rhv ) const;
+};
+
+// Index of slot for tags which have no slot.
+const UInt noTagSlot = 0xFFFFFFFF;
+
+// Slots of tags addressed by handles. One writer and any number of
+// readers may work concurrently: slots are allocated in chunks which never
+// move, directory of chunks is grown aside and published as whole
+// (replaced directories are small and kept until table is destroyed).
+// Free slots are linked into list, so removal never allocates.
+class TagHandleTable : private boost::noncopyable
+{
+private:
+	struct Slot
+	{
+		boost::atomic< Tag* > tag;
+		boost::atomic< UInt > generation;
+		UInt nextFree;
+
+		Slot();
+	};
+	struct Directory
+	{
+		size_t size;
+		boost::scoped_array< Slot* > chunks;
+		Directory *previous; // replaced directory
+
+		Directory( size_t size_, Directory *previous_ );
+	};
+	boost::atomic< Directory* > directory;
+	UInt used; // slots taken from chunks
+	UInt firstFree;
+	size_t count;
+
+	Slot* getSlot( UInt index ) const;
+public:
+	TagHandleTable();
+
+	~TagHandleTable();
+
+	// Slot for new tag, return index of slot.
+	UInt add( Tag *tag );
+
+	// Handles of slot are stale from now, slot is reused by next tags.
+	void remove( UInt index );
+
+	// Current handle of slot.
+	TagHandle getHandle( UInt index ) const;
+
+	// Return NULL if handle is stale.
+	Tag* find( const TagHandle &handle ) const;
+
+	// Number of tags in table.
+	size_t size() const;
+
+	// Size of slots in bytes.
+	size_t getMemorySize() const;
+
+	// Forget all slots. Must not be called while table is read.
+	void clear();
+}; // class TagHandleTable
+
+} // namespace address_space
+} // namespace opc
+} // FatRat Library
+
+#endif // frl_opc_tag_handle_h_
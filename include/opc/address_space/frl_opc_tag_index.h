@@ -0,0 +1,93 @@
+#ifndef frl_opc_tag_index_h_
+#define frl_opc_tag_index_h_
+#include <vector>
+#include <boost/atomic.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/scoped_array.hpp>
+#include "frl_types.h"
+#include "opc/address_space/frl_opc_path_view.h"
+
+namespace frl{ namespace opc{ namespace address_space{
+
+class Tag;
+
+// Open addressing (linear probing) hash index of tags by full ID.
+// Keys are not copied: every entry refers to ID string owned by the tag,
+// hash of ID is computed once at insertion and stored in entry.
+// One writer and any number of readers may work concurrently: entry is
+// published by storing tag pointer after hash, removed entry is marked
+// as deleted, grown table is built aside and published as whole.
+// Replaced tables are kept until owner takes them (takeReplaced),
+// so readers need no locks.
+class TagIndex : private boost::noncopyable
+{
+private:
+	struct Entry
+	{
+		size_t hash;
+		boost::atomic< Tag* > tag; // NULL - never used, deletedTag - removed
+
+		Entry();
+	};
+public:
+	struct Table
+	{
+		size_t mask;
+		boost::scoped_array< Entry > entries;
+		boost::atomic< Table* > previous; // replaced table
+
+		Table( size_t capacity, Table *previous_ );
+	};
+private:
+	boost::atomic< Table* > table;
+	boost::atomic< size_t > count;
+	size_t used; // entries of current table, deleted ones too
+
+	void rehash( size_t newCapacity );
+	static size_t findPos( const Table *where, const PathView &id, size_t hash );
+	static Tag* deletedTag();
+	Bool insert( Tag *tag, size_t hash );
+public:
+	TagIndex();
+
+	~TagIndex();
+
+	static size_t hashOf( const String &id );
+
+	static size_t hashOf( const Char *id, size_t length );
+
+	// Return False if tag with same ID already in index.
+	Bool insert( Tag *tag );
+
+	// Insert tags of other index (hashes are not computed again),
+	// tags with IDs which are already in index are skipped.
+	void insertAll( const TagIndex &other );
+
+	// Return False if tag with ID not in index.
+	Bool erase( const PathView &id );
+
+	// Return NULL if tag with ID not exist.
+	Tag* find( const PathView &id ) const;
+
+	Bool isExist( const PathView &id ) const;
+
+	size_t size() const;
+
+	void reserve( size_t tagsNumber );
+
+	// Size of hash tables in bytes.
+	size_t getMemorySize() const;
+
+	// Move tables replaced since last call to tables: owner frees them
+	// when nobody reads index (tables which are not taken are freed with index).
+	void takeReplaced( std::vector< Table* > &tables );
+
+	// Must not be called while index is read.
+	void clear();
+}; // class TagIndex
+
+} // namespace address_space
+} // namespace opc
+} // FatRat Library
+
+#endif // frl_opc_tag_index_h_
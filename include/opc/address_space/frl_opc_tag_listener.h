@@ -0,0 +1,45 @@
+#ifndef frl_opc_tag_listener_h_
+#define frl_opc_tag_listener_h_
+#include <boost/noncopyable.hpp>
+#include <boost/atomic.hpp>
+#include "frl_types.h"
+
+namespace frl{ namespace opc{ namespace address_space{
+
+class Tag;
+
+// Receiver of changes of value, quality or time stamp of tag.
+// Listeners are linked into intrusive list of tag, so any number of
+// listeners per tag, and neither subscription nor notification allocates.
+class TagListener : private boost::noncopyable
+{
+private:
+	friend class Tag;
+	boost::atomic< Tag* > tag; // changed under lock of listeners of tag only
+	TagListener *prevListener;
+	TagListener *nextListener;
+public:
+	TagListener();
+
+	// Unsubscribe from tag. Derived class should unsubscribe in its own
+	// destructor, so onTagChange is never called for half destroyed object.
+	virtual ~TagListener();
+
+	// Called in thread which changed tag while list of listeners of tag is locked.
+	// The lock is shared with other tags, so listener must be short and must not
+	// write tags, subscribe or unsubscribe listeners: it would deadlock.
+	// Also called once when tag is removed from address space,
+	// listener is unsubscribed after that.
+	virtual void onTagChange( const Tag *changed ) = 0;
+
+	// NULL if not subscribed.
+	Tag* getListenedTag() const;
+
+	void unsubscribe();
+}; // class TagListener
+
+} // namespace address_space
+} // namespace opc
+} // FatRat Library
+
+#endif // frl_opc_tag_listener_h_
@@ -0,0 +1,39 @@
+#ifndef frl_opc_time_stamp_h_
+#define frl_opc_time_stamp_h_
+#include "frl_types.h"
+
+namespace frl{ namespace opc{ namespace address_space{
+
+// Platform independent time stamp of tag value.
+// Counts 100-nanosecond intervals since January 1, 1601 (UTC),
+// so it has the same resolution and epoch as FILETIME.
+class TimeStamp
+{
+private:
+	ULong ticks;
+public:
+	TimeStamp();
+	explicit TimeStamp( ULong ticks_ );
+
+	// Current system time (UTC).
+	static TimeStamp now();
+
+	ULong getTicks() const;
+	void setTicks( ULong ticks_ );
+
+	// Convert to OLE automation date (days since December 30, 1899).
+	Double toDate() const;
+	static TimeStamp fromDate( Double date );
+
+	Bool isNull() const;
+
+	Bool operator == ( const TimeStamp &rhv ) const;
+	Bool operator != ( const TimeStamp &rhv ) const;
+	Bool operator < ( const TimeStamp &rhv ) const;
+}; // class TimeStamp
+
+} // namespace address_space
+} // namespace opc
+} // FatRat Library
+
+#endif // frl_opc_time_stamp_h_
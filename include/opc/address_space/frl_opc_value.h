@@ -0,0 +1,128 @@
+#ifndef frl_opc_value_h_
+#define frl_opc_value_h_
+#include "frl_types.h"
+#include "frl_exception.h"
+#include "opc/address_space/frl_opc_time_stamp.h"
+
+namespace frl{ namespace opc{ namespace address_space{
+
+// Data type of tag value.
+// Numeric values are equal to VARTYPE codes, so on Windows
+// VT_* constants can be used wherever DataType expected.
+typedef UShort DataType;
+
+namespace data_type
+{
+	const DataType EMPTY = 0;
+	const DataType I2 = 2;
+	const DataType I4 = 3;
+	const DataType R4 = 4;
+	const DataType R8 = 5;
+	const DataType CY = 6;
+	const DataType DATE = 7;
+	const DataType STRING = 8;
+	const DataType BOOL = 11;
+	const DataType I1 = 16;
+	const DataType UI1 = 17;
+	const DataType UI2 = 18;
+	const DataType UI4 = 19;
+	const DataType I8 = 20;
+	const DataType UI8 = 21;
+	const DataType ARRAY = 0x2000;
+} // namespace data_type
+
+class ValueCell;
+
+// Platform independent value of tag.
+// Scalar values stored in place, string value - in String member.
+class Value
+{
+private:
+	friend class ValueCell;
+
+	DataType type;
+	union Data
+	{
+		bool boolVal;
+		char i1Val;
+		unsigned char ui1Val;
+		short i2Val;
+		unsigned short ui2Val;
+		Int i4Val;
+		UInt ui4Val;
+		Long i8Val;
+		ULong ui8Val;
+		float r4Val;
+		double r8Val;
+	};
+	Data data;
+	String strVal;
+
+	Bool toDouble( double &dst ) const;
+	Bool toLong( Long &dst ) const;
+	Bool fromDouble( DataType newType, double src );
+	Bool fromLong( DataType newType, Long src );
+public:
+	FRL_EXCEPTION_CLASS( InvalidType );
+
+	// Constructors
+	Value();
+	Value( bool cValue );
+	Value( char cValue );
+	Value( unsigned char cValue );
+	Value( short cValue );
+	Value( unsigned short cValue );
+	Value( int cValue );
+	Value( unsigned int cValue );
+	Value( long cValue );
+	Value( unsigned long cValue );
+	Value( Long cValue );
+	Value( ULong cValue );
+	Value( float cValue );
+	Value( double cValue );
+	Value( const TimeStamp &cValue );
+	Value( const String &cValue );
+	Value( const Char *cValue );
+
+	// methods
+	void clear();
+	DataType getType() const;
+	// Convert current value to new type.
+	// Return False if conversion impossible (value is not changed).
+	Bool setType( DataType newType );
+	static Bool isValidType( DataType checkType );
+
+	Bool operator == ( const Value &rhv ) const;
+	Bool operator != ( const Value &rhv ) const;
+
+	// cast methods, throw InvalidType if type of value mismatched
+	operator bool() const;
+	operator char() const;
+	operator unsigned char() const;
+	operator short() const;
+	operator unsigned short() const;
+	operator int() const;
+	operator unsigned int() const;
+	operator long() const;
+	operator unsigned long() const;
+	operator Long() const;
+	operator ULong() const;
+	operator float() const;
+	operator double() const;
+	operator TimeStamp() const;
+	operator String() const;
+
+	// CY values stored as 64-bit integer scaled by 10000.
+	Long getCurrency() const;
+	void setCurrency( Long cyValue );
+
+	// Bits of scalar value as is (binary images of address space).
+	ULong getRawData() const;
+	void setRawData( DataType newType, ULong raw );
+}; // class Value
+
+} // namespace address_space
+} // namespace opc
+} // FatRat Library
+
+#endif // frl_opc_value_h_
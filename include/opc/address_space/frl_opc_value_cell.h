@@ -0,0 +1,69 @@
+#ifndef frl_opc_value_cell_h_
+#define frl_opc_value_cell_h_
+#include <boost/shared_ptr.hpp>
+#include <boost/atomic.hpp>
+#include "frl_types.h"
+#include "opc/address_space/frl_opc_value.h"
+#include "opc/address_space/frl_opc_time_stamp.h"
+
+namespace frl{ namespace opc{ namespace address_space{
+
+// Value, quality and time stamp of tag, safe for concurrent access.
+// Scalar part protected by sequence lock: readers never block and retry
+// if writer was active; writers are serialized by the same sequence counter.
+// Fields of scalar part are relaxed atomics: reader may load them while
+// writer stores, torn result is dropped by check of sequence counter.
+// String value published as immutable shared string, so reader copies
+// only pointer inside of read section.
+// Not copyable because of atomic sequence counter; boost::noncopyable
+// is not used as base, so cell can be first member of Tag without padding.
+class ValueCell
+{
+private:
+	boost::atomic< UInt > sequence;
+	boost::atomic< DataType > type;
+	boost::atomic< UShort > quality;
+	boost::atomic< ULong > data; // bits of Value::Data
+	boost::atomic< ULong > timeStamp;
+	boost::shared_ptr< const String > strVal;
+
+	UInt beginWrite();
+	void endWrite( UInt seq );
+	void store( const Value &newVal, const boost::shared_ptr< const String > &newStr );
+	void load( Value &toValue, const boost::shared_ptr< const String > &str ) const;
+	Bool isEqual( const Value &val ) const;
+public:
+	ValueCell( DataType type_, UShort quality_ );
+
+	// Consistent snapshot of value, quality and time stamp.
+	void read( Value &toValue, UShort &toQuality, TimeStamp &toTimeStamp ) const;
+
+	Value getValue() const;
+
+	DataType getType() const;
+
+	UShort getQuality() const;
+
+	TimeStamp getTimeStamp() const;
+
+	// Set new value and time stamp.
+	// Return False (nothing changed) if new value equal to current.
+	Bool write( const Value &newVal, const TimeStamp &ts );
+
+	// Set new value, quality and time stamp in one write section.
+	// Return False (nothing changed) if new value and quality equal to current.
+	Bool write( const Value &newVal, UShort newQuality, const TimeStamp &ts );
+
+	// Convert current value to new type, return False if conversion impossible.
+	Bool setType( DataType newType );
+
+	void setQuality( UShort newQuality );
+
+	void setTimeStamp( const TimeStamp &ts );
+}; // class ValueCell
+
+} // namespace address_space
+} // namespace opc
+} // FatRat Library
+
+#endif // frl_opc_value_cell_h_
@@ -7,14 +7,22 @@
 
 namespace frl{ namespace opc{
 
+namespace address_space
+{
+	class AddressSpace;
+}
+
 class DAServer
 	:	public ServerKind
 {
 private:
 	Bool isInit;
 	DWORD objectId;
+	address_space::AddressSpace *addressSpace; // NULL - opcAddressSpace
 public:
 	DAServer( const ServerType& serverType );
+	// Server of address space other than opcAddressSpace.
+	DAServer( const ServerType& serverType, address_space::AddressSpace &addressSpace_ );
 	~DAServer();
 	void registrerServer();
 	void registrerServer3();
@@ -5,7 +5,9 @@
 #include "../dependency/vendors/opc_foundation/opcda.h"
 #include "frl_types.h"
 #include <vector>
+#include <boost/scoped_ptr.hpp>
 #include "os/win32/com/frl_os_win32_com_allocator.h"
+#include "opc/address_space/frl_opc_leaf_enumerator.h"
 
 namespace frl{ namespace opc{
 
@@ -18,6 +20,9 @@ public:
 
 	void init( const std::vector< String >& items );
 
+	// Strings are taken from leafs enumerator on demand (flat browsing).
+	void init( const address_space::LeafEnumerator &leafs_ );
+
 	// the IUnknown functions implementation
 	STDMETHODIMP QueryInterface( REFIID iid, LPVOID* ppInterface );
 	STDMETHODIMP_(ULONG) AddRef( void );
@@ -40,6 +45,7 @@ private:
 
 	size_t curIndex;						// current element
 	std::vector<String> strings;	// enum strings
+	boost::scoped_ptr< address_space::LeafEnumerator > leafs; // lazy enum strings
 }; // class EnumString
 
 } // namespace opc
@@ -0,0 +1,97 @@
+#ifndef frl_opc_executor_h_
+#define frl_opc_executor_h_
+#include <vector>
+#include <deque>
+#include <boost/noncopyable.hpp>
+#include <boost/atomic.hpp>
+#include <boost/function.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/tss.hpp>
+#include "frl_types.h"
+#include "frl_singleton.h"
+
+namespace frl{ namespace opc{
+
+// Pool of worker threads with work stealing. Every worker has own queue:
+// tasks posted by worker go to its queue, other tasks are spread among
+// queues by turns. Worker takes oldest task of own queue, idle worker
+// takes newest task of other queue, so workers are busy while any task waits.
+class Executor : private boost::noncopyable
+{
+public:
+	typedef boost::function< void() > Task;
+
+	// Tasks posted to strand are run one by one in order of posting,
+	// tasks of different strands run in parallel. Copies of strand are same strand.
+	class Strand
+	{
+	private:
+		struct State
+		{
+			Executor *executor;
+			boost::mutex guard;
+			std::deque< Task > tasks;
+			Bool scheduled; // task of strand is posted to executor
+		};
+		boost::shared_ptr< State > state;
+
+		// Posts next task of strand or ends strand run, even if task throws.
+		class Next
+		{
+		private:
+			boost::shared_ptr< State > &state;
+		public:
+			explicit Next( boost::shared_ptr< State > &state_ );
+			~Next();
+		};
+
+		static void runNext( boost::shared_ptr< State > state );
+	public:
+		explicit Strand( Executor &executor );
+
+		void post( const Task &task );
+	}; // class Strand
+
+private:
+	struct Worker
+	{
+		boost::mutex guard;
+		std::deque< Task > tasks;
+	};
+
+	std::vector< Worker* > workers;
+	boost::thread_group threads;
+	boost::thread_specific_ptr< Worker > current; // worker of calling thread
+	boost::mutex idleGuard; // only idle workers and their wakers take it
+	boost::condition_variable idleCondition;
+	boost::atomic< size_t > queued; // tasks in all queues
+	boost::atomic< size_t > waiting; // workers which wait for tasks
+	boost::atomic< size_t > next; // queue of next task posted not by worker
+	Bool shutdown;
+
+	static void forget( Worker* );
+	Bool take( Worker *worker, Task &task );
+	void work( Worker *worker );
+public:
+	// workersNumber - 0 - number of processors.
+	explicit Executor( UInt workersNumber = 0 );
+
+	// Runs all posted tasks before return.
+	~Executor();
+
+	// Exception of task is swallowed, worker goes on.
+	void post( const Task &task );
+
+	size_t getWorkersNumber() const;
+}; // class Executor
+
+// Executor of process: updates of groups and async requests of all servers.
+typedef SingletonMeyers< Executor > opcExecutor;
+
+} // namespace opc
+} // FatRat Library
+
+#endif // frl_opc_executor_h_
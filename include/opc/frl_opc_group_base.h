@@ -3,6 +3,7 @@
 #include "frl_platform.h"
 #if( FRL_PLATFORM == FRL_PLATFORM_WIN32 )
 #include <boost/noncopyable.hpp>
+#include <boost/function.hpp>
 #include "opc/frl_opc_serv_handle_counter.h"
 #include "opc/frl_opc_connection_point_container.h"
 #include "opc/frl_opc_group_item.h"
@@ -20,6 +21,7 @@ protected:
 	String name;
 	OPCHANDLE clientHandle;
 	OPCServer* server;
+	address_space::AddressSpace *addressSpace; // of server
 
 	Bool actived;
 	Bool enabled;
@@ -32,12 +34,22 @@ protected:
 	FILETIME lastUpdate;
 
 	boost::mutex groupGuard;
-	GroupItemElemList itemList;
+	address_space::ChangeQueue changeQueue; // server handles of changed items
+	std::vector< UInt > changedHandles; // buffer reused by onUpdateTimer
+	std::vector< size_t > changedSlots; // buffer reused by onUpdateTimer
+	address_space::DeadbandFilter deadbandFilter; // percent deadband of changed items
+	GroupItemTable items; // destroyed before changeQueue, items unsubscribe first
+
+	// Caller must hold groupGuard.
+	void setItemActived( size_t slot, Bool activedFlag );
+	// Tags of items are demanded while group is active, call on change of actived.
+	void updateItemsDemand();
 public:
 	GroupBase();
 	GroupBase( const String &groupName );
 	virtual ~GroupBase();
 	void Init();
+	// Items of group are tags of address space of server.
 	void setServerPtr( OPCServer *serverPtr );
 	const String getName();
 	Bool isDeleted();
@@ -48,9 +60,17 @@ public:
 	FILETIME getLastUpdate();
 	ULONGLONG getLastUpdateTick();
 	void renewUpdateRate();
-	void onUpdateTimer();
+	// Send changed items to client. Return True if group has nothing to do
+	// until its items change (change of item calls wakeUp then).
+	Bool onUpdateTimer();
+	void setWakeUp( const boost::function< void() > &wakeUp );
+	// Number of changes of items checked by updates.
+	ULong getDeadbandChecked();
+	// Number of changes which were not sent due to percent deadband.
+	ULong getSuppressedUpdates();
 	void doAsyncRead( IOPCDataCallback* callBack, const AsyncRequestListElem &request );
-	void doAsyncRefresh( const AsyncRequestListElem &request );
+	// checked - items send VQT taken by deadband check of onUpdateTimer.
+	void doAsyncRefresh( const AsyncRequestListElem &request, Bool checked = False );
 	void doAsyncWrite( IOPCDataCallback* callBack, const AsyncRequestListElem &request );
 };
 
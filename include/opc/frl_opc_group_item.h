@@ -3,13 +3,16 @@
 #include "frl_platform.h"
 #if( FRL_PLATFORM == FRL_PLATFORM_WIN32 )
 #include <Windows.h>
-#include <map>
 #include <boost/shared_ptr.hpp>
+#include <boost/noncopyable.hpp>
 #include "../dependency/vendors/opc_foundation/opcda.h"
 #include "frl_types.h"
-#include <boost/noncopyable.hpp>
 #include "os/win32/com/frl_os_win32_com_variant.h"
-#include "opc/frl_opc_serv_handle_counter.h"
+#include "opc/frl_opc_item_table.h"
+#include "opc/address_space/frl_opc_change_queue.h"
+#include "opc/address_space/frl_opc_tag_handle.h"
+#include "opc/address_space/frl_opc_namespace_version.h"
+#include "opc/address_space/frl_opc_deadband_filter.h"
 
 namespace frl
 {
@@ -18,38 +21,81 @@ namespace opc
 namespace address_space
 {
 	class Tag;
+	class AddressSpace;
 }
 
 static const Float invalidDeadBand = -1.0;
 
+// Item listens to its tag and puts server handle into change queue of group
+// on every change, so group update checks only changed items.
+// Client handle, active state and deadband of item are kept by group (GroupItemTable).
 class GroupItem
-	:	private boost::noncopyable,
-		public ServerHandleCounter
+	:	public address_space::QueuedTagListener
 {
 private:
-	OPCHANDLE clientHandle;
-	Bool actived;
+	address_space::AddressSpace *space; // of tag
+	Bool demanding; // item is counted in demand of tag
 	String accessPath;
 	String itemID;
 	VARTYPE requestDataType;
 	FILETIME lastChange;
 	os::win32::com::Variant cachedValue;
-	address_space::Tag *tagRef;
-	Float deadBand;
+	address_space::TagHandle tagHandle;
+	// last value sent to client, reference of percent deadband
+	Double sentValue;
+	UShort sentQuality;
+	Bool sent;
+	// VQT taken by getDeadbandCheck: sent by update of group, numeric value becomes sent by setSent
+	os::win32::com::Variant checkedVariant;
+	FILETIME checkedTimeStamp;
+	Bool checkedExist; // tag was not removed
+	Double checkedValue;
+	UShort checkedQuality;
+	Bool checked; // checkedValue is numeric value of analog item
+
+	// Tag of item: looked up by ID once, then found by handle.
+	// Return NULL if tag not exist or was removed (item stays unknown then).
+	// Caller must hold version of address space while using tag (see PinnedTag).
+	address_space::Tag* getTag();
 public:
-	GroupItem();
+	// Tag of item with version of address space held: tag found stays allocated
+	// while pin lives, even if it is removed from address space meanwhile.
+	// NULL if tag not exist or was removed.
+	class PinnedTag : private boost::noncopyable
+	{
+	private:
+		address_space::NamespaceVersionPtr version; // taken before tag is found
+		address_space::Tag *tag;
+	public:
+		explicit PinnedTag( GroupItem &item );
+
+		address_space::Tag* get() const
+		{
+			return tag;
+		}
+
+		address_space::Tag* operator->() const
+		{
+			return tag;
+		}
+	}; // class PinnedTag
+
+	explicit GroupItem( address_space::AddressSpace &space_ );
 	~GroupItem();
 	void Init( OPCITEMDEF &itemDef );
-	void isActived( Bool activedFlag );
-	Bool isActived() const;
-	void setClientHandle( OPCHANDLE handle );
+	// Subscribe to changes of tag, item is queued by server handle at once to send initial value.
+	void attach( address_space::ChangeQueue *queue, OPCHANDLE serverHandle );
+	// Tag is demanded while both item and its group are active.
+	void setDemand( Bool demand );
 	void setRequestDataType( VARTYPE type );
 	VARTYPE getReguestDataType() const;
-	OPCHANDLE getClientHandle() const;
 	const String& getItemID() const;
 	const String& getAccessPath() const;
+	// Throw Tag::NotExistTag if tag of item not exist.
 	const os::win32::com::Variant& readValue();
 	HRESULT writeValue( const VARIANT &newValue );
+	// Quality and time stamp are written together with value if not NULL.
+	HRESULT writeValue( const VARIANT &newValue, const WORD *quality, const FILETIME *timeStamp );
 	const FILETIME& getTimeStamp() const;
 	DWORD getAccessRights();
 	WORD getQuality();
@@ -59,14 +105,26 @@ public:
 	void resetTimeStamp();
 	void setTimeStamp( const FILETIME& ts );
 	void setQuality( WORD quality );
-	void setDeadBand( Float newDeadBand );
-	Float getDeadBand();
+	// Item of analog tag (EU range is set) supports percent deadband.
+	Bool isAnalog();
+	// Take current VQT of item and return arguments of DeadbandFilter::add for it and percent deadband.
+	// Threshold is noDeadband (change is sent) for not analog item,
+	// first value and change of quality.
+	void getDeadbandCheck( Float percent, Double &sentValue_, Double &currentValue, Double &threshold );
+	// VQT taken by last getDeadbandCheck, so update sends value which passed deadband.
+	// Return OPC_E_UNKNOWNITEMID if tag was removed.
+	HRESULT getChecked( VARIANT &value, WORD &quality, FILETIME &timeStamp );
+	// Value taken by last getDeadbandCheck is sent to client.
+	void setSent();
 	Bool isWritable();
 	Bool isReadable();
+	// False if tag of item was removed from address space.
+	Bool isTagExist();
+	address_space::AddressSpace& getAddressSpace() const;
 }; // GroupItem
 
 typedef boost::shared_ptr< GroupItem > GroupItemElem;
-typedef std::map< OPCHANDLE, GroupItemElem > GroupItemElemList;
+typedef ItemTable< GroupItemElem > GroupItemTable;
 
 } // namespace opc
 } // FatRat Library
@@ -6,9 +6,8 @@
 #include <vector>
 #include <boost/noncopyable.hpp>
 #include <boost/thread/mutex.hpp>
-#include <boost/thread/thread.hpp>
 #include "../dependency/vendors/opc_foundation/opcda.h"
-#include "opc/frl_opc_event.h"
+#include "opc/frl_opc_update_scheduler.h"
 #include "frl_types.h"
 #include "frl_smart_ptr.h"
 #include "frl_exception.h"
@@ -28,11 +27,8 @@ private:
 	boost::mutex guard;
 	GroupElemHandlesMap handles_map;
 	GroupElemNamesMap names_map;
+	UpdateScheduler &scheduler; // updates groups by their update rates
 	void insert( GroupElem& group );
-	Event stopUpdate;
-	boost::thread updateThread;
-
-	void updateGroups();
 public:
 	FRL_EXCEPTION_CLASS( IsExistGroup );
 	FRL_EXCEPTION_CLASS( NotExistGroup );
@@ -19,7 +19,8 @@ public:
 	~ItemAttributes();
 
 	ItemAttributes& operator = ( const ItemAttributes& rhv );
-	ItemAttributes& operator = ( const std::pair< OPCHANDLE, GroupItemElem >& newItem );
+	// Attributes of item in slot of group.
+	void assign( const GroupItemTable &items, size_t slot );
 	void copyTo( OPCITEMATTRIBUTES& dst );
 };
 
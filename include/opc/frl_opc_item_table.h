@@ -0,0 +1,181 @@
+#ifndef frl_opc_item_table_h_
+#define frl_opc_item_table_h_
+#include <vector>
+#include "frl_types.h"
+
+namespace frl{ namespace opc{
+
+// Items of group in arrays indexed by slot (structure of arrays): fields
+// checked by scans of group lie contiguous. Server handle of item is its slot
+// with generation of slot, so item is found by handle without search.
+// Slots of removed items are reused, handle of removed item stays invalid:
+// slot is retired before its generation would wrap.
+template< class Item >
+class ItemTable
+{
+public:
+	static const size_t npos = (size_t)-1;
+
+private:
+	static const UInt slotBits = 20;
+	static const UInt slotMask = ( 1 << slotBits ) - 1;
+	static const UInt generationMask = 0xFFFFFFFF >> slotBits;
+
+	std::vector< Item > items;
+	std::vector< UInt > clientHandles;
+	std::vector< UChar > actives; // 0 for free slots
+	std::vector< Float > deadbands;
+	std::vector< UInt > generations; // next generation for free slots
+	std::vector< UChar > used;
+	std::vector< size_t > freeSlots;
+	size_t count;
+
+public:
+	ItemTable()
+		:	count( 0 )
+	{
+	}
+
+	// Return server handle of new item, 0 if group has no more slots.
+	UInt insert( const Item &item, UInt clientHandle, Bool active, Float deadband )
+	{
+		size_t slot;
+		if( freeSlots.empty() )
+		{
+			slot = items.size();
+			if( slot + 1 > slotMask )
+				return 0;
+			items.push_back( item );
+			clientHandles.push_back( clientHandle );
+			actives.push_back( active );
+			deadbands.push_back( deadband );
+			generations.push_back( 0 );
+			used.push_back( True );
+		}
+		else
+		{
+			slot = freeSlots.back();
+			freeSlots.pop_back();
+			items[slot] = item;
+			clientHandles[slot] = clientHandle;
+			actives[slot] = active;
+			deadbands[slot] = deadband;
+			used[slot] = True;
+		}
+		++count;
+		return getHandle( slot );
+	}
+
+	// Return slot of item, npos if handle is not handle of item of table.
+	size_t find( UInt handle ) const
+	{
+		size_t slot = handle & slotMask;
+		if( slot == 0 || slot > items.size() )
+			return npos;
+		--slot;
+		if( ! used[slot] || generations[slot] != ( handle >> slotBits ) )
+			return npos;
+		return slot;
+	}
+
+	void erase( size_t slot )
+	{
+		items[slot] = Item();
+		actives[slot] = False;
+		used[slot] = False;
+		generations[slot] = ( generations[slot] + 1 ) & generationMask;
+		if( generations[slot] != 0 )
+			freeSlots.push_back( slot );
+		--count;
+	}
+
+	// Handles of removed items stay invalid.
+	void clear()
+	{
+		for( size_t slot = 0; slot < items.size(); ++slot )
+		{
+			if( used[slot] )
+				erase( slot );
+		}
+	}
+
+	size_t size() const
+	{
+		return count;
+	}
+
+	Bool empty() const
+	{
+		return count == 0;
+	}
+
+	// Slots are numbered from 0 to getSlots() - 1, free slots among them.
+	size_t getSlots() const
+	{
+		return items.size();
+	}
+
+	Bool isUsed( size_t slot ) const
+	{
+		return used[slot] != 0;
+	}
+
+	UInt getHandle( size_t slot ) const
+	{
+		return ( generations[slot] << slotBits ) | (UInt)( slot + 1 );
+	}
+
+	const Item& getItem( size_t slot ) const
+	{
+		return items[slot];
+	}
+
+	UInt getClientHandle( size_t slot ) const
+	{
+		return clientHandles[slot];
+	}
+
+	void setClientHandle( size_t slot, UInt clientHandle )
+	{
+		clientHandles[slot] = clientHandle;
+	}
+
+	Bool isActive( size_t slot ) const
+	{
+		return actives[slot] != 0;
+	}
+
+	void setActive( size_t slot, Bool active )
+	{
+		actives[slot] = active;
+	}
+
+	Float getDeadband( size_t slot ) const
+	{
+		return deadbands[slot];
+	}
+
+	void setDeadband( size_t slot, Float deadband )
+	{
+		deadbands[slot] = deadband;
+	}
+
+	// Append handles of active items in order of slots.
+	template< class Handles >
+	void getActiveHandles( Handles &handles ) const
+	{
+		for( size_t slot = 0; slot < actives.size(); ++slot )
+		{
+			if( actives[slot] )
+				handles.push_back( getHandle( slot ) );
+		}
+	}
+}; // class ItemTable
+
+template< class Item >
+const size_t ItemTable< Item >::npos;
+
+} // namespace opc
+} // FatRat Library
+
+#endif // frl_opc_item_table_h_
@@ -4,31 +4,45 @@
 #if( FRL_PLATFORM == FRL_PLATFORM_WIN32 )
 #include <map>
 #include <boost/thread/mutex.hpp>
-#include <boost/thread/thread.hpp>
+#include <boost/thread/condition_variable.hpp>
 #include <boost/noncopyable.hpp>
 #include "opc/frl_opc_async_request.h"
-#include "opc/frl_opc_event.h"
+#include "opc/frl_opc_executor.h"
 
 namespace frl{ namespace opc{
 
+// Async requests are done by opcExecutor: requests of one group in order
+// of adding, requests of different groups and servers in parallel.
 class RequestManager : private boost::noncopyable
 {
 private:
-	std::map< OPCHANDLE, AsyncRequestListElem > request_map;
+	typedef std::map< OPCHANDLE, Executor::Strand > Strands;
+
+	Executor &executor;
+	std::map< OPCHANDLE, AsyncRequestListElem > request_map; // requests which are not done yet
+	Strands strands; // by server handles of groups
 	boost::mutex scopeGuard;
-	Event addReqEvent;
-	boost::thread processThread;
-	volatile bool stopIt;
+	boost::condition_variable idleCondition;
+	size_t posted; // requests passed to executor
+
+	// Counts processed request out, even if it throws.
+	class Processed
+	{
+	private:
+		RequestManager &manager;
+	public:
+		explicit Processed( RequestManager &manager_ );
+		~Processed();
+	};
 
-	bool getNextRequest( AsyncRequestListElem &request );
-	void process();
+	void process( OPCHANDLE cancelID );
 	void doAsync( AsyncRequestListElem &request );
 public:
 	RequestManager();
 	~RequestManager();
 	void addRequest( AsyncRequestListElem &request );
 	bool cancelRequest( OPCHANDLE handle );
-	void removeItemFromRequest( OPCHANDLE item_id );
+	void removeItemFromRequest( OPCHANDLE group_id, OPCHANDLE item_id );
 	void removeGroupFromRequest( OPCHANDLE group_id );
 }; // class RequestManager
 
@@ -30,8 +30,12 @@ private:
 	#else
 		LONG refCount;
 	#endif
+	void init();
 public:
+	// Server of opcAddressSpace.
 	OPCServer();
+	// Server of other address space, several servers may live in one process.
+	explicit OPCServer( address_space::AddressSpace &addressSpace_ );
 	virtual ~OPCServer();
 
 	// IUnknown implementation
@@ -4,6 +4,7 @@
 #if( FRL_PLATFORM == FRL_PLATFORM_WIN32 )
 #include <boost/noncopyable.hpp>
 #include "opc/address_space/frl_opc_addr_space_crawler.h"
+#include "opc/address_space/frl_opc_address_space.h"
 #include "opc/frl_opc_group_manager.h"
 #include "opc/frl_opc_request_manager.h"
 
@@ -12,18 +13,24 @@ namespace frl{ namespace opc{
 class OPCServerBase : private boost::noncopyable
 {
 protected:
+	address_space::AddressSpace &addressSpace; // items of server and its groups
 	GroupManager group_manager;
 	RequestManager request_manager;
 	address_space::AddrSpaceCrawler crawler;
 	boost::mutex scopeGuard;
 
 public:
+	// Server of opcAddressSpace.
+	OPCServerBase();
+	explicit OPCServerBase( address_space::AddressSpace &addressSpace_ );
 	virtual ~OPCServerBase();
+	address_space::AddressSpace& getAddressSpace();
 	HRESULT setGroupName( const String &oldName, const String &newName );
 	GroupElem cloneGroup( String &name , String &to_name );
 	void addAsyncRequest( AsyncRequestListElem &request );
 	Bool asyncRequestCancel( DWORD id );
-	void removeItemFromRequestList( OPCHANDLE handle_ );
+	// Item handles are unique within group only.
+	void removeItemFromRequestList( OPCHANDLE group_handle, OPCHANDLE item_handle );
 	void removeGroupFromRequestList( OPCHANDLE group_handle );
 };
 
@@ -9,6 +9,11 @@
 
 namespace frl{ namespace opc{
 
+namespace address_space
+{
+	class AddressSpace;
+}
+
 class OPCServerFactory : public IClassFactory, public os::win32::com::Allocator
 {
 private:
@@ -21,6 +26,7 @@ private:
 
 	static LONG serverLocks;
 	volatile Bool outProc;
+	address_space::AddressSpace *addressSpace; // NULL - opcAddressSpace
 public:
 	// Constructor, destructor
 	OPCServerFactory();
@@ -41,6 +47,8 @@ public:
 
 	// OPCServerFactory methods
 	void isOutProc( Bool isOutProc );
+	// Servers created from now serve this address space.
+	void setAddressSpace( address_space::AddressSpace &addressSpace_ );
 	Bool isServerInUse();
 };
 
@@ -0,0 +1,117 @@
+#ifndef frl_opc_update_scheduler_h_
+#define frl_opc_update_scheduler_h_
+#include <vector>
+#include <map>
+#include <boost/noncopyable.hpp>
+#include <boost/function.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/thread.hpp>
+#include "frl_types.h"
+#include "frl_singleton.h"
+#include "opc/frl_opc_executor.h"
+
+namespace frl{ namespace opc{
+
+// Periodic tasks (updates of groups) placed into hierarchical timer wheel:
+// inner wheel has slots of one tick, outer wheel has slots of one turn of
+// inner wheel, tasks of outer slot are moved into inner wheel when its turn
+// begins. So one tick costs as much as tasks due in it, whatever their
+// periods are. Due tasks are run by executor without lock of scheduler.
+// Task is never run by two threads at once: next run is due one period
+// after previous one, or at next tick if it took longer.
+class UpdateScheduler : private boost::noncopyable
+{
+public:
+	// Runs task and returns period in milliseconds until next run
+	// or idle if task has nothing to do until wakeUp.
+	typedef boost::function< UInt() > Task;
+
+	static const UInt idle = 0xFFFFFFFF;
+
+private:
+	struct Entry
+	{
+		Task task;
+		ULong due; // tick of next run, tick of last run while entry sleeps
+		UInt period; // in ticks
+		Bool running;
+		Bool removed;
+		Bool sleeping; // entry is not in wheel till wakeUp
+		Bool woken; // wakeUp while task was running
+	};
+	typedef std::map< UInt, Entry* > Entries;
+	typedef std::vector< std::vector< Entry* > > Wheel;
+
+	Executor &executor;
+	UInt tick;
+	boost::mutex guard; // entries and wheels
+	Entries entries;
+	Wheel inner; // slot of entry is its due tick modulo size of wheel
+	Wheel outer; // slot of entry is its due turn of inner wheel modulo size of wheel
+	std::vector< Entry* > pending; // entries of processed slot
+	ULong currentTick;
+	size_t running; // entries passed to executor
+	boost::condition_variable idleCondition;
+	boost::thread timer;
+	boost::mutex stopGuard;
+	boost::condition_variable stopCondition;
+	Bool stopped;
+
+	UInt toTicks( UInt period ) const;
+	void schedule( Entry *entry );
+	void unschedule( Entry *entry );
+	void cascade( ULong turn );
+	void dispatch( Entry *entry );
+	void runEntry( Entry *entry );
+	void run();
+public:
+	// Tasks are run by opcExecutor.
+	// tick_ - resolution of scheduler in milliseconds.
+	explicit UpdateScheduler( UInt tick_ = 10 );
+
+	UpdateScheduler( Executor &executor_, UInt tick_ = 10 );
+
+	// Waits for tasks passed to executor.
+	~UpdateScheduler();
+
+	// Run task every period milliseconds, first run is after one period.
+	// Return False if task with such id is scheduled already.
+	Bool add( UInt id, const Task &task, UInt period );
+
+	// Task is not run from now, but its run in progress is not waited for
+	// (so it may be called from task). Task is destroyed after that run.
+	void remove( UInt id );
+
+	// Next run of task is one period from now (if it is not running now).
+	// Sleeping task keeps sleeping, period is used after wake up.
+	void reschedule( UInt id, UInt period );
+
+	// Task which returned idle is run again one period after its last run
+	// or at next tick if period is over. Wake up of task which runs
+	// now is not lost: it is scheduled even if it returns idle.
+	void wakeUp( UInt id );
+
+	// Pass tasks due at time now (milliseconds from any fixed moment,
+	// must not decrease) to executor. Missed runs are not repeated.
+	void process( ULong now );
+
+	// Wait until executor runs all tasks passed to it.
+	void wait();
+
+	// Thread which calls process every tick.
+	void start();
+
+	void stop();
+
+	// Number of scheduled tasks.
+	size_t size();
+}; // class UpdateScheduler
+
+// Updates of groups of all servers of process.
+typedef SingletonMeyers< UpdateScheduler > opcUpdateScheduler;
+
+} // namespace opc
+} // FatRat Library
+
+#endif // frl_opc_update_scheduler_h_
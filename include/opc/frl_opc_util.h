@@ -6,6 +6,9 @@
 #include "../dependency/vendors/opc_foundation/opcda.h"
 #include "frl_types.h"
 #include "frl_exception.h"
+#include "opc/address_space/frl_opc_value.h"
+#include "opc/address_space/frl_opc_time_stamp.h"
+#include "opc/address_space/frl_opc_path_view.h"
 
 #if ! ( defined LOCALE_INVARIANT )
 #define LOCALE_INVARIANT \
@@ -13,7 +16,14 @@
 #endif
 
 
-namespace frl{ namespace opc{ namespace util{
+namespace frl{ namespace opc{
+
+namespace address_space
+{
+	class Tag;
+}
+
+namespace util{
 
 OPCHANDLE getUniqueServerHandle();
 String getUniqueName();
@@ -22,6 +32,7 @@ char* duplicateString( const char *str );
 wchar_t* duplicateString( const wchar_t *str );
 char* duplicateString( const std::string &string );
 wchar_t* duplicateString( const std::wstring &string );
+Char* duplicateString( const address_space::PathView &string );
 
 HRESULT getErrorString(  HRESULT dwError, LCID dwLocale, LPWSTR **ppString );
 Bool matchStringPattern( const String &str, const String& pattern, Bool caseSensitive = True );
@@ -29,6 +40,14 @@ Bool matchStringPattern( const String &str, const String& pattern, Bool caseSens
 const wchar_t* getPropertyDesc( DWORD propID );
 VARTYPE getPropertyType( DWORD propID );
 
+// Conversion between address space values and COM types.
+HRESULT valueToVariant( const address_space::Value &from, VARIANT &to );
+HRESULT variantToValue( const VARIANT &from, address_space::Value &to );
+FILETIME timeStampToFileTime( const address_space::TimeStamp &from );
+address_space::TimeStamp fileTimeToTimeStamp( const FILETIME &from );
+// Return OPC_E_INVALID_PID if tag has not property propID.
+HRESULT getTagPropertyValue( const address_space::Tag &tag, DWORD propID, VARIANT &to );
+
 } // namespace util
 } // namespace opc
 } // FatRat Library
@@ -41,7 +41,7 @@ public:
 	EnumOPCItemAttributes();
 	EnumOPCItemAttributes( const EnumOPCItemAttributes& other );
 	virtual ~EnumOPCItemAttributes();
-	void addItem( const std::pair< OPCHANDLE, GroupItemElem >& newItem );
+	void addItem( const GroupItemTable &items, size_t slot );
 
 	// the IUnknown methods
 	STDMETHODIMP QueryInterface( REFIID iid, LPVOID* ppInterface );
@@ -3,6 +3,7 @@
 #include "frl_platform.h"
 #if( FRL_PLATFORM == FRL_PLATFORM_WIN32 )
 #include "../dependency/vendors/opc_foundation/opcda.h"
+#include "opc/frl_opc_server_base.h"
 
 namespace frl { namespace opc { namespace impl {
 
@@ -59,7 +60,8 @@ namespace frl { namespace opc { namespace impl {
 		in the methods on this interface as described below.
 */
 class OPCItemProperties
-	:	public IOPCItemProperties
+	:	public IOPCItemProperties,
+		virtual public opc::OPCServerBase
 {
 public:
 	virtual ~OPCItemProperties();
@@ -5,9 +5,13 @@
 namespace frl{ namespace sys{ namespace util{
 
 String getLastErrorDescription();
+#if( FRL_PLATFORM == FRL_PLATFORM_WIN32 )
 String getLastErrorDescription( WORD langID );
 String getCodeErrorDescription( DWORD error );
 String getCodeErrorDescription( WORD langID, DWORD error );
+#else
+String getCodeErrorDescription( Int error );
+#endif // FRL_PLATFORM_WIN32
 
 } // namespace util
 } // namespace sys
@@ -7,6 +7,7 @@
 #include "frl_io.h"
 #include "frl_types.h"
 #include "frl_opc.h"
+#include "opc/address_space/frl_opc_sampling_scheduler.h"
 #include "logging/frl_logging.h"
 #include <bitset>
 
@@ -20,7 +21,9 @@ struct Psoi2Channel
 	frl::opc::address_space::Tag *goodMGC; // 0 - bad MGC (micro generator of chlorine), 1 - is good MGC
 };
 
-class Psoi2Device
+// In simulation mode values of channels are produced on demand
+// of sampling scheduler with scan rate of value tags.
+class Psoi2Device : public frl::opc::address_space::SamplingDriver
 {
 private:
 	std::vector< Psoi2Channel > channels;
@@ -30,14 +33,10 @@ private:
 	frl::UInt channelsNumber;
 	frl::io::comm_ports::Serial comPort;
 	boost::thread processThread;
+	frl::opc::address_space::SamplingScheduler *sampler; // used in simulation mode
 	frl::logging::Logger log;
 
-	void setUpValues( const frl::String &low, const frl::String &hight );
-	void setUpThresholdExceeding( const frl::String &low, const frl::String &hight );
-	void setUpTypePPC( const frl::String &low, const frl::String &hight );
-	void setUpMGC( const frl::String &low, const frl::String &hight );
-	void setUpPPC( const frl::String &low, const frl::String &hight );
-	void simulationProcess();
+	void setUpTags( frl::opc::address_space::AddressSpace &part, const frl::String &low, const frl::String &hight );
 	void workProcess();
 	void fillValues( const std::vector< std::bitset<8> > &pure_array );
 	
@@ -54,9 +53,17 @@ public:
 						frl::logging::Level logLevel,
 						const frl::String &logFileNamePrefix );
 	~Psoi2Device();
-	void startProcess();
+
+	// Branch of port with tags of channels. Devices build their tags in
+	// parallel, every one into its own part merged into address space later.
+	void buildTags( frl::opc::address_space::AddressSpace &part );
+
+	void startProcess( frl::opc::address_space::SamplingScheduler &sampler_ );
 	void stopProcess();
 
+	// Simulated values of channel value tags.
+	void sample( const std::vector< frl::opc::address_space::Tag* > &tags );
+
 	frl::UInt getChannelsNumber() const;
 	frl::UInt getBytesNumber() const;
 	frl::UInt getPortNumber() const;
@@ -3,6 +3,7 @@
 #include "poor_xml/frl_poor_xml_document.h"
 #include <boost/noncopyable.hpp>
 #include "frl_opc.h"
+#include "opc/address_space/frl_opc_sampling_scheduler.h"
 #include <vector>
 
 using namespace frl;
@@ -12,10 +13,14 @@ class DeviceManager : private boost::noncopyable
 {
 private:
 	void initializeAddressSpace();
+	frl::Bool restoreAddressSpace();
+	void buildAddressSpace();
 	void initializeDAServer();
 	opc::DAServer *server;
 	poor_xml::Document config;
 	std::vector< Psoi2Device* > devices;
+	frl::opc::address_space::SamplingScheduler sampler; // simulated devices
+	frl::Bool restored; // address space is loaded from snapshot of last run
 public:
 	DeviceManager();
 	~DeviceManager();
@@ -12,6 +12,12 @@
 using namespace frl;
 using namespace frl::opc;
 
+namespace
+{
+	const frl::UInt tagsInChannel = 5;
+	const frl::UInt simulationScanRate = 2000; // milliseconds
+}
+
 namespace{ struct MyHack{}; }
 namespace boost
 {
@@ -50,7 +56,8 @@ Psoi2Device::Psoi2Device(	frl::UInt portNumber_,
 	:	portNumber( portNumber_ ),
 		bytesNumber( channelsNumber_ * 2 ),
 		simulation( simulation_ ),
-		channelsNumber( channelsNumber_ )
+		channelsNumber( channelsNumber_ ),
+		sampler( NULL )
 {
 	String portName = FRL_STR("COM_");
 	portName += lexicalCast< frl::Int, frl::String >( portNumber );
@@ -66,42 +73,7 @@ Psoi2Device::Psoi2Device(	frl::UInt portNumber_,
 	log.addDestination( frl::logging::ConsoleWriter() );
 	log.addDestination( frl::logging::FileWriter() );
 	FRL_LOG_INFO( log ) << FRL_STR("====Start log for ") << portName <<FRL_STR(" =====") ;
-	try
-	{
-		opcAddressSpace::getInstance().addBranch( portName );
-	}
-	catch( address_space::Tag::IsExistTag )
-	{
-		FRL_LOG_ERROR(log ) << FRL_STR("      OPC \
-															-    COM   ");
-		String msg = FRL_STR("Redoubling COM port# ") + lexicalCast< frl::Int, frl::String >( portNumber );
-		::MessageBox( NULL,
-			msg.c_str(),
-			FRL_STR("OPC server configuration error!"),
-			MB_OK | MB_ICONERROR );
-		exit( 1 );
-	}
-
-	portName += opcAddressSpace::getInstance().getDelimiter();
-	String low = portName + FRL_STR( "channel_0" ); // COM_X.channel_0X
-	String hight = portName + FRL_STR( "channel_" ); // COM_X.channel_XX
-
-	// Initialize branch in address space
-	for( frl::UInt i = 0; i < channelsNumber; i++ )
-	{
-		if ( i < 10)
-			opcAddressSpace::getInstance().addBranch( low + lexicalCast< int, frl::String >( i ) );
-		else
-			opcAddressSpace::getInstance().addBranch( hight + lexicalCast<int, frl::String>( i ) );
-	}
-
 	channels.resize( channelsNumber );
-
-	setUpValues( low, hight );
-	setUpThresholdExceeding( low, hight );
-	setUpTypePPC( low, hight );
-	setUpMGC( low, hight );
-	setUpPPC( low, hight );
 	
 	if( ! simulation )
 	{
@@ -137,116 +109,72 @@ Psoi2Device::~Psoi2Device()
 
 }
 
-void Psoi2Device::setUpValues( const frl::String &low, const frl::String &hight )
+void Psoi2Device::buildTags( frl::opc::address_space::AddressSpace &part )
 {
-	// set up values
-	for( frl::UInt i = 0; i < channelsNumber; i++ )
-	{
-		if ( i < 10)
-			channels[i].value = opcAddressSpace::getInstance().addLeaf( low
-			+ lexicalCast<int, frl::String>( i )
-			+ opcAddressSpace::getInstance().getDelimiter()
-			+ FRL_STR("value") ) ;
-		else
-			channels[i].value = opcAddressSpace::getInstance().addLeaf( hight
-			+ lexicalCast<int, frl::String>( i )
-			+ opcAddressSpace::getInstance().getDelimiter()
-			+ FRL_STR("value") );
-		channels[i].value->isWritable( False );
-		channels[i].value->setCanonicalDataType( VT_R4 );
-		channels[i].value->write( 0.0f );
-	}
-}
+	String portName = FRL_STR("COM_");
+	portName += lexicalCast< frl::Int, frl::String >( portNumber );
+	if( part.findBranch( portName ) == NULL ) // else restored from snapshot
+		part.addBranch( portName );
+	portName += part.getDelimiter();
+	String low = portName + FRL_STR( "channel_0" ); // COM_X.channel_0X
+	String hight = portName + FRL_STR( "channel_" ); // COM_X.channel_XX
 
-void Psoi2Device::setUpThresholdExceeding( const frl::String &low, const frl::String &hight )
-{
-	// set up threshold exceeding
-	for( frl::UInt i = 0; i < channelsNumber; i++ )
-	{
-		if ( i < 10)
-			channels[i].thresholdExceeding = opcAddressSpace::getInstance().addLeaf( low
-			+ lexicalCast<int, frl::String>( i )
-			+ opcAddressSpace::getInstance().getDelimiter()
-			+ FRL_STR("thresholdExceeding") ) ;
-		else
-			channels[i].thresholdExceeding = opcAddressSpace::getInstance().addLeaf( hight
-			+ lexicalCast<int, frl::String>( i )
-			+ opcAddressSpace::getInstance().getDelimiter()
-			+ FRL_STR("thresholdExceeding") );
-		channels[i].thresholdExceeding->isWritable( False );
-		channels[i].thresholdExceeding->setCanonicalDataType( VT_BOOL );
-		channels[i].thresholdExceeding->write( false );
-	}
+	// channel branches are created together with tags
+	setUpTags( part, low, hight );
 }
 
-void Psoi2Device::setUpTypePPC( const frl::String &low, const frl::String &hight )
+void Psoi2Device::setUpTags( frl::opc::address_space::AddressSpace &part, const frl::String &low, const frl::String &hight )
 {
-	// set up type PPC
+	// tags restored from snapshot are bound, others are created by one bulk call
+	using namespace frl::opc::address_space;
+	const frl::String &delimiter = part.getDelimiter();
+	std::vector< LeafDefinition > leafs;
+	leafs.reserve( channelsNumber * tagsInChannel );
 	for( frl::UInt i = 0; i < channelsNumber; i++ )
 	{
-		if ( i < 10)
-			channels[i].typePPC = opcAddressSpace::getInstance().addLeaf( low
-			+ lexicalCast<int, frl::String>( i )
-			+ opcAddressSpace::getInstance().getDelimiter()
-			+ FRL_STR("type") ) ;
-		else
-			channels[i].typePPC = opcAddressSpace::getInstance().addLeaf( hight
-			+ lexicalCast<int, frl::String>( i )
-			+ opcAddressSpace::getInstance().getDelimiter()
-			+ FRL_STR("type") );
-		channels[i].typePPC->isWritable( False );
-		channels[i].typePPC->setCanonicalDataType( VT_BOOL );
-		channels[i].typePPC->write( false );
+		frl::String channel = ( i < 10 ? low : hight ) + lexicalCast< int, frl::String >( i ) + delimiter;
+		leafs.push_back( LeafDefinition( channel + FRL_STR("value"), VT_R4, access_rights::READABLE,
+									simulation ? simulationScanRate : 0 ) ); // value
+		leafs.push_back( LeafDefinition( channel + FRL_STR("thresholdExceeding"), VT_BOOL ) ); // threshold exceeding
+		leafs.push_back( LeafDefinition( channel + FRL_STR("type"), VT_BOOL ) ); // type PPC
+		leafs.push_back( LeafDefinition( channel + FRL_STR("goodMGC"), VT_BOOL ) ); // state of micro generator chlorine
+		leafs.push_back( LeafDefinition( channel + FRL_STR("goodPPC"), VT_BOOL ) ); // state PPC
 	}
-}
-
-void Psoi2Device::setUpMGC( const frl::String &low, const frl::String &hight )
-{
-	// set up state of micro generator chlorine
-	for( frl::UInt i = 0; i < channelsNumber; i++ )
+	std::vector< Tag* > tags( leafs.size() );
+	std::vector< LeafDefinition > missing;
+	std::vector< size_t > missingIndexes;
+	for( size_t i = 0; i < leafs.size(); ++i )
 	{
-		if ( i < 10)
-			channels[i].goodMGC = opcAddressSpace::getInstance().addLeaf( low
-			+ lexicalCast<int, frl::String>( i )
-			+ opcAddressSpace::getInstance().getDelimiter()
-			+ FRL_STR("goodMGC") ) ;
-		else
-			channels[i].goodMGC = opcAddressSpace::getInstance().addLeaf( hight
-			+ lexicalCast<int, frl::String>( i )
-			+ opcAddressSpace::getInstance().getDelimiter()
-			+ FRL_STR("goodMGC") );
-		channels[i].goodMGC->isWritable( False );
-		channels[i].goodMGC->setCanonicalDataType( VT_BOOL );
-		channels[i].goodMGC->write( false );
+		tags[i] = part.findLeaf( leafs[i].fullPath );
+		if( tags[i] == NULL )
+		{
+			missing.push_back( leafs[i] );
+			missingIndexes.push_back( i );
+		}
 	}
-}
-
-void Psoi2Device::setUpPPC( const frl::String &low, const frl::String &hight )
-{
-	// set up state PPC
+	std::vector< Tag* > added;
+	if( ! missing.empty() )
+		part.addLeafs( missing, added );
+	for( size_t i = 0; i < added.size(); ++i )
+		tags[ missingIndexes[i] ] = added[i];
 	for( frl::UInt i = 0; i < channelsNumber; i++ )
 	{
-		if ( i < 10)
-			channels[i].goodPPC = opcAddressSpace::getInstance().addLeaf( low
-			+ lexicalCast<int, frl::String>( i )
-			+ opcAddressSpace::getInstance().getDelimiter()
-			+ FRL_STR("goodPPC") ) ;
-		else
-			channels[i].goodPPC = opcAddressSpace::getInstance().addLeaf( hight
-			+ lexicalCast<int, frl::String>( i )
-			+ opcAddressSpace::getInstance().getDelimiter()
-			+ FRL_STR("goodPPC") );
-		channels[i].goodPPC->isWritable( False );
-		channels[i].goodPPC->setCanonicalDataType( VT_BOOL );
-		channels[i].goodPPC->write( false );
+		channels[i].value = tags[ i * tagsInChannel ];
+		channels[i].value->setEURange( 0.0, 100.0 ); // concentration, percent deadband is taken of it
+		channels[i].thresholdExceeding = tags[ i * tagsInChannel + 1 ];
+		channels[i].typePPC = tags[ i * tagsInChannel + 2 ];
+		channels[i].goodMGC = tags[ i * tagsInChannel + 3 ];
+		channels[i].goodPPC = tags[ i * tagsInChannel + 4 ];
 	}
 }
 
-void Psoi2Device::startProcess()
+void Psoi2Device::startProcess( frl::opc::address_space::SamplingScheduler &sampler_ )
 {
 	if( simulation )
 	{
-		processThread = boost::thread( boost::function< void() >( boost::bind( &Psoi2Device::simulationProcess, this ) ) );
+		sampler = &sampler_;
+		for( frl::UInt i = 0; i < getChannelsNumber(); ++i )
+			sampler->add( channels[i].value, this );
 	}
 	else
 	{
@@ -255,18 +183,13 @@ void Psoi2Device::startProcess()
 
 }
 
-void Psoi2Device::simulationProcess()
+void Psoi2Device::sample( const std::vector< frl::opc::address_space::Tag* > &tags )
 {
-	FRL_LOG_TRACE( log ) << FRL_STR(" -" );
-	for( ; ; )
+	for( size_t i = 0; i < tags.size(); ++i )
 	{
-		::Sleep( 2000 );
-		for( frl::UInt i = 0; i < getChannelsNumber(); ++i )
-		{
-			float value = (float)rand();
-			value = ( value * 100 ) / rand();
-			setValue( i, value );
-		}
+		float value = (float)rand();
+		value = ( value * 100 ) / rand();
+		tags[i]->write( value );
 	}
 }
 
@@ -473,6 +396,12 @@ void Psoi2Device::setThresholdExceeding( frl::UInt number, frl::Bool thresholdEx
 
 void Psoi2Device::stopProcess() // WARNING - hack!
 {
+	if( simulation )
+	{
+		if( sampler != NULL )
+			sampler->remove( this );
+		return;
+	}
 	thread_killer killer( processThread );
 	boost::thread thrKill( killer );
 	thrKill.join();
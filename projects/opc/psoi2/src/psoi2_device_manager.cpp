@@ -1,12 +1,34 @@
 #include <Windows.h>
 #include <boost/filesystem.hpp>
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/exception_ptr.hpp>
 #include "psoi2_device_manager.h"
 #include "psoi2_device.h"
 #include "frl_lexical_cast.h"
 #include "logging/frl_logging.h"
 #include "util.h"
 
+// address space with last values is saved at exit and restored at start
+static const frl::Char *snapshotFileName = FRL_STR("address_space.snapshot");
+
+// Exception can not leave builder thread, it is kept and rethrown after join.
+static void buildDeviceTags( Psoi2Device *device, frl::opc::address_space::AddressSpace *part,
+									boost::exception_ptr *error )
+{
+	try
+	{
+		device->buildTags( *part );
+	}
+	catch( ... )
+	{
+		*error = boost::current_exception();
+	}
+}
+
 DeviceManager::DeviceManager()
+	:	sampler( frl::opc::opcAddressSpace::getInstance() ),
+		restored( frl::False )
 {
 	initializeAddressSpace();
 	using namespace frl::opc;
@@ -76,11 +98,21 @@ DeviceManager::DeviceManager()
 			frl::Int channelNumber = frl::lexicalCast< frl::String, frl::Int >( (*it)->getProprtyVal( FRL_STR("Channels") ) );
 			frl::Int portNumber = frl::lexicalCast< frl::String, frl::Int >( (*it)->getProprtyVal( FRL_STR("ComPort") ) );
 			frl::Bool simulation = frl::lexicalCast< frl::String, frl::Bool >( (*it)->getProprtyVal( FRL_STR("Simulation") ) );
+			if( getDevice( portNumber ) != NULL )
+			{
+				String msg = FRL_STR("Redoubling COM port# ") + lexicalCast< frl::Int, frl::String >( portNumber );
+				::MessageBox( NULL,
+					msg.c_str(),
+					FRL_STR("OPC server configuration error!"),
+					MB_OK | MB_ICONERROR );
+				exit( 1 );
+			}
 			Psoi2Device *device = new Psoi2Device( portNumber, channelNumber, simulation, logLevel, logFileNamePrefix );
 			devices.push_back( device );
 			if( simulation )
 				startRand = frl::True;
 		}
+		buildAddressSpace();
 	}
 	catch( frl::Exception &ex )
 	{
@@ -97,12 +129,16 @@ DeviceManager::DeviceManager()
 
 	for( std::vector< Psoi2Device* >::iterator it = devices.begin(); it != devices.end(); ++it )
 	{
-		(*it)->startProcess();
+		(*it)->startProcess( sampler );
 	}
+	// values which no client watches are refreshed once a minute
+	sampler.setDemandDriven( True, 60000 );
+	sampler.start();
 }
 
 DeviceManager::~DeviceManager()
 {
+	sampler.stop();
 	if( devices.size() )
 	{
 		for( std::vector< Psoi2Device* >::iterator it = devices.begin(); it != devices.end(); ++it )
@@ -111,18 +147,88 @@ DeviceManager::~DeviceManager()
 			delete (*it);
 		}
 	}
+	try
+	{
+		frl::opc::opcAddressSpace::getInstance().saveSnapshot( snapshotFileName );
+	}
+	catch( frl::Exception& )
+	{
+		// next start is cold
+	}
 	delete server;
 }
 
 void DeviceManager::initializeAddressSpace()
 {
-	frl::opc::opcAddressSpace::getInstance().finalConstruct( FRL_STR(".")); // initialize opc server address space
-	frl::opc::address_space::Tag* info = frl::opc::opcAddressSpace::getInstance().addLeaf( FRL_STR("information"));
+	frl::opc::address_space::AddressSpace &space = frl::opc::opcAddressSpace::getInstance();
+	space.finalConstruct( FRL_STR(".")); // initialize opc server address space
+	restored = restoreAddressSpace();
+	frl::opc::address_space::Tag* info = space.findLeaf( FRL_STR("information") );
+	if( info == NULL )
+		info = space.addLeaf( FRL_STR("information"));
 	info->isWritable( False );
 	info->setCanonicalDataType( VT_BSTR );
 	info->write( String( FRL_STR("OPC server for PSOI2 (-02) devices. If you to find error - please let me know (serg.baburin@gmail.com).") ) );
 }
 
+frl::Bool DeviceManager::restoreAddressSpace()
+{
+	if( ! boost::filesystem::exists( snapshotFileName ) )
+		return frl::False;
+	try
+	{
+		frl::opc::opcAddressSpace::getInstance().loadSnapshot( snapshotFileName );
+	}
+	catch( frl::Exception& )
+	{
+		// image of other version or broken, tags are built from configuration
+		return frl::False;
+	}
+	return frl::True;
+}
+
+void DeviceManager::buildAddressSpace()
+{
+	if( restored )
+	{
+		// devices bind tags restored from snapshot, tags of new channels are added
+		for( std::vector< Psoi2Device* >::iterator it = devices.begin(); it != devices.end(); ++it )
+			(*it)->buildTags( frl::opc::opcAddressSpace::getInstance() );
+		return;
+	}
+	// tags of every device are built by its own thread into separate
+	// address space and merged into server address space at the end
+	using namespace frl::opc::address_space;
+	std::vector< AddressSpace* > parts;
+	std::vector< boost::exception_ptr > errors( devices.size() ); // by builders
+	boost::thread_group builders;
+	try
+	{
+		for( size_t i = 0; i < devices.size(); ++i )
+		{
+			parts.push_back( new AddressSpace() );
+			parts.back()->finalConstruct( frl::opc::opcAddressSpace::getInstance().getDelimiter() );
+			builders.create_thread( boost::bind( &buildDeviceTags, devices[i], parts.back(), &errors[i] ) );
+		}
+		builders.join_all();
+		for( size_t i = 0; i < errors.size(); ++i )
+		{
+			if( errors[i] )
+				boost::rethrow_exception( errors[i] );
+		}
+		frl::opc::opcAddressSpace::getInstance().merge( parts );
+	}
+	catch( ... )
+	{
+		builders.join_all();
+		for( std::vector< AddressSpace* >::iterator it = parts.begin(); it != parts.end(); ++it )
+			delete *it;
+		throw;
+	}
+	for( std::vector< AddressSpace* >::iterator it = parts.begin(); it != parts.end(); ++it )
+		delete *it;
+}
+
 void DeviceManager::initializeDAServer()
 {
 	server = new frl::opc::DAServer( frl::opc::ServerTypes::localSever32 );
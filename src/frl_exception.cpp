@@ -1,28 +1,60 @@
+#include <algorithm>
+#include <boost/thread/tss.hpp>
 #include "frl_exception.h"
 #include "stream_std/frl_sstream.h"
 
 namespace frl
 {
-	Exception *Exception::last = NULL;
-	String Exception::msFunctionStack[ FRL_CALL_STACK_DEPTH ];
-	UShort Exception::msStackDepth = 0;
+	namespace private_
+	{
+		// Guarded functions of one thread, deeper ones are only counted.
+		struct FunctionStack
+		{
+			String functions[ FRL_CALL_STACK_DEPTH ];
+			UShort depth;
+			Exception *last;
+
+			FunctionStack()
+				:	depth( 0 ), last( NULL )
+			{
+			}
+		};
+
+		// created at first use, guards may run while static objects are constructed
+		boost::thread_specific_ptr< FunctionStack >& getFunctionStacks()
+		{
+			static boost::thread_specific_ptr< FunctionStack > stacks;
+			return stacks;
+		}
+
+		FunctionStack* getFunctionStack()
+		{
+			FunctionStack *stack = getFunctionStacks().get();
+			if( stack == NULL )
+			{
+				stack = new FunctionStack();
+				getFunctionStacks().reset( stack );
+			}
+			return stack;
+		}
+	} // namespace private_
 
 	Exception::Exception( const String &description_ )
 		:	line( 0 ),
 			description( description_ ),
 			function( FRL_STR("") ),
-			stackDepth( msStackDepth )
+			callStack()
 	{
-		last = this;
+		saveCallStack();
 	}
 
 	Exception::Exception( const String &description_, const String &function_ )
 		:	line( 0 ),
 			description( description_ ),
 			function( function_ ),
-			stackDepth( msStackDepth )
+			callStack()
 	{
-		last = this;
+		saveCallStack();
 	}
 
 	Exception::Exception( const frl::String &function_, const String &file_, frl::ULong line_ )
@@ -30,9 +62,9 @@ namespace frl
 			description( FRL_STR("Unknown description") ),
 			function( function_ ),
 			file( file_ ),
-			stackDepth( msStackDepth )
+			callStack()
 	{
-		last = this;
+		saveCallStack();
 	}
 
 	Exception::Exception( const frl::String &description_, const frl::String &function_, const String &file_, frl::ULong line_ )
@@ -40,9 +72,9 @@ namespace frl
 			description( description_ ),
 			function( function_ ),
 			file( file_ ),
-			stackDepth( msStackDepth )
+			callStack()
 	{
-		last = this;
+		saveCallStack();
 	}
 
 	Exception::Exception( const Exception &rvl )
@@ -50,7 +82,8 @@ namespace frl
 			line( rvl.line ),
 			description( rvl.description ),
 			function( rvl.function ),
-			file( rvl.file )
+			file( rvl.file ),
+			callStack( rvl.callStack )
 	{
 	}
 
@@ -62,6 +95,7 @@ namespace frl
 		function = rvl.function;
 		file = rvl.file;
 		line = rvl.line;
+		callStack = rvl.callStack;
 		return *this;
 	}
 
@@ -101,28 +135,48 @@ namespace frl
 		}
 
 		desc << "\nStack unwinding:\n";
-		for(  UShort stackUnroll = stackDepth <= FRL_CALL_STACK_DEPTH ? ( stackDepth - 1 ) : ( FRL_CALL_STACK_DEPTH - 1 );
-				stackUnroll < stackDepth;
-				--stackUnroll )
-		{
-			desc << msFunctionStack[ stackUnroll ] << FRL_STR(" <= " );
-		}
+		for( std::vector< String >::const_reverse_iterator it = callStack.rbegin(); it != callStack.rend(); ++it )
+			desc << *it << FRL_STR(" <= " );
 
 		desc << FRL_STR( "<< beginning of stack >>\n" );
 		return desc.str();
 	}
 
+	void Exception::saveCallStack()
+	{
+		private_::FunctionStack *stack = private_::getFunctionStack();
+		stack->last = this;
+		callStack.assign( stack->functions, stack->functions + std::min< UShort >( stack->depth, FRL_CALL_STACK_DEPTH ) );
+	}
+
+	Exception* Exception::GetLastException(void) throw()
+	{
+		private_::FunctionStack *stack = private_::getFunctionStacks().get();
+		return stack == NULL ? NULL : stack->last;
+	}
+
 	//-----------------------------------------------------------------------
 	void Exception::pushFunction( const String& strFuncName ) throw()
 	{
-		if( msStackDepth < FRL_CALL_STACK_DEPTH )
-			msFunctionStack[ msStackDepth ] = strFuncName;
-		++msStackDepth;
+		// every thread has own stack, guards of threads do not race
+		try
+		{
+			private_::FunctionStack *stack = private_::getFunctionStack();
+			// counted first, so popFunction stays balanced
+			if( ++stack->depth <= FRL_CALL_STACK_DEPTH )
+				stack->functions[ stack->depth - 1 ] = strFuncName;
+		}
+		catch( ... )
+		{
+			// function is not shown in stack unwinding
+		}
 	}
 
 	//-----------------------------------------------------------------------
 	void Exception::popFunction() throw()
 	{
-		--msStackDepth;
+		private_::FunctionStack *stack = private_::getFunctionStacks().get();
+		if( stack != NULL && stack->depth != 0 )
+			--stack->depth;
 	}
 } // FatRat Library
@@ -1,5 +1,7 @@
 #include "frl_string.h"
 #include <algorithm>
+#include <string.h>
+#include <wchar.h>
 
 namespace frl{
 
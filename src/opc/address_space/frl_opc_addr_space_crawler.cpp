@@ -1,13 +1,18 @@
-#include "frl_platform.h"
-#if( FRL_PLATFORM == FRL_PLATFORM_WIN32 )
 #include "opc/address_space/frl_opc_addr_space_crawler.h"
 #include "opc/address_space/frl_opc_address_space.h"
 
 namespace frl{ namespace opc{ namespace address_space{
 
 AddrSpaceCrawler::AddrSpaceCrawler()
+	:	space( &opcAddressSpace::getInstance() )
 {
-	root = curPos = opcAddressSpace::getInstance().getRootBranch();				
+	root = curPos = space->getRootBranch();
+}
+
+AddrSpaceCrawler::AddrSpaceCrawler( AddressSpace &space_ )
+	:	space( &space_ )
+{
+	root = curPos = space->getRootBranch();
 }
 
 void AddrSpaceCrawler::goToRoot()
@@ -23,12 +28,14 @@ frl::Bool AddrSpaceCrawler::goUp()
 	return True;
 }
 
-void AddrSpaceCrawler::goDown( const String &path )
+frl::Bool AddrSpaceCrawler::goDown( const String &path )
 {
-	if( ! getCurPosPath().empty() )
-		curPos = curPos->getBranch( getCurPosPath() + opcAddressSpace::getInstance().getDelimiter() + path );
-	else
-		curPos = curPos->getBranch( path );
+	NamespaceVersionPtr version = space->getVersion();
+	Tag *tmp = curPos->findDescendant( path );
+	if( tmp == NULL || ! tmp->isBranch() )
+		return False;
+	curPos = tmp;
+	return True;
 }
 
 frl::String AddrSpaceCrawler::getCurPosPath()
@@ -36,47 +43,63 @@ frl::String AddrSpaceCrawler::getCurPosPath()
 	return curPos->getID();
 }
 
-void AddrSpaceCrawler::goTo( const String &fullPath )
+frl::Bool AddrSpaceCrawler::goTo( const String &fullPath )
 {
-	curPos = opcAddressSpace::getInstance().getBranch( fullPath );
+	Tag *tmp = space->findBranch( fullPath );
+	if( tmp == NULL )
+		return False;
+	curPos = tmp;
+	return True;
 }
 
 void AddrSpaceCrawler::browseBranches( std::vector< String > &branches )
 {
 	branches.clear();
+	NamespaceVersionPtr version = space->getVersion();
 	curPos->browseBranches( branches );
 }
 
 void AddrSpaceCrawler::browseBranches( std::vector< TagBrowseInfo > &branchesArr )
 {
 	branchesArr.clear();
+	NamespaceVersionPtr version = space->getVersion();
 	curPos->browseBranches( branchesArr );
 }
 
-void AddrSpaceCrawler::browseLeafs( std::vector< String > &leafs, DWORD accessFilter /*= 0 */ )
+void AddrSpaceCrawler::browseLeafs( std::vector< String > &leafs, UInt accessFilter /*= 0 */, DataType dataType /*= data_type::EMPTY */ )
 {
 	leafs.clear();
-	curPos->browseLeafs( leafs, accessFilter );
+	NamespaceVersionPtr version = space->getVersion();
+	curPos->browseLeafs( leafs, accessFilter, dataType );
 }
 
 void AddrSpaceCrawler::browseLeafs( std::vector< TagBrowseInfo > &leafsArr )
 {
 	leafsArr.clear();
+	NamespaceVersionPtr version = space->getVersion();
 	curPos->browseLeafs( leafsArr );
 }
 
 void AddrSpaceCrawler::browse( std::vector< TagBrowseInfo >& arr )
 {
-	std::vector< TagBrowseInfo > tmp;
-	curPos->browseLeafs( tmp );
-	arr.assign( tmp.begin(), tmp.end() );
-	tmp.clear();
-	curPos->browseBranches( tmp );
-	arr.insert( arr.end(), tmp.begin(), tmp.end() );
+	arr.clear();
+	NamespaceVersionPtr version = space->getVersion();
+	curPos->browseLeafs( arr );
+	curPos->browseBranches( arr );
+}
+
+Bool AddrSpaceCrawler::browsePage(	std::vector< TagBrowseInfo > &arr,
+												UInt filter,
+												const String &fromID,
+												size_t maxCount,
+												const NamePattern &nameFilter,
+												String &nextID )
+{
+	NamespaceVersionPtr version = space->getVersion();
+	return curPos->browsePage( arr, filter, fromID, maxCount, nameFilter, nextID );
 }
 
 } // namespace address_space
 } // namespace opc
 } // namespace frl
 
-#endif // FRL_PLATFORM_WIN32
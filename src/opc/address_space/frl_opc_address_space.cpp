@@ -1,10 +1,131 @@
-#include "frl_platform.h"
-#if( FRL_PLATFORM == FRL_PLATFORM_WIN32 )
+#include <algorithm>
+#include <new>
 #include "opc/address_space/frl_opc_address_space.h"
 
 namespace frl{ namespace opc{ namespace address_space{
 
-AddressSpace::AddressSpace() : rootTag( NULL ), init( False )
+LeafDefinition::LeafDefinition()
+	:	dataType( data_type::EMPTY ),
+		accessRights( access_rights::READABLE ),
+		scanRate( 0 )
+{
+}
+
+LeafDefinition::LeafDefinition( const String &fullPath_, DataType dataType_, UInt accessRights_, UInt scanRate_ )
+	:	fullPath( fullPath_ ),
+		dataType( dataType_ ),
+		accessRights( accessRights_ ),
+		scanRate( scanRate_ )
+{
+}
+
+namespace private_
+{
+	// Leaf definition with hash of its branch path: sorting by hash
+	// groups leafs of one branch without comparing long strings.
+	struct LeafKey
+	{
+		size_t branchHash;
+		size_t branchLength;
+		const LeafDefinition *def;
+	};
+
+	LeafKey makeLeafKey( const LeafDefinition &def, Char delimiter )
+	{
+		LeafKey key;
+		key.branchLength = PathView( def.fullPath ).getParent( delimiter ).size();
+		key.branchHash = TagIndex::hashOf( def.fullPath.data(), key.branchLength );
+		key.def = &def;
+		return key;
+	}
+
+	Bool isSameBranch( const LeafKey &lhv, const LeafKey &rhv )
+	{
+		return lhv.branchHash == rhv.branchHash
+			&& lhv.branchLength == rhv.branchLength
+			&& lhv.def->fullPath.compare( 0, lhv.branchLength, rhv.def->fullPath, 0, rhv.branchLength ) == 0;
+	}
+
+	struct LeafKeyLess
+	{
+		Bool operator()( const LeafKey &lhv, const LeafKey &rhv ) const
+		{
+			if( lhv.branchHash != rhv.branchHash )
+				return lhv.branchHash < rhv.branchHash;
+			int cmp = lhv.def->fullPath.compare( 0, lhv.branchLength, rhv.def->fullPath, 0, rhv.branchLength );
+			if( cmp != 0 )
+				return cmp < 0;
+			return lhv.def->fullPath < rhv.def->fullPath;
+		}
+	};
+
+	// runs[r] is begin of r-th group of leafs with same branch, last element is keys.size()
+	void findRuns( const std::vector< LeafKey > &keys, std::vector< size_t > &runs )
+	{
+		runs.clear();
+		for( size_t i = 0; i < keys.size(); ++i )
+		{
+			if( i == 0 || ! isSameBranch( keys[i-1], keys[i] ) )
+				runs.push_back( i );
+		}
+		runs.push_back( keys.size() );
+	}
+
+	PathView getBranchPath( const LeafKey &key )
+	{
+		return PathView( key.def->fullPath ).prefix( key.branchLength );
+	}
+
+	// Order of depth-first walk over children ordered by ID: IDs are compared
+	// segment by segment.
+	class TreeOrderLess
+	{
+	private:
+		Char delimiter;
+	public:
+		TreeOrderLess( Char delimiter_ )
+			:	delimiter( delimiter_ )
+		{
+		}
+
+		Bool operator()( const String &lhv, const String &rhv ) const
+		{
+			PathTokenizer lhvTokens( lhv, delimiter );
+			PathTokenizer rhvTokens( rhv, delimiter );
+			PathView lhvSegment, rhvSegment;
+			for( ;; )
+			{
+				Bool lhvNext = lhvTokens.next( lhvSegment );
+				Bool rhvNext = rhvTokens.next( rhvSegment );
+				if( ! lhvNext || ! rhvNext )
+					return rhvNext;
+				int cmp = lhvSegment.compare( rhvSegment );
+				if( cmp != 0 )
+					return cmp < 0;
+			}
+		}
+	};
+} // namespace private_
+
+AddressSpace::Update::Update( AddressSpace &space_ )
+	:	space( space_ ),
+		guard( space_.updateGuard ),
+		next( new NamespaceVersion( space_.current->getNumber() + 1, &space_.arena ) )
+{
+}
+
+AddressSpace::Update::~Update()
+{
+	// every created tag is in new array of some branch
+	if( ! space.drafts.empty() )
+		space.publish( next );
+}
+
+AddressSpace::AddressSpace()
+	:	rootTag( NULL ),
+		init( False ),
+		current( new NamespaceVersion( 0, &arena ) ),
+		publishedVersion( 0 )
 {
 	rootTag = NULL;
 }
@@ -21,7 +142,10 @@ const String& AddressSpace::getDelimiter() const
 
 void AddressSpace::finalConstruct( const String &delimiter_ )
 {
-	if( delimiter_.empty() || delimiter.size() > 1 )
+	FRL_EXCEPT_GUARD();
+	if( delimiter_.size() > 1 )
+		FRL_THROW_S_CLASS( InvalidParameter );
+	if( delimiter_.empty() )
 		delimiter = FRL_STR('.');
 	else
 		delimiter = delimiter_;
@@ -34,112 +158,444 @@ void AddressSpace::addBranch( const String &fullPath )
 	FRL_EXCEPT_GUARD();
 	if( rootTag == NULL )
 		FRL_THROW_S_CLASS( NotFinalConstruct );
-	if( fullPath.empty() )
+	if( ! isValidPath( fullPath ) )
 		FRL_THROW_S_CLASS( InvalidBranchName );
-	size_t pos = fullPath.rfind( delimiter + delimiter );
-	if ( pos != String::npos )
-		FRL_THROW_S_CLASS( InvalidBranchName );
-	pos = fullPath.rfind( delimiter );
-	if( pos == String::npos )
-	{
-		Tag *added = rootTag->addBranch( fullPath );
-		nameBranchCache.insert( std::pair< String, Tag*>( fullPath, added ) );
-		return;
-	}
-	// last or first symbol in branch name == delimiter
-	if( pos == fullPath.size()-1 || pos == 0 )
-		FRL_THROW_S_CLASS( InvalidBranchName );
-	String tmpPath = fullPath.substr( 0, pos );
-	Tag *added = getBranch( tmpPath )->addBranch( fullPath );
-	nameBranchCache.insert( std::pair< String, Tag*>( fullPath, added ) );
+	Update update( *this );
+	PathView parentPath = PathView( fullPath ).getParent( delimiter[0] );
+	Tag *parent = parentPath.empty() ? rootTag : getBranch( parentPath );
+	nameBranchCache.insert( createTag( parent, fullPath, True ) );
 }
 
-Tag* AddressSpace::getBranch( const String& fullPath )
+Tag* AddressSpace::getBranch( const PathView &fullPath )
 {
-	if( fullPath.empty() )
-		return rootTag;
-	std::map< String, Tag*>::iterator it = nameBranchCache.find( fullPath );
-	if( it == nameBranchCache.end() )
+	Tag *tag = findBranch( fullPath );
+	if( tag == NULL )
 		FRL_THROW_S_CLASS( Tag::NotExistTag );
-	return (*it).second;
+	return tag;
 }
 
 Tag* AddressSpace::addLeaf( const String &fullPath, Bool createPath )
 {
 	FRL_EXCEPT_GUARD();
-	if( fullPath.empty() )
-		FRL_THROW_S_CLASS( InvalidLeafName );
-	size_t pos = fullPath.rfind( delimiter + delimiter );
-	if ( pos != String::npos )
-		FRL_THROW_S_CLASS( InvalidLeafName );
-	pos = fullPath.rfind( delimiter );
-	if( pos == 0 || pos == fullPath.length()-1 )
+	if( rootTag == NULL )
+		FRL_THROW_S_CLASS( NotFinalConstruct );
+	if( ! isValidPath( fullPath ) )
 		FRL_THROW_S_CLASS( InvalidLeafName );
-	if( pos == String::npos )
+	Update update( *this );
+	Tag *branch = findBranch( PathView( fullPath ).getParent( delimiter[0] ) );
+	if( branch == NULL )
 	{
-		if ( rootTag->isExistTag( fullPath ) )
-			FRL_THROW_S_CLASS( Tag::IsExistTag );
-		rootTag->addLeaf( fullPath );
-		Tag *added = rootTag->getLeaf( fullPath );
-		nameLeafCache.insert( std::pair< String, Tag*>( fullPath, added ) );
-		return added;
+		if( ! createPath )
+			FRL_THROW_S_CLASS( Tag::NotExistTag );
+		return NULL;
 	}
-	String fullBranchName = fullPath.substr(0, pos );
+	Tag *added = createTag( branch, fullPath, False );
+	nameLeafCache.insert( added );
+	return added;
+}
 
+Bool AddressSpace::isValidPath( const PathView &fullPath ) const
+{
+	return fullPath.isValid( delimiter[0] );
+}
+
+Tag* AddressSpace::placeTag( Tag *parent, const String &fullPath, Bool isBranch )
+{
+	Tag *tag = new( arena.allocate() ) Tag( isBranch, delimiter );
+	tag->in_arena = True;
+	tag->version = current->getNumber() + 1;
 	try
 	{
-		getBranch( fullBranchName )->addLeaf( fullPath );
-		Tag *added = getBranch( fullBranchName )->getLeaf( fullPath );
-		nameLeafCache.insert( std::pair< String, Tag*>( fullPath, added ) );
-		return added;
+		tag->setID( fullPath );
+		tag->handle = handles.add( tag );
+		Tag::insertChild( draftChildren( parent ), tag );
+		tag->setParent( parent );
+		if( ! isBranch )
+		{
+			tag->attributesIndex.store( &attributes, boost::memory_order_release );
+			tag->updateAttributes();
+		}
 	}
-	catch( Tag::NotExistTag& )
+	catch( ... )
 	{
-		if( ! createPath )
-			FRL_THROW_S_CLASS( Tag::NotExistTag );
+		attributes.remove( tag->handle );
+		handles.remove( tag->handle );
+		tag->~Tag();
+		arena.deallocate( tag );
+		throw;
+	}
+	return tag;
+}
+
+Tag* AddressSpace::createTag( Tag *parent, const String &fullPath, Bool isBranch )
+{
+	if( parent->isExistTag( fullPath ) )
+		FRL_THROW_S_CLASS( Tag::IsExistTag );
+	return placeTag( parent, fullPath, isBranch );
+}
+
+Tag::Children& AddressSpace::draftChildren( Tag *branch )
+{
+	// branch created by this update is not reachable by readers yet
+	if( branch->version > publishedVersion.load( boost::memory_order_relaxed ) )
+		return *branch->children.load( boost::memory_order_relaxed );
+	std::map< Tag*, Tag::Children* >::iterator it = drafts.lower_bound( branch );
+	if( it != drafts.end() && it->first == branch )
+		return *it->second;
+	// place for replaced array is reserved, so publish does not throw
+	size_t retiredNumber = current->retired.size() + drafts.size() + 1;
+	if( current->retired.capacity() < retiredNumber )
+		current->retired.reserve( 2 * retiredNumber );
+	Tag::Children *draft = new Tag::Children( *branch->getChildren() );
+	try
+	{
+		drafts.insert( it, std::make_pair( branch, draft ) );
+	}
+	catch( ... )
+	{
+		delete draft;
+		throw;
+	}
+	return *draft;
+}
+
+void AddressSpace::publish( const boost::shared_ptr< NamespaceVersion > &next )
+{
+	// new tags may be found by ID a bit earlier than browsed, not vice versa
+	publishedVersion.store( next->getNumber(), boost::memory_order_release );
+	for( std::map< Tag*, Tag::Children* >::iterator it = drafts.begin(); it != drafts.end(); ++it )
+		current->retired.push_back( it->first->children.exchange( it->second, boost::memory_order_acq_rel ) );
+	drafts.clear();
+	current->removed.swap( removedTags );
+	try
+	{
+		nameLeafCache.takeReplaced( current->replacedTables );
+		nameBranchCache.takeReplaced( current->replacedTables );
+	}
+	catch( ... )
+	{
+		// not taken tables stay with index
 	}
-	return NULL;
+	current->next = next;
+	boost::atomic_store( &current, next );
+}
+
+Bool AddressSpace::isPublished( const Tag *tag ) const
+{
+	return tag->version <= publishedVersion.load( boost::memory_order_acquire );
+}
+
+NamespaceVersionPtr AddressSpace::getVersion() const
+{
+	return boost::atomic_load( &current );
+}
+
+Tag* AddressSpace::createBranchPath( const PathView &fullPath )
+{
+	// branches of this update are not published yet
+	Tag *branch = fullPath.empty() ? rootTag : nameBranchCache.find( fullPath );
+	if( branch != NULL )
+		return branch;
+	Tag *parent = createBranchPath( fullPath.getParent( delimiter[0] ) );
+	branch = placeTag( parent, fullPath.toString(), True );
+	nameBranchCache.insert( branch );
+	return branch;
+}
+
+void AddressSpace::addLeafs( const std::vector< LeafDefinition > &leafs, std::vector< Tag* > &added )
+{
+	FRL_EXCEPT_GUARD();
+	if( rootTag == NULL )
+		FRL_THROW_S_CLASS( NotFinalConstruct );
+	Update update( *this );
+	std::vector< private_::LeafKey > keys( leafs.size() );
+	for( size_t i = 0; i < leafs.size(); ++i )
+	{
+		if( ! isValidPath( leafs[i].fullPath ) )
+			FRL_THROW_S_CLASS( InvalidLeafName );
+		keys[i] = private_::makeLeafKey( leafs[i], delimiter[0] );
+	}
+	std::sort( keys.begin(), keys.end(), private_::LeafKeyLess() );
+	std::vector< size_t > runs;
+	private_::findRuns( keys, runs );
+
+	// check all definitions, nothing created yet
+	std::vector< PathView > newBranches; // parts of IDs of definitions
+	for( size_t r = 0; r + 1 < runs.size(); ++r )
+	{
+		PathView branchPath = private_::getBranchPath( keys[ runs[r] ] );
+		Tag *branch = findBranch( branchPath );
+		for( ; ! isExistBranch( branchPath ); branchPath = branchPath.getParent( delimiter[0] ) )
+		{
+			if( isExistLeaf( branchPath ) )
+				FRL_THROW_S_CLASS( Tag::IsNotBranch );
+			newBranches.push_back( branchPath );
+		}
+		for( size_t i = runs[r]; i < runs[r+1]; ++i )
+		{
+			const String &path = keys[i].def->fullPath;
+			if( ( i > runs[r] && keys[i-1].def->fullPath == path )
+				|| ( branch != NULL && branch->findChild( path ) != NULL ) )
+				FRL_THROW_S_CLASS( Tag::IsExistTag );
+		}
+	}
+	std::sort( newBranches.begin(), newBranches.end() );
+	newBranches.erase( std::unique( newBranches.begin(), newBranches.end() ), newBranches.end() );
+	for( size_t r = 0; r + 1 < runs.size() && ! newBranches.empty(); ++r )
+	{
+		// leaf of this group and new branch with same path
+		PathView branchPath = private_::getBranchPath( keys[ runs[r] ] );
+		std::vector< PathView >::const_iterator it = std::lower_bound( newBranches.begin(), newBranches.end(), branchPath );
+		for( ; it != newBranches.end() && it->startsWith( branchPath ); ++it )
+		{
+			if( *it == branchPath || it->getParent( delimiter[0] ) != branchPath )
+				continue;
+			LeafDefinition probe( it->toString() );
+			if( std::binary_search( keys.begin() + runs[r], keys.begin() + runs[r+1],
+					private_::makeLeafKey( probe, delimiter[0] ), private_::LeafKeyLess() ) )
+				FRL_THROW_S_CLASS( Tag::IsNotBranch );
+		}
+	}
+
+	added.assign( leafs.size(), NULL );
+	arena.reserve( leafs.size() + newBranches.size() );
+	nameLeafCache.reserve( nameLeafCache.size() + leafs.size() );
+	nameBranchCache.reserve( nameBranchCache.size() + newBranches.size() );
+	for( size_t r = 0; r + 1 < runs.size(); ++r )
+	{
+		Tag *branch = createBranchPath( private_::getBranchPath( keys[ runs[r] ] ) );
+		for( size_t i = runs[r]; i < runs[r+1]; ++i )
+		{
+			const LeafDefinition &def = *keys[i].def;
+			Tag *leaf = placeTag( branch, def.fullPath, False );
+			leaf->setAccessRights( def.accessRights );
+			leaf->setScanRate( def.scanRate );
+			if( def.dataType != data_type::EMPTY )
+				leaf->setCanonicalDataType( def.dataType );
+			nameLeafCache.insert( leaf );
+			added[ keys[i].def - &leafs[0] ] = leaf;
+		}
+	}
+}
+
+void AddressSpace::addLeafs( const std::vector< LeafDefinition > &leafs )
+{
+	std::vector< Tag* > added;
+	addLeafs( leafs, added );
+}
+
+void AddressSpace::removeTag( const String &fullPath )
+{
+	FRL_EXCEPT_GUARD();
+	if( rootTag == NULL )
+		FRL_THROW_S_CLASS( NotFinalConstruct );
+	Update update( *this );
+	Tag *tag = findTag( fullPath );
+	if( tag == NULL || tag == rootTag )
+		FRL_THROW_S_CLASS( Tag::NotExistTag );
+	// everything which may throw is done before tree is changed
+	std::vector< Tag* > subtree( 1, tag );
+	for( size_t i = 0; i < subtree.size(); ++i )
+	{
+		const Tag::Children *children = subtree[i]->getChildren();
+		if( children != NULL )
+			subtree.insert( subtree.end(), children->begin(), children->end() );
+	}
+	removedTags.reserve( removedTags.size() + 1 );
+	Tag::Children &siblings = draftChildren( tag->getParent() );
+
+	siblings.erase( std::lower_bound( siblings.begin(), siblings.end(), tag, TagIDLess() ) );
+	removedTags.push_back( tag );
+	for( std::vector< Tag* >::iterator it = subtree.begin(); it != subtree.end(); ++it )
+	{
+		if( (*it)->is_Branch )
+			nameBranchCache.erase( (*it)->id );
+		else
+			nameLeafCache.erase( (*it)->id );
+		(*it)->attributesIndex.store( NULL, boost::memory_order_release );
+		attributes.remove( (*it)->handle );
+		handles.remove( (*it)->handle );
+		(*it)->releaseListeners();
+	}
+}
+
+void AddressSpace::checkMerge( const Tag *source ) const
+{
+	const Tag::Children *children = source->getChildren();
+	for( Tag::Children::const_iterator it = children->begin(); it != children->end(); ++it )
+	{
+		// tags of parts merged before are not published yet
+		if( nameLeafCache.isExist( (*it)->id ) )
+		{
+			if( (*it)->is_Branch )
+				FRL_THROW_S_CLASS( Tag::IsNotBranch );
+			FRL_THROW_S_CLASS( Tag::IsExistTag );
+		}
+		if( nameBranchCache.isExist( (*it)->id ) )
+		{
+			if( ! (*it)->is_Branch )
+				FRL_THROW_S_CLASS( Tag::IsExistTag );
+			checkMerge( *it );
+		}
+	}
+}
+
+void AddressSpace::moveChildren( Tag *target, Tag *source, std::vector< Tag* > &moved, std::vector< Tag* > &dropped )
+{
+	Tag::Children &children = *source->children.load( boost::memory_order_relaxed );
+	Tag::Children *own = NULL;
+	for( Tag::Children::iterator it = children.begin(); it != children.end(); ++it )
+	{
+		Tag *existing = (*it)->is_Branch ? nameBranchCache.find( (*it)->id ) : NULL;
+		if( existing != NULL )
+		{
+			moveChildren( existing, *it, moved, dropped );
+			dropped.push_back( *it );
+			continue;
+		}
+		if( own == NULL )
+			own = &draftChildren( target );
+		Tag::insertChild( *own, *it );
+		(*it)->setParent( target );
+		moved.push_back( *it );
+	}
+	children.clear();
+}
+
+void AddressSpace::merge( AddressSpace &part )
+{
+	FRL_EXCEPT_GUARD();
+	if( rootTag == NULL || part.rootTag == NULL )
+		FRL_THROW_S_CLASS( NotFinalConstruct );
+	if( &part == this )
+		return;
+	if( part.delimiter != delimiter )
+		FRL_THROW_S_CLASS( DifferentDelimiter );
+	Update update( *this );
+	checkMerge( part.rootTag );
+	nameLeafCache.reserve( nameLeafCache.size() + part.nameLeafCache.size() );
+	nameBranchCache.reserve( nameBranchCache.size() + part.nameBranchCache.size() );
+
+	// moved[i] are tops of moved subtrees, then their descendants
+	std::vector< Tag* > moved, dropped;
+	moveChildren( rootTag, part.rootTag, moved, dropped );
+	UInt version = current->getNumber() + 1;
+	for( size_t i = 0; i < moved.size(); ++i )
+	{
+		Tag *tag = moved[i];
+		const Tag::Children *children = tag->getChildren();
+		if( children != NULL )
+			moved.insert( moved.end(), children->begin(), children->end() );
+		tag->version = version;
+		tag->handle = handles.add( tag );
+		if( ! tag->is_Branch )
+		{
+			tag->attributesIndex.store( &attributes, boost::memory_order_release );
+			tag->updateAttributes();
+		}
+	}
+	// tags are not found by ID before they are published (see version)
+	nameLeafCache.insertAll( part.nameLeafCache );
+	nameBranchCache.insertAll( part.nameBranchCache );
+	part.nameLeafCache.clear();
+	part.nameBranchCache.clear();
+	part.handles.clear();
+	part.attributes.clear();
+	arena.adopt( part.arena );
+	// branches merged with existing ones, their children are moved
+	for( std::vector< Tag* >::iterator it = dropped.begin(); it != dropped.end(); ++it )
+	{
+		if( (*it)->in_arena )
+		{
+			(*it)->~Tag();
+			arena.deallocate( *it );
+		}
+		else
+			delete *it;
+	}
+}
+
+void AddressSpace::merge( const std::vector< AddressSpace* > &parts )
+{
+	for( std::vector< AddressSpace* >::const_iterator it = parts.begin(); it != parts.end(); ++it )
+		merge( **it );
+}
+
+TagHandle AddressSpace::getHandle( const Tag *tag ) const
+{
+	if( tag == NULL )
+		return TagHandle();
+	// slot of removed tag may belong to other tag already
+	TagHandle handle = handles.getHandle( tag->handle );
+	if( handles.find( handle ) != tag )
+		return TagHandle();
+	return handle;
+}
+
+Tag* AddressSpace::findTag( const TagHandle &handle ) const
+{
+	return handles.find( handle );
 }
 
 Tag* AddressSpace::getLeaf( const String& fullPath )
 {
 	if( fullPath.empty() )
 		FRL_THROW_S_CLASS( InvalidLeafName );
-	std::map< String, Tag*>::iterator it = nameLeafCache.find( fullPath );
-	if( it == nameLeafCache.end() )
+	Tag *tag = findLeaf( fullPath );
+	if( tag == NULL )
 		FRL_THROW_S_CLASS( Tag::NotExistTag );
-	return (*it).second;
+	return tag;
 }
 
-frl::Bool AddressSpace::isExistBranch( const String &name ) const
+frl::Bool AddressSpace::isExistBranch( const PathView &name ) const
 {
 	if( name.empty() )
 		return True; // root branch
-	if( nameBranchCache.find( name ) == nameBranchCache.end() )
-		return False;
-	return True;
+	return findBranch( name ) != NULL;
 }
 
-frl::Bool AddressSpace::isExistLeaf( const String &name ) const
+frl::Bool AddressSpace::isExistLeaf( const PathView &name ) const
 {
 	if( name.empty() )
 		return False;
-	if( nameLeafCache.find( name ) == nameLeafCache.end() )
-		return False;
-	return True;
+	return findLeaf( name ) != NULL;
 }
 
 Tag* AddressSpace::getTag( const String &fullPath )
 {
-	try
-	{
-		return getLeaf( fullPath );
-	}
-	catch( frl::Exception& ){}
-	return getBranch( fullPath );
+	Tag *tag = findTag( fullPath );
+	if( tag == NULL )
+		FRL_THROW_S_CLASS( Tag::NotExistTag );
+	return tag;
+}
+
+Tag* AddressSpace::findBranch( const PathView &fullPath ) const
+{
+	if( fullPath.empty() )
+		return rootTag;
+	Tag *tag = nameBranchCache.find( fullPath );
+	if( tag == NULL || ! isPublished( tag ) )
+		return NULL;
+	return tag;
+}
+
+Tag* AddressSpace::findLeaf( const PathView &fullPath ) const
+{
+	Tag *tag = nameLeafCache.find( fullPath );
+	if( tag == NULL || ! isPublished( tag ) )
+		return NULL;
+	return tag;
+}
+
+Tag* AddressSpace::findTag( const PathView &fullPath ) const
+{
+	Tag *tag = findLeaf( fullPath );
+	if( tag != NULL )
+		return tag;
+	return findBranch( fullPath );
 }
 
-Bool AddressSpace::isExistTag( const String &fullPath ) const
+Bool AddressSpace::isExistTag( const PathView &fullPath ) const
 {
 	if( isExistLeaf( fullPath ) || isExistBranch( fullPath) )
 		return True;
@@ -151,22 +607,83 @@ Tag* AddressSpace::getRootBranch()
 	return rootTag;
 }
 
-void AddressSpace::getAllLeafs( std::vector< String > &namesList, DWORD accessFilter ) const
+void AddressSpace::collectLeafs(	const std::vector< UInt > &slots, UInt accessFilter, DataType dataType,
+										UInt maxVersion, std::vector< String > &namesList ) const
+{
+	namesList.reserve( namesList.size() + slots.size() );
+	for( std::vector< UInt >::const_iterator it = slots.begin(); it != slots.end(); ++it )
+	{
+		// slot may be taken by other tag after index was read
+		const Tag *tag = handles.find( handles.getHandle( *it ) );
+		if( tag == NULL || tag->is_Branch || ! tag->isVisible( maxVersion )
+			|| ! tag->checkAccessRight( accessFilter )
+			|| ( dataType != data_type::EMPTY && tag->getCanonicalDataType() != dataType ) )
+			continue;
+		namesList.push_back( tag->getID() );
+	}
+}
+
+void AddressSpace::getAllLeafs( std::vector< String > &namesList, UInt accessFilter ) const
 {
 	namesList.clear();
-	namesList.reserve( nameLeafCache.size() );
-	std::map< String, Tag* >::const_iterator end = nameLeafCache.end();
-	for(	std::map< String, Tag* >::const_iterator it = nameLeafCache.begin();
-			it != end;
-			++it )
+	NamespaceVersionPtr version = getVersion();
+	if( rootTag == NULL )
+		return;
+	if( accessFilter != 0 )
 	{
-		if( accessFilter != 0 )
+		// sorting is cheaper than walk over whole tree if few leafs match
+		std::vector< UInt > slots;
+		attributes.find( accessFilter, data_type::EMPTY, slots );
+		if( slots.size() * 4 < attributes.size() )
 		{
-			if( !(*it).second->checkAccessRight( accessFilter ) )
-				continue;
+			collectLeafs( slots, accessFilter, data_type::EMPTY, version->getNumber(), namesList );
+			std::sort( namesList.begin(), namesList.end(), private_::TreeOrderLess( delimiter[0] ) );
+			return;
 		}
-		namesList.push_back( (*it).first );
 	}
+	namesList.reserve( nameLeafCache.size() );
+	rootTag->browseAllLeafs( namesList, accessFilter, version->getNumber() );
+}
+
+void AddressSpace::findLeafs( std::vector< String > &namesList, UInt accessFilter, DataType dataType ) const
+{
+	namesList.clear();
+	NamespaceVersionPtr version = getVersion();
+	std::vector< UInt > slots;
+	attributes.find( accessFilter, dataType, slots );
+	collectLeafs( slots, accessFilter, dataType, version->getNumber(), namesList );
+}
+
+void AddressSpace::getAllLeafs( std::vector< String > &namesList, const NamePattern &pattern, UInt accessFilter ) const
+{
+	namesList.clear();
+	NamespaceVersionPtr version = getVersion();
+	if( rootTag != NULL )
+		rootTag->browseAllLeafs( namesList, pattern, accessFilter, String(), 0, version->getNumber() );
+}
+
+void AddressSpace::getLeafsPage(	std::vector< String > &namesList,
+										const NamePattern &pattern,
+										UInt accessFilter,
+										const String &afterID,
+										size_t maxCount ) const
+{
+	namesList.clear();
+	NamespaceVersionPtr version = getVersion();
+	if( rootTag != NULL )
+		rootTag->browseAllLeafs( namesList, pattern, accessFilter, afterID, maxCount, version->getNumber() );
+}
+
+MemoryUsage AddressSpace::getMemoryUsage() const
+{
+	MemoryUsage usage;
+	NamespaceVersionPtr version = getVersion(); // arrays of children are not freed while walking
+	if( rootTag != NULL )
+		rootTag->getMemoryUsage( usage );
+	usage.tagsSize += arena.getAllocatedSize();
+	usage.indexesSize += nameLeafCache.getMemorySize() + nameBranchCache.getMemorySize()
+		+ handles.getMemorySize() + attributes.getMemorySize();
+	return usage;
 }
 
 frl::Bool AddressSpace::isInit() const
@@ -178,4 +695,3 @@ frl::Bool AddressSpace::isInit() const
 } // namespace opc
 } // FatRat Library
 
-#endif // FRL_PLATFORM_WIN32
@@ -0,0 +1,74 @@
+#include "opc/address_space/frl_opc_change_queue.h"
+
+namespace frl{ namespace opc{ namespace address_space{
+
+void ChangeQueue::push( UInt key )
+{
+	boost::mutex::scoped_lock guard_( guard );
+	keys.push_back( key );
+	if( keys.size() == 1 && wakeUp )
+		wakeUp();
+}
+
+void ChangeQueue::setWakeUp( const boost::function< void() > &wakeUp_ )
+{
+	boost::mutex::scoped_lock guard_( guard );
+	wakeUp = wakeUp_;
+}
+
+void ChangeQueue::take( std::vector< UInt > &changed )
+{
+	changed.clear();
+	boost::mutex::scoped_lock guard_( guard );
+	keys.swap( changed );
+}
+
+size_t ChangeQueue::size()
+{
+	boost::mutex::scoped_lock guard_( guard );
+	return keys.size();
+}
+
+QueuedTagListener::QueuedTagListener()
+	:	queue( NULL ),
+		key( 0 ),
+		dirty( False )
+{
+}
+
+QueuedTagListener::~QueuedTagListener()
+{
+	unsubscribe();
+}
+
+void QueuedTagListener::setQueue( ChangeQueue *queue_, UInt key_ )
+{
+	queue = queue_;
+	key = key_;
+	dirty.store( False );
+}
+
+void QueuedTagListener::markChanged()
+{
+	if( queue != NULL && ! dirty.exchange( True, boost::memory_order_acq_rel ) )
+		queue->push( key );
+}
+
+Bool QueuedTagListener::isDirty() const
+{
+	return dirty.load( boost::memory_order_acquire );
+}
+
+void QueuedTagListener::clearDirty()
+{
+	dirty.store( False, boost::memory_order_release );
+}
+
+void QueuedTagListener::onTagChange( const Tag* )
+{
+	markChanged();
+}
+
+} // namespace address_space
+} // namespace opc
+} // FatRat Library
@@ -0,0 +1,83 @@
+#include <cmath>
+#include "opc/address_space/frl_opc_deadband_filter.h"
+
+namespace frl{ namespace opc{ namespace address_space{
+
+const Double DeadbandFilter::noDeadband = -1.0;
+
+DeadbandFilter::DeadbandFilter()
+	:	checked( 0 ),
+		suppressed( 0 )
+{
+}
+
+Double DeadbandFilter::getThreshold( Float percent, Double lowEU, Double highEU )
+{
+	Double range = highEU - lowEU;
+	if( ! ( percent > 0 ) || ! ( range > 0 ) )
+		return noDeadband;
+	return range * percent / 100.0;
+}
+
+void DeadbandFilter::clear()
+{
+	sent.clear();
+	current.clear();
+	threshold.clear();
+	passed.clear();
+}
+
+size_t DeadbandFilter::add( Double sentValue, Double currentValue, Double threshold_ )
+{
+	sent.push_back( sentValue );
+	current.push_back( currentValue );
+	threshold.push_back( threshold_ );
+	return sent.size() - 1;
+}
+
+void DeadbandFilter::run()
+{
+	size_t count = sent.size();
+	passed.resize( count );
+	if( count == 0 )
+		return;
+	const Double *sentValues = &sent[0];
+	const Double *currentValues = &current[0];
+	const Double *thresholds = &threshold[0];
+	UChar *result = &passed[0];
+	size_t sentNumber = 0;
+	// no branches in loop, so compiler vectorizes it
+	for( size_t i = 0; i < count; ++i )
+	{
+		// NaN is not in deadband
+		UChar pass = ! ( std::fabs( currentValues[i] - sentValues[i] ) <= thresholds[i] );
+		result[i] = pass;
+		sentNumber += pass;
+	}
+	checked += count;
+	suppressed += count - sentNumber;
+}
+
+Bool DeadbandFilter::isPassed( size_t index ) const
+{
+	return passed[index] != 0;
+}
+
+size_t DeadbandFilter::size() const
+{
+	return sent.size();
+}
+
+ULong DeadbandFilter::getChecked() const
+{
+	return checked;
+}
+
+ULong DeadbandFilter::getSuppressed() const
+{
+	return suppressed;
+}
+
+} // namespace address_space
+} // namespace opc
+} // FatRat Library
@@ -0,0 +1,71 @@
+#include <algorithm>
+#include "opc/address_space/frl_opc_leaf_enumerator.h"
+#include "opc/address_space/frl_opc_address_space.h"
+
+namespace frl{ namespace opc{ namespace address_space{
+
+LeafEnumerator::LeafEnumerator(	const AddressSpace &space_,
+										const NamePattern &pattern_,
+										UInt accessFilter_,
+										size_t chunkSize_ )
+	:	space( &space_ ),
+		pattern( pattern_ ),
+		accessFilter( accessFilter_ ),
+		chunkSize( chunkSize_ == 0 ? defaultLeafsChunk : chunkSize_ ),
+		chunkPos( 0 ),
+		finished( False )
+{
+}
+
+Bool LeafEnumerator::fill()
+{
+	if( chunkPos < chunk.size() )
+		return True;
+	if( finished )
+		return False;
+	// continue after the last leaf of previous chunk
+	String afterID;
+	if( ! chunk.empty() )
+		afterID.swap( chunk.back() );
+	space->getLeafsPage( chunk, pattern, accessFilter, afterID, chunkSize );
+	chunkPos = 0;
+	if( chunk.size() < chunkSize )
+		finished = True;
+	return ! chunk.empty();
+}
+
+Bool LeafEnumerator::next( String &id )
+{
+	if( ! fill() )
+		return False;
+	id = chunk[chunkPos++];
+	return True;
+}
+
+Bool LeafEnumerator::hasNext()
+{
+	return fill();
+}
+
+size_t LeafEnumerator::skip( size_t count )
+{
+	size_t skipped = 0;
+	while( skipped < count && fill() )
+	{
+		size_t step = std::min( count - skipped, chunk.size() - chunkPos );
+		chunkPos += step;
+		skipped += step;
+	}
+	return skipped;
+}
+
+void LeafEnumerator::reset()
+{
+	chunk.clear();
+	chunkPos = 0;
+	finished = False;
+}
+
+} // namespace address_space
+} // namespace opc
+} // FatRat Library
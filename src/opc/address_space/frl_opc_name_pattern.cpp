@@ -0,0 +1,210 @@
+#include <cctype>
+#include <cwctype>
+#include "opc/address_space/frl_opc_name_pattern.h"
+
+namespace frl{ namespace opc{ namespace address_space{
+
+namespace private_
+{
+	inline char toLower( char symbol )
+	{
+		return (char)std::tolower( (unsigned char)symbol );
+	}
+
+	inline wchar_t toLower( wchar_t symbol )
+	{
+		return (wchar_t)std::towlower( (std::wint_t)symbol );
+	}
+} // namespace private_
+
+NamePattern::NamePattern()
+	:	tailBegin( 0 ),
+		caseSensitive( True )
+{
+}
+
+NamePattern::NamePattern( const String &pattern, Bool caseSensitive_ )
+	:	tailBegin( 0 ),
+		caseSensitive( caseSensitive_ )
+{
+	compile( pattern );
+}
+
+void NamePattern::compile( const String &pattern )
+{
+	Bool literalPrefix = caseSensitive;
+	for( size_t pos = 0; pos < pattern.size(); )
+	{
+		Op op;
+		op.type = LITERAL;
+		op.symbol = pattern[pos++];
+		op.negate = False;
+		op.setBegin = op.setEnd = 0;
+		switch( op.symbol )
+		{
+		case FRL_STR('*'):
+			op.type = ANY_STRING;
+			// "**" is the same as "*"
+			if( ! program.empty() && program.back().type == ANY_STRING )
+				continue;
+			break;
+
+		case FRL_STR('?'):
+			op.type = ANY_CHAR;
+			break;
+
+		case FRL_STR('#'):
+			op.type = DIGIT;
+			break;
+
+		case FRL_STR('['):
+		{
+			size_t end = pattern.find( FRL_STR(']'), pos );
+			if( end == String::npos || end == pos )
+				break; // not a set, '[' is literal
+			op.type = CHAR_SET;
+			if( pattern[pos] == FRL_STR('!') && end > pos + 1 )
+			{
+				op.negate = True;
+				++pos;
+			}
+			op.setBegin = ranges.size();
+			for( ; pos < end; ++pos )
+			{
+				Char low = pattern[pos];
+				Char high = low;
+				if( pos + 2 < end && pattern[pos+1] == FRL_STR('-') )
+				{
+					high = pattern[pos+2];
+					pos += 2;
+				}
+				if( ! caseSensitive )
+				{
+					low = private_::toLower( low );
+					high = private_::toLower( high );
+				}
+				ranges.push_back( std::make_pair( low, high ) );
+			}
+			op.setEnd = ranges.size();
+			pos = end + 1;
+			break;
+		}
+		}
+		if( op.type == LITERAL && ! caseSensitive )
+			op.symbol = private_::toLower( op.symbol );
+		if( op.type != LITERAL )
+			literalPrefix = False;
+		if( literalPrefix )
+			prefix += op.symbol;
+		program.push_back( op );
+		if( op.type == ANY_STRING )
+			tailBegin = program.size();
+	}
+}
+
+Bool NamePattern::isMatchAll() const
+{
+	return program.empty() || ( program.size() == 1 && program[0].type == ANY_STRING );
+}
+
+const String& NamePattern::getPrefix() const
+{
+	return prefix;
+}
+
+Bool NamePattern::matchOne( const Op &op, Char symbol ) const
+{
+	switch( op.type )
+	{
+	case LITERAL:
+		return op.symbol == ( caseSensitive ? symbol : private_::toLower( symbol ) );
+
+	case ANY_CHAR:
+		return True;
+
+	case DIGIT:
+		return symbol >= FRL_STR('0') && symbol <= FRL_STR('9');
+
+	case CHAR_SET:
+	{
+		if( ! caseSensitive )
+			symbol = private_::toLower( symbol );
+		Bool found = False;
+		for( size_t i = op.setBegin; i < op.setEnd && ! found; ++i )
+			found = ( symbol >= ranges[i].first && symbol <= ranges[i].second );
+		return found != op.negate;
+	}
+
+	default:
+		return False;
+	}
+}
+
+Bool NamePattern::match( const PathView &str ) const
+{
+	if( program.empty() )
+		return True;
+	if( tailBegin != 0 )
+	{
+		// every op after the last "*" matches exactly one char at end of name
+		size_t tailLength = program.size() - tailBegin;
+		if( str.size() < tailLength )
+			return False;
+		const Char *tail = str.data() + str.size() - tailLength;
+		for( size_t i = 0; i < tailLength; ++i )
+		{
+			if( ! matchOne( program[tailBegin + i], tail[i] ) )
+				return False;
+		}
+	}
+	return run( str, False );
+}
+
+Bool NamePattern::matchBeginning( const PathView &str ) const
+{
+	if( program.empty() )
+		return True;
+	return run( str, True );
+}
+
+Bool NamePattern::run( const PathView &str, Bool partial ) const
+{
+	// "*" consumes as few chars as possible, on mismatch
+	// the last "*" takes one more char
+	size_t s = 0, p = 0;
+	size_t starP = String::npos, starS = 0;
+	while( s < str.size() )
+	{
+		if( p < program.size() && program[p].type == ANY_STRING )
+		{
+			starP = p++;
+			starS = s;
+		}
+		else if( p < program.size() && matchOne( program[p], str[s] ) )
+		{
+			++p;
+			++s;
+		}
+		else if( starP != String::npos )
+		{
+			p = starP + 1;
+			s = ++starS;
+		}
+		else
+			return False;
+	}
+	if( partial )
+		return True; // rest of pattern can match continuation of str
+	while( p < program.size() && program[p].type == ANY_STRING )
+		++p;
+	return p == program.size();
+}
+
+Bool NamePattern::operator()( const String &str ) const
+{
+	return match( str );
+}
+
+} // namespace address_space
+} // namespace opc
+} // FatRat Library
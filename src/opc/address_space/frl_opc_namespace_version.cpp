@@ -0,0 +1,59 @@
+#include "opc/address_space/frl_opc_namespace_version.h"
+#include "opc/address_space/frl_opc_tag.h"
+#include "opc/address_space/frl_opc_tag_arena.h"
+
+namespace frl{ namespace opc{ namespace address_space{
+
+NamespaceVersion::NamespaceVersion( UInt number_, TagArena *arena_ )
+	:	number( number_ ), arena( arena_ )
+{
+}
+
+NamespaceVersion::~NamespaceVersion()
+{
+	for( size_t i = 0; i < retired.size(); ++i )
+		delete retired[i];
+	for( size_t i = 0; i < removed.size(); ++i )
+		disposeTag( removed[i], arena );
+	for( size_t i = 0; i < replacedTables.size(); ++i )
+		delete replacedTables[i];
+	// chain of old versions may be long (reader held version during many
+	// reconfigurations), so it is released in loop instead of recursion;
+	// nobody can take version which is not current, so unique one is free
+	boost::shared_ptr< NamespaceVersion > tail;
+	tail.swap( next );
+	while( tail && tail.unique() )
+	{
+		boost::shared_ptr< NamespaceVersion > following;
+		following.swap( tail->next );
+		tail.swap( following );
+	}
+}
+
+void NamespaceVersion::disposeTag( Tag *tag, TagArena *arena )
+{
+	// children are disposed here, so destructor of tag finds empty array
+	Tag::Children *children = tag->children.load( boost::memory_order_relaxed );
+	if( children != NULL )
+	{
+		for( Tag::Children::iterator it = children->begin(); it != children->end(); ++it )
+			disposeTag( *it, arena );
+		children->clear();
+	}
+	if( tag->in_arena )
+	{
+		tag->~Tag();
+		arena->deallocate( tag );
+	}
+	else
+		delete tag;
+}
+
+UInt NamespaceVersion::getNumber() const
+{
+	return number;
+}
+
+} // namespace address_space
+} // namespace opc
+} // FatRat Library
@@ -0,0 +1,167 @@
+#include <algorithm>
+#include "opc/address_space/frl_opc_path_view.h"
+
+namespace frl{ namespace opc{ namespace address_space{
+
+PathView::PathView()
+	:	first( NULL ), length( 0 )
+{
+}
+
+PathView::PathView( const String &str )
+	:	first( str.data() ), length( str.size() )
+{
+}
+
+PathView::PathView( const Char *str )
+	:	first( str ), length( std::char_traits< Char >::length( str ) )
+{
+}
+
+PathView::PathView( const Char *str, size_t length_ )
+	:	first( str ), length( length_ )
+{
+}
+
+const Char* PathView::data() const
+{
+	return first;
+}
+
+size_t PathView::size() const
+{
+	return length;
+}
+
+Bool PathView::empty() const
+{
+	return length == 0;
+}
+
+Char PathView::operator[]( size_t pos ) const
+{
+	return first[pos];
+}
+
+PathView PathView::prefix( size_t length_ ) const
+{
+	return PathView( first, std::min( length, length_ ) );
+}
+
+PathView PathView::suffix( size_t pos ) const
+{
+	if( pos >= length )
+		return PathView( first + length, 0 );
+	return PathView( first + pos, length - pos );
+}
+
+size_t PathView::find( Char symbol, size_t from ) const
+{
+	if( from >= length )
+		return String::npos;
+	const Char *found = std::char_traits< Char >::find( first + from, length - from, symbol );
+	return found == NULL ? String::npos : found - first;
+}
+
+size_t PathView::rfind( Char symbol ) const
+{
+	for( size_t i = length; i > 0; --i )
+	{
+		if( first[i - 1] == symbol )
+			return i - 1;
+	}
+	return String::npos;
+}
+
+Bool PathView::startsWith( const PathView &other ) const
+{
+	return other.length <= length
+		&& std::char_traits< Char >::compare( first, other.first, other.length ) == 0;
+}
+
+int PathView::compare( const PathView &other ) const
+{
+	int ret = std::char_traits< Char >::compare( first, other.first, std::min( length, other.length ) );
+	if( ret != 0 )
+		return ret;
+	return length < other.length ? -1 : ( length > other.length ? 1 : 0 );
+}
+
+Bool PathView::operator == ( const PathView &other ) const
+{
+	return length == other.length && compare( other ) == 0;
+}
+
+Bool PathView::operator != ( const PathView &other ) const
+{
+	return ! ( *this == other );
+}
+
+Bool PathView::operator < ( const PathView &other ) const
+{
+	return compare( other ) < 0;
+}
+
+String PathView::toString() const
+{
+	return String( first, length );
+}
+
+PathView PathView::getParent( Char delimiter ) const
+{
+	size_t pos = rfind( delimiter );
+	return pos == String::npos ? PathView( first, 0 ) : prefix( pos );
+}
+
+PathView PathView::getShortName( Char delimiter ) const
+{
+	size_t pos = rfind( delimiter );
+	return pos == String::npos ? *this : suffix( pos + 1 );
+}
+
+Bool PathView::isValid( Char delimiter ) const
+{
+	if( length == 0 || first[0] == delimiter || first[length - 1] == delimiter )
+		return False;
+	for( size_t i = 1; i < length; ++i )
+	{
+		if( first[i] == delimiter && first[i - 1] == delimiter )
+			return False;
+	}
+	return True;
+}
+
+PathTokenizer::PathTokenizer( const PathView &path_, Char delimiter_ )
+	:	path( path_ ),
+		delimiter( delimiter_ ),
+		pos( path_.empty() ? String::npos : 0 ),
+		walked( 0 )
+{
+}
+
+Bool PathTokenizer::next( PathView &segment )
+{
+	if( pos == String::npos )
+		return False;
+	size_t end = path.find( delimiter, pos );
+	if( end == String::npos )
+		end = path.size();
+	segment = PathView( path.data() + pos, end - pos );
+	walked = end;
+	pos = ( end == path.size() ) ? String::npos : end + 1;
+	return True;
+}
+
+PathView PathTokenizer::getWalked() const
+{
+	return path.prefix( walked );
+}
+
+Bool PathTokenizer::isLast() const
+{
+	return pos == String::npos;
+}
+
+} // namespace address_space
+} // namespace opc
+} // FatRat Library
@@ -0,0 +1,250 @@
+#include <algorithm>
+#include <boost/bind.hpp>
+#include <boost/chrono/system_clocks.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include "opc/address_space/frl_opc_sampling_scheduler.h"
+#include "opc/address_space/frl_opc_address_space.h"
+
+namespace frl{ namespace opc{ namespace address_space{
+
+namespace private_
+{
+	const size_t wheelSlots = 256;
+} // namespace private_
+
+SamplingDriver::~SamplingDriver()
+{
+}
+
+SamplingScheduler::SamplingScheduler( AddressSpace &space_, UInt tick_, UInt defaultRate_ )
+	:	space( space_ ),
+		tick( tick_ == 0 ? 1 : tick_ ),
+		defaultRate( defaultRate_ ),
+		demandDriven( False ),
+		idleRate( 0 ),
+		slots( private_::wheelSlots ),
+		currentTick( 0 ),
+		stopped( True )
+{
+}
+
+SamplingScheduler::~SamplingScheduler()
+{
+	stop();
+	for( Batches::iterator it = batches.begin(); it != batches.end(); ++it )
+		delete it->second;
+}
+
+UInt SamplingScheduler::getRate( Tag *tag ) const
+{
+	UInt rate = tag->getScanRate();
+	if( rate == 0 )
+		rate = defaultRate;
+	rate = ( rate + tick - 1 ) / tick;
+	return rate == 0 ? 1 : rate;
+}
+
+SamplingScheduler::Batch* SamplingScheduler::getBatch( SamplingDriver *driver, UInt rate )
+{
+	Batches::iterator it = batches.lower_bound( std::make_pair( driver, rate ) );
+	if( it != batches.end() && it->first == std::make_pair( driver, rate ) )
+		return it->second;
+	Batch *batch = new Batch();
+	batch->driver = driver;
+	batch->rate = rate;
+	batch->due = currentTick + 1;
+	batch->visits = 0;
+	try
+	{
+		// place in slot is reserved, so batch is not lost after insertion
+		slots[ batch->due % slots.size() ].reserve( slots[ batch->due % slots.size() ].size() + 1 );
+		batches.insert( it, std::make_pair( std::make_pair( driver, rate ), batch ) );
+	}
+	catch( ... )
+	{
+		delete batch;
+		throw;
+	}
+	schedule( batch );
+	return batch;
+}
+
+void SamplingScheduler::schedule( Batch *batch )
+{
+	slots[ batch->due % slots.size() ].push_back( batch );
+}
+
+void SamplingScheduler::add( Tag *tag, SamplingDriver *driver )
+{
+	boost::mutex::scoped_lock lock( guard );
+	TagHandle handle = space.getHandle( tag );
+	if( handle.isNull() )
+		return; // tag is not in address space
+	getBatch( driver, getRate( tag ) )->tags.push_back( handle );
+}
+
+void SamplingScheduler::remove( Tag *tag, SamplingDriver *driver )
+{
+	boost::mutex::scoped_lock lock( guard );
+	TagHandle handle = space.getHandle( tag );
+	// rate of tag may be changed after it was added
+	Batches::iterator it = batches.lower_bound( std::make_pair( driver, (UInt)0 ) );
+	for( ; it != batches.end() && it->first.first == driver; ++it )
+	{
+		std::vector< TagHandle > &tags = it->second->tags;
+		std::vector< TagHandle >::iterator pos = std::find( tags.begin(), tags.end(), handle );
+		if( pos != tags.end() )
+		{
+			*pos = tags.back();
+			tags.pop_back();
+			return;
+		}
+	}
+}
+
+void SamplingScheduler::remove( SamplingDriver *driver )
+{
+	boost::mutex::scoped_lock sampling( sampleGuard );
+	boost::mutex::scoped_lock lock( guard );
+	calls.erase( driver );
+	// empty batches leave wheel when they are due
+	Batches::iterator it = batches.lower_bound( std::make_pair( driver, (UInt)0 ) );
+	for( ; it != batches.end() && it->first.first == driver; ++it )
+		it->second->tags.clear();
+}
+
+void SamplingScheduler::collect( Batch *batch, ULong now, std::vector< std::pair< SamplingDriver*, TagHandle > > &moved )
+{
+	std::vector< Tag* > &due = calls[ batch->driver ];
+	// tags without demand are sampled every idleEvery sample of batch
+	UInt idleEvery = ( idleRate + batch->rate - 1 ) / batch->rate;
+	Bool idleDue = ! demandDriven || ( idleEvery != 0 && batch->visits % idleEvery == 0 );
+	++batch->visits;
+	size_t kept = 0;
+	for( size_t i = 0; i < batch->tags.size(); ++i )
+	{
+		Tag *tag = space.findTag( batch->tags[i] );
+		if( tag == NULL )
+			continue; // removed from address space
+		if( getRate( tag ) != batch->rate )
+		{
+			moved.push_back( std::make_pair( batch->driver, batch->tags[i] ) );
+			continue;
+		}
+		batch->tags[kept++] = batch->tags[i];
+		if( idleDue || tag->isDemanded() )
+			due.push_back( tag );
+	}
+	batch->tags.resize( kept );
+	// missed samples are skipped, otherwise phase of batch is kept
+	batch->due += batch->rate;
+	if( batch->due <= now )
+		batch->due = now + batch->rate;
+}
+
+void SamplingScheduler::process( ULong now )
+{
+	boost::mutex::scoped_lock sampling( sampleGuard );
+	// tags found by handles stay allocated while drivers sample them
+	NamespaceVersionPtr version = space.getVersion();
+	{
+		boost::mutex::scoped_lock lock( guard );
+		ULong target = now / tick;
+		if( target <= currentTick )
+			return;
+		for( Calls::iterator it = calls.begin(); it != calls.end(); ++it )
+			it->second.clear();
+		std::vector< std::pair< SamplingDriver*, TagHandle > > moved;
+		// after long pause every slot is visited once
+		ULong last = std::min( target, currentTick + (ULong)slots.size() );
+		for( ULong t = currentTick + 1; t <= last; ++t )
+		{
+			pending.clear();
+			pending.swap( slots[ t % slots.size() ] );
+			for( std::vector< Batch* >::iterator it = pending.begin(); it != pending.end(); ++it )
+			{
+				Batch *batch = *it;
+				if( batch->due > target )
+				{
+					schedule( batch ); // due in one of next turns of wheel
+					continue;
+				}
+				if( ! batch->tags.empty() )
+					collect( batch, target, moved );
+				if( batch->tags.empty() )
+				{
+					batches.erase( std::make_pair( batch->driver, batch->rate ) );
+					delete batch;
+				}
+				else
+					schedule( batch );
+			}
+		}
+		currentTick = target;
+		for( size_t i = 0; i < moved.size(); ++i )
+		{
+			Tag *tag = space.findTag( moved[i].second );
+			if( tag != NULL )
+				getBatch( moved[i].first, getRate( tag ) )->tags.push_back( moved[i].second );
+		}
+	}
+	for( Calls::iterator it = calls.begin(); it != calls.end(); ++it )
+	{
+		if( ! it->second.empty() )
+			it->first->sample( it->second );
+	}
+}
+
+void SamplingScheduler::setDemandDriven( Bool demandDriven_, UInt idleRate_ )
+{
+	boost::mutex::scoped_lock lock( guard );
+	demandDriven = demandDriven_;
+	idleRate = ( idleRate_ + tick - 1 ) / tick;
+}
+
+void SamplingScheduler::run()
+{
+	// monotonic clock, setting of system time does not shift sampling
+	boost::chrono::steady_clock::time_point begin = boost::chrono::steady_clock::now();
+	boost::mutex::scoped_lock lock( stopGuard );
+	while( ! stopped )
+	{
+		lock.unlock();
+		boost::chrono::milliseconds elapsed = boost::chrono::duration_cast< boost::chrono::milliseconds >( boost::chrono::steady_clock::now() - begin );
+		process( elapsed.count() > 0 ? (ULong)elapsed.count() : 0 );
+		lock.lock();
+		if( ! stopped )
+			stopCondition.timed_wait( lock, boost::posix_time::milliseconds( tick ) );
+	}
+}
+
+void SamplingScheduler::start()
+{
+	boost::mutex::scoped_lock lock( stopGuard );
+	if( ! stopped )
+		return;
+	stopped = False;
+	worker = boost::thread( boost::bind( &SamplingScheduler::run, this ) );
+}
+
+void SamplingScheduler::stop()
+{
+	{
+		boost::mutex::scoped_lock lock( stopGuard );
+		if( stopped )
+			return;
+		stopped = True;
+		stopCondition.notify_all();
+	}
+	worker.join();
+}
+
+size_t SamplingScheduler::getBatchesNumber()
+{
+	boost::mutex::scoped_lock lock( guard );
+	return batches.size();
+}
+
+} // namespace address_space
+} // namespace opc
+} // FatRat Library
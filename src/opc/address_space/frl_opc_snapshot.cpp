@@ -0,0 +1,258 @@
+#include <cstring>
+#include <fstream>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include "opc/address_space/frl_opc_address_space.h"
+#include "frl_string.h"
+
+namespace frl{ namespace opc{ namespace address_space{
+
+namespace private_
+{
+	const snapshot::Record* getRecords( const char *image )
+	{
+		return reinterpret_cast< const snapshot::Record* >( image + sizeof( snapshot::Header ) );
+	}
+
+	const Char* getPool( const char *image, UInt tagsNumber )
+	{
+		return reinterpret_cast< const Char* >( image + sizeof( snapshot::Header )
+			+ (size_t)tagsNumber * sizeof( snapshot::Record ) );
+	}
+
+	Bool isLess( const Char *lhv, UInt lhvLength, const Char *rhv, UInt rhvLength )
+	{
+		int ret = std::char_traits< Char >::compare( lhv, rhv, std::min( lhvLength, rhvLength ) );
+		return ret < 0 || ( ret == 0 && lhvLength < rhvLength );
+	}
+} // namespace private_
+
+void AddressSpace::saveTag(	const Tag *tag, UInt parent, UInt maxVersion,
+									std::vector< snapshot::Record > &records, String &pool ) const
+{
+	snapshot::Record record;
+	std::memset( &record, 0, sizeof( record ) );
+	record.parent = parent;
+	record.idOffset = (UInt)pool.size();
+	record.idLength = (UInt)tag->id.size();
+	pool += tag->id;
+	record.accessRights = tag->accessRights;
+	record.scanRate = tag->scanRate;
+	record.requestedDataType = tag->requestedDataType;
+	if( tag->is_Branch )
+		record.flags = snapshot::branchFlag;
+	if( tag->isAnalog() )
+	{
+		record.flags |= snapshot::analogFlag;
+		record.lowEU = tag->getLowEU();
+		record.highEU = tag->getHighEU();
+	}
+	Value val;
+	TimeStamp ts;
+	tag->value.read( val, record.quality, ts );
+	record.valueType = val.getType();
+	record.timeStamp = ts.getTicks();
+	if( record.valueType == data_type::STRING )
+	{
+		String str = val;
+		record.strOffset = (UInt)pool.size();
+		record.strLength = (UInt)str.size();
+		pool += str;
+	}
+	else
+		record.data = val.getRawData();
+	UInt index = (UInt)records.size();
+	records.push_back( record );
+	const Tag::Children *children = tag->getChildren();
+	if( children == NULL )
+		return;
+	for( Tag::Children::const_iterator it = children->begin(); it != children->end(); ++it )
+	{
+		if( (*it)->isVisible( maxVersion ) )
+			saveTag( *it, index, maxVersion, records, pool );
+	}
+}
+
+void AddressSpace::saveSnapshot( std::vector< char > &image ) const
+{
+	FRL_EXCEPT_GUARD();
+	if( ! init )
+		FRL_THROW_S_CLASS( NotFinalConstruct );
+	std::vector< snapshot::Record > records;
+	records.reserve( nameLeafCache.size() + nameBranchCache.size() );
+	String pool;
+	// image of one version, reconfiguration may go on meanwhile
+	NamespaceVersionPtr version = getVersion();
+	const Tag::Children *children = rootTag->getChildren();
+	for( Tag::Children::const_iterator it = children->begin(); it != children->end(); ++it )
+	{
+		if( (*it)->isVisible( version->getNumber() ) )
+			saveTag( *it, snapshot::noParent, version->getNumber(), records, pool );
+	}
+
+	snapshot::Header header;
+	std::memset( &header, 0, sizeof( header ) );
+	header.signature = snapshot::signature;
+	header.version = snapshot::version;
+	header.charSize = sizeof( Char );
+	header.delimiter = (UInt)delimiter[0];
+	header.tagsNumber = (UInt)records.size();
+	header.recordSize = sizeof( snapshot::Record );
+	header.stringsSize = pool.size();
+
+	size_t recordsSize = records.size() * sizeof( snapshot::Record );
+	image.resize( sizeof( header ) + recordsSize + pool.size() * sizeof( Char ) );
+	std::memcpy( &image[0], &header, sizeof( header ) );
+	if( ! records.empty() )
+		std::memcpy( &image[ sizeof( header ) ], &records[0], recordsSize );
+	if( ! pool.empty() )
+		std::memcpy( &image[ sizeof( header ) + recordsSize ], pool.data(), pool.size() * sizeof( Char ) );
+}
+
+void AddressSpace::saveSnapshot( const String &fileName ) const
+{
+	FRL_EXCEPT_GUARD();
+	std::vector< char > image;
+	saveSnapshot( image );
+	std::ofstream out( multiByteCompatibility( fileName ).c_str(), std::ios::binary | std::ios::trunc );
+	if( ! out.write( &image[0], (std::streamsize)image.size() ) || ! out.flush() )
+		FRL_THROW_S_CLASS( SnapshotFileError );
+}
+
+void AddressSpace::checkSnapshot( const char *image, size_t size ) const
+{
+	if( image == NULL || size < sizeof( snapshot::Header ) )
+		FRL_THROW_S_CLASS( InvalidSnapshot );
+	const snapshot::Header *header = reinterpret_cast< const snapshot::Header* >( image );
+	if( header->signature != snapshot::signature
+		|| header->version != snapshot::version
+		|| header->charSize != sizeof( Char )
+		|| header->recordSize != sizeof( snapshot::Record )
+		|| ( init && (UInt)delimiter[0] != header->delimiter ) )
+		FRL_THROW_S_CLASS( InvalidSnapshot );
+	ULong recordsSize = (ULong)header->tagsNumber * sizeof( snapshot::Record );
+	if( size != sizeof( snapshot::Header ) + recordsSize + header->stringsSize * sizeof( Char ) )
+		FRL_THROW_S_CLASS( InvalidSnapshot );
+
+	const snapshot::Record *records = private_::getRecords( image );
+	const Char *pool = private_::getPool( image, header->tagsNumber );
+	const Char delim = (Char)header->delimiter;
+	// last child of every branch (index + 1, 0 - none), for root - last element
+	std::vector< UInt > lastChild( header->tagsNumber + 1, 0 );
+	for( UInt i = 0; i < header->tagsNumber; ++i )
+	{
+		const snapshot::Record &rec = records[i];
+		if( rec.idLength == 0
+			|| (ULong)rec.idOffset + rec.idLength > header->stringsSize
+			|| (ULong)rec.strOffset + rec.strLength > header->stringsSize )
+			FRL_THROW_S_CLASS( InvalidSnapshot );
+		// value of leaf is raw data of scalar or string of pool,
+		// value of branch is not loaded and branch is not analog
+		Bool isBranch = ( rec.flags & snapshot::branchFlag ) != 0;
+		if( ( isBranch && ( rec.flags & snapshot::analogFlag ) != 0 )
+			|| ( ! isBranch && ( ! Value::isValidType( rec.valueType ) || rec.valueType == data_type::ARRAY ) )
+			|| ( rec.valueType != data_type::STRING && ( rec.strOffset != 0 || rec.strLength != 0 ) ) )
+			FRL_THROW_S_CLASS( InvalidSnapshot );
+		const Char *id = pool + rec.idOffset;
+		// ID is ID of parent, delimiter and short name without delimiters
+		size_t shortPos = 0;
+		if( rec.parent != snapshot::noParent )
+		{
+			if( rec.parent >= i || ( records[rec.parent].flags & snapshot::branchFlag ) == 0 )
+				FRL_THROW_S_CLASS( InvalidSnapshot );
+			const snapshot::Record &parent = records[rec.parent];
+			shortPos = parent.idLength + 1;
+			if( rec.idLength <= shortPos
+				|| std::char_traits< Char >::compare( id, pool + parent.idOffset, parent.idLength ) != 0
+				|| id[parent.idLength] != delim )
+				FRL_THROW_S_CLASS( InvalidSnapshot );
+		}
+		if( std::char_traits< Char >::find( id + shortPos, rec.idLength - shortPos, delim ) != NULL )
+			FRL_THROW_S_CLASS( InvalidSnapshot );
+		// children strictly ordered, so there are no duplicates
+		UInt &last = lastChild[ rec.parent == snapshot::noParent ? header->tagsNumber : rec.parent ];
+		if( last != 0 )
+		{
+			const snapshot::Record &prev = records[last - 1];
+			if( ! private_::isLess( pool + prev.idOffset, prev.idLength, id, rec.idLength ) )
+				FRL_THROW_S_CLASS( InvalidSnapshot );
+		}
+		last = i + 1;
+	}
+}
+
+void AddressSpace::loadSnapshot( const char *image, size_t size )
+{
+	FRL_EXCEPT_GUARD();
+	checkSnapshot( image, size );
+	const snapshot::Header *header = reinterpret_cast< const snapshot::Header* >( image );
+	if( ! init )
+		finalConstruct( String( 1, (Char)header->delimiter ) );
+	Update update( *this );
+	if( ! rootTag->getChildren()->empty() )
+		FRL_THROW_S_CLASS( IsNotEmpty );
+
+	const snapshot::Record *records = private_::getRecords( image );
+	const Char *pool = private_::getPool( image, header->tagsNumber );
+	arena.reserve( header->tagsNumber );
+	std::vector< Tag* > tags( header->tagsNumber );
+	size_t branches = 0;
+	for( UInt i = 0; i < header->tagsNumber; ++i )
+		branches += ( records[i].flags & snapshot::branchFlag ) != 0;
+	nameBranchCache.reserve( nameBranchCache.size() + branches );
+	nameLeafCache.reserve( nameLeafCache.size() + header->tagsNumber - branches );
+
+	Value val;
+	for( UInt i = 0; i < header->tagsNumber; ++i )
+	{
+		const snapshot::Record &rec = records[i];
+		Bool isBranch = ( rec.flags & snapshot::branchFlag ) != 0;
+		Tag *parent = ( rec.parent == snapshot::noParent ) ? rootTag : tags[rec.parent];
+		// children go in ID order, so every one is appended in constant time
+		Tag *tag = placeTag( parent, String( pool + rec.idOffset, rec.idLength ), isBranch );
+		tags[i] = tag;
+		tag->accessRights = rec.accessRights;
+		tag->scanRate = rec.scanRate;
+		tag->requestedDataType = rec.requestedDataType;
+		if( isBranch )
+		{
+			nameBranchCache.insert( tag );
+		}
+		else
+		{
+			if( rec.valueType == data_type::STRING )
+				val = Value( String( pool + rec.strOffset, rec.strLength ) );
+			else
+				val.setRawData( rec.valueType, rec.data );
+			tag->value.write( val, TimeStamp( rec.timeStamp ) );
+			tag->value.setTimeStamp( TimeStamp( rec.timeStamp ) );
+			tag->value.setQuality( rec.quality );
+			if( rec.flags & snapshot::analogFlag )
+				tag->setEURange( rec.lowEU, rec.highEU );
+			tag->updateAttributes();
+			nameLeafCache.insert( tag );
+		}
+	}
+}
+
+void AddressSpace::loadSnapshot( const String &fileName )
+{
+	FRL_EXCEPT_GUARD();
+	using namespace boost::interprocess;
+	file_mapping file;
+	mapped_region region;
+	try
+	{
+		file_mapping( multiByteCompatibility( fileName ).c_str(), read_only ).swap( file );
+		mapped_region( file, read_only ).swap( region );
+	}
+	catch( interprocess_exception& )
+	{
+		FRL_THROW_S_CLASS( SnapshotFileError );
+	}
+	loadSnapshot( static_cast< const char* >( region.get_address() ), region.get_size() );
+}
+
+} // namespace address_space
+} // namespace opc
+} // FatRat Library
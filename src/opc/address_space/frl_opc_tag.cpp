@@ -1,59 +1,165 @@
-#include "frl_platform.h"
-#if( FRL_PLATFORM == FRL_PLATFORM_WIN32 )
 #include <algorithm>
 #include <boost/foreach.hpp>
-#include "../dependency/vendors/opc_foundation/opcerror.h"
+#include <boost/thread/mutex.hpp>
 #include "opc/address_space/frl_opc_tag.h"
-#include "opc/frl_opc_util.h"
 
 namespace frl{ namespace opc{ namespace address_space{
 
 namespace private_
 {
+	// Heap memory used by string, zero if string is stored in place.
+	size_t stringHeapSize( const String &str )
+	{
+		const char *data = reinterpret_cast< const char* >( str.data() );
+		const char *self = reinterpret_cast< const char* >( &str );
+		if( data >= self && data < self + sizeof( String ) )
+			return 0;
+		return ( str.capacity() + 1 ) * sizeof( Char );
+	}
+
+	// Lists of listeners are guarded by mutexes shared by tags,
+	// so every tag does not carry its own mutex.
+	const size_t listenersGuardsNumber = 64;
+	boost::mutex listenersGuards[ listenersGuardsNumber ];
+
+	boost::mutex& listenersGuard( const Tag *tag )
+	{
+		return listenersGuards[ ( reinterpret_cast< size_t >( tag ) / sizeof( Tag ) ) % listenersGuardsNumber ];
+	}
+
+	// Order of children of one branch by short IDs, which start at offset of full IDs.
+	class ShortIDLess
+	{
+	private:
+		size_t offset;
+	public:
+		ShortIDLess( size_t offset_ )
+			:	offset( offset_ )
+		{
+		}
 
-template< typename T1, typename T2 >
-void MapSecondDeAlloc( const std::pair< T1, T2 > &p )
+		PathView getShortID( const Tag *tag ) const
+		{
+			return PathView( tag->getID() ).suffix( offset );
+		}
+
+		Bool operator()( const Tag *lhv, const PathView &rhv ) const
+		{
+			return getShortID( lhv ) < rhv;
+		}
+
+		Bool operator()( const PathView &lhv, const Tag *rhv ) const
+		{
+			return lhv < getShortID( rhv );
+		}
+	};
+} // namespace private_
+
+MemoryUsage::MemoryUsage()
+	:	leafsNumber( 0 ),
+		branchesNumber( 0 ),
+		tagsSize( 0 ),
+		idsSize( 0 ),
+		childrenSize( 0 ),
+		subscriptionsSize( 0 ),
+		indexesSize( 0 )
 {
-	delete p.second;
 }
 
-} // namespace private_
+size_t MemoryUsage::getTotalSize() const
+{
+	return tagsSize + idsSize + childrenSize + subscriptionsSize + indexesSize;
+}
+
+double MemoryUsage::getBytesPerTag() const
+{
+	size_t tagsNumber = leafsNumber + branchesNumber;
+	if( tagsNumber == 0 )
+		return 0.0;
+	return (double)getTotalSize() / tagsNumber;
+}
+
+Bool TagIDLess::operator()( const Tag *lhv, const Tag *rhv ) const
+{
+	return lhv->getID() < rhv->getID();
+}
+
+Bool TagIDLess::operator()( const Tag *lhv, const String &rhv ) const
+{
+	return lhv->getID() < rhv;
+}
+
+Bool TagIDLess::operator()( const String &lhv, const Tag *rhv ) const
+{
+	return lhv < rhv->getID();
+}
+
+Bool TagIDLess::operator()( const Tag *lhv, const PathView &rhv ) const
+{
+	return PathView( lhv->getID() ) < rhv;
+}
+
+Bool TagIDLess::operator()( const PathView &lhv, const Tag *rhv ) const
+{
+	return lhv < PathView( rhv->getID() );
+}
 
 Tag::Tag( Bool is_Branch_, const String &delimiter_ )
-	:	is_Branch( is_Branch_ ),
-		requestedDataType( VT_EMPTY ),
-		accessRights( OPC_READABLE ),
+	:	value( is_Branch_ ? data_type::ARRAY : data_type::EMPTY, quality::GOOD ),
+		accessRights( access_rights::READABLE ),
+		is_Branch( is_Branch_ ),
+		in_arena( False ),
+		requestedDataType( data_type::EMPTY ),
 		parent( NULL ),
-		quality( OPC_QUALITY_GOOD ),
 		scanRate( 0 ),
-		is_opc_change_subscr( False ),
-		is_opc_change_subscr_cb( False )
+		delimiter( delimiter_.empty() ? FRL_STR('.') : delimiter_[0] ),
+		indexedType( data_type::EMPTY ),
+		listeners( NULL ),
+		handle( noTagSlot ),
+		version( 0 ),
+		children( NULL ),
+		opcWriteSubscribers( NULL ),
+		euRange( NULL ),
+		demand( 0 ),
+		attributesIndex( NULL )
 {
-	if( delimiter_.empty() )
-		delimiter = FRL_STR('.');
-	else
-		delimiter = delimiter_;
-
 	if( is_Branch )
-		value.setType( VT_ARRAY );
-	else
-		value.setType( VT_EMPTY );
-	::GetSystemTimeAsFileTime( &timeStamp );
+		children.store( new Children(), boost::memory_order_relaxed );
 }
 
 Tag::~Tag()
 {
-	std::for_each( tagsNameCache.begin(), tagsNameCache.end(), private_::MapSecondDeAlloc< String, Tag* > );
+	Children *own = children.load( boost::memory_order_acquire );
+	if( own != NULL )
+	{
+		for( Children::iterator it = own->begin(); it != own->end(); ++it )
+		{
+			if( (*it)->in_arena )
+				(*it)->~Tag();
+			else
+				delete *it;
+		}
+		delete own;
+	}
+	OpcWriteSubscriber *subscriber = opcWriteSubscribers.load( boost::memory_order_acquire );
+	while( subscriber != NULL )
+	{
+		OpcWriteSubscriber *next = subscriber->next.load( boost::memory_order_relaxed );
+		delete subscriber;
+		subscriber = next;
+	}
+	delete euRange;
+	if( listeners.load( boost::memory_order_acquire ) != NULL )
+	{
+		boost::mutex::scoped_lock guard( private_::listenersGuard( this ) );
+		for( TagListener *it = listeners.load(); it != NULL; it = it->nextListener )
+			it->tag.store( NULL, boost::memory_order_relaxed );
+	}
 }
 
 void Tag::setID( const String& newID )
 {
 	id = newID;
-	size_t pos = newID.rfind( delimiter );
-	if( pos == String::npos )
-		shortID = newID;
-	else
-		shortID = newID.substr( pos+1, newID.length() - 1 );
 }
 
 const String& Tag::getID() const
@@ -61,9 +167,16 @@ const String& Tag::getID() const
 	return id;
 }
 
-const String& Tag::getShortID() const
+String Tag::getShortID() const
 {
-	return shortID;
+	// short ID is tail of full ID
+	size_t pos = id.rfind( delimiter );
+	return pos == String::npos ? id : id.substr( pos + 1 );
+}
+
+PathView Tag::getShortName() const
+{
+	return PathView( id ).getShortName( delimiter );
 }
 
 frl::Bool Tag::isBranch() const
@@ -76,32 +189,34 @@ frl::Bool Tag::isLeaf() const
 	return ! is_Branch;
 }
 
-void Tag::setRequestedDataType( VARTYPE newType )
+void Tag::setRequestedDataType( DataType newType )
 {
 	requestedDataType = newType;
 }
 
-VARTYPE Tag::getReguestedDataType()
+DataType Tag::getReguestedDataType()
 {
 	return requestedDataType;
 }
 
-void Tag::setCanonicalDataType( VARTYPE newType )
+void Tag::setCanonicalDataType( DataType newType )
 {
 	value.setType( newType );
+	updateAttributes();
 }
 
-VARTYPE Tag::getCanonicalDataType() const
+DataType Tag::getCanonicalDataType() const
 {
 	return value.getType();
 }
 
-void Tag::setAccessRights( DWORD newAccessRights )
+void Tag::setAccessRights( UInt newAccessRights )
 {
 	accessRights = newAccessRights;
+	updateAttributes();
 }
 
-DWORD Tag::getAccessRights()
+UInt Tag::getAccessRights()
 {
 	return accessRights;
 }
@@ -109,14 +224,15 @@ DWORD Tag::getAccessRights()
 void Tag::isWritable( Bool writeable )
 {
 	if( writeable )
-		accessRights = OPC_READABLE | OPC_WRITEABLE;
+		accessRights = access_rights::READABLE | access_rights::WRITEABLE;
 	else
-		accessRights = OPC_READABLE;
+		accessRights = access_rights::READABLE;
+	updateAttributes();
 }
 
 frl::Bool Tag::isWritable() const
 {
-	return ( accessRights & OPC_WRITEABLE ) == OPC_WRITEABLE;
+	return ( accessRights & access_rights::WRITEABLE ) == access_rights::WRITEABLE;
 }
 
 Tag* Tag::addLeaf( const String &name )
@@ -127,10 +243,7 @@ Tag* Tag::addLeaf( const String &name )
 
 frl::Bool Tag::isExistTag( const String &name )
 {
-	std::map< String, Tag*>::iterator it = tagsNameCache.find( name );
-	if( it == tagsNameCache.end() )
-		return False;
-	return True;
+	return findChild( name ) != NULL;
 }
 
 Tag* Tag::addBranch( const String &name )
@@ -142,15 +255,50 @@ Tag* Tag::addBranch( const String &name )
 Tag* Tag::addTag( const String &name, Bool is_Branch_ )
 {
 	FRL_EXCEPT_GUARD();
+	const Children *old = getChildren();
+	if( old == NULL )
+		FRL_THROW_S_CLASS( IsNotBranch );
 	if( isExistTag( name ) )
 		FRL_THROW_S_CLASS( IsExistTag );
-	Tag *newTag = new Tag( is_Branch_, delimiter );
-	newTag->setParent( this );
-	newTag->setID( name );
-	tagsNameCache.insert( std::pair< String, Tag* >( name, newTag ) );
+	Tag *newTag = new Tag( is_Branch_, String( 1, delimiter ) );
+	try
+	{
+		newTag->setParent( this );
+		newTag->setID( name );
+		// array is filled before it is owned, nothing throws after new
+		Children filled( *old );
+		insertChild( filled, newTag );
+		Children *replacement = new Children();
+		replacement->swap( filled );
+		children.store( replacement, boost::memory_order_release );
+	}
+	catch( ... )
+	{
+		delete newTag;
+		throw;
+	}
+	delete old;
 	return newTag;
 }
 
+const Tag::Children* Tag::getChildren() const
+{
+	return children.load( boost::memory_order_acquire );
+}
+
+void Tag::insertChild( Children &where, Tag *child )
+{
+	if( where.empty() || where.back()->id < child->id )
+		where.push_back( child );
+	else
+		where.insert( std::upper_bound( where.begin(), where.end(), child, TagIDLess() ), child );
+}
+
+Bool Tag::isVisible( UInt maxVersion ) const
+{
+	return version <= maxVersion;
+}
+
 Tag* Tag::getBranch( const String &name )
 {
 	Tag *tmp = getTag( name );
@@ -179,188 +327,399 @@ void Tag::setParent( Tag* parent_ )
 
 void Tag::browseBranches( std::vector< String > &branches )
 {
-	branches.reserve( tagsNameCache.size() );
-	BOOST_FOREACH( map_element el, tagsNameCache )
+	const Children *own = getChildren();
+	if( own == NULL )
+		return;
+	branches.reserve( own->size() );
+	BOOST_FOREACH( const Tag *child, *own )
 	{
-		if( el.second->isBranch() )
-			branches.push_back( el.second->getShortID() );
+		if( child->isBranch() )
+			branches.push_back( child->getShortID() );
 	}
 }
 
 void Tag::browseBranches( std::vector< TagBrowseInfo > &branchesArr )
 {
-	branchesArr.reserve( tagsNameCache.size() );
+	const Children *own = getChildren();
+	if( own == NULL )
+		return;
+	branchesArr.reserve( own->size() );
 	TagBrowseInfo tmp;
-	BOOST_FOREACH( map_element el, tagsNameCache )
+	BOOST_FOREACH( Tag *child, *own )
 	{
-		if( el.second->isBranch() )
+		if( child->isBranch() )
 		{
-			tmp.fullID = el.second->getID();
-			tmp.shortID = el.second->getShortID();
+			tmp.fullID = child->id;
+			tmp.shortID = child->getShortName();
 			tmp.isLeaf = False;
-			tmp.tagPtr = el.second;
+			tmp.tagPtr = child;
 			branchesArr.push_back( tmp );
 		}
 	}
 }
 
-void Tag::browseLeafs( std::vector< String > &leafs, DWORD accessFilter )
+void Tag::browseLeafs( std::vector< String > &leafs, UInt accessFilter, DataType dataType )
 {
-	leafs.reserve( tagsNameCache.size() );
-	BOOST_FOREACH( map_element el, tagsNameCache )
+	const Children *own = getChildren();
+	if( own == NULL )
+		return;
+	leafs.reserve( own->size() );
+	BOOST_FOREACH( const Tag *child, *own )
 	{
-		if( el.second->isLeaf() )
+		if( child->isLeaf() )
 		{
 			if( accessFilter != 0 )
 			{
-				if( ! el.second->checkAccessRight( accessFilter ) )
+				if( ! child->checkAccessRight( accessFilter ) )
 					continue;
 			}
-			leafs.push_back( el.second->getShortID() );
+			if( dataType != data_type::EMPTY && child->getCanonicalDataType() != dataType )
+				continue;
+			leafs.push_back( child->getShortID() );
 		}
 	}
 }
 
+void Tag::browseAllLeafs( std::vector< String > &leafs, UInt accessFilter, UInt maxVersion ) const
+{
+	const Children *own = getChildren();
+	if( own == NULL )
+		return;
+	Children::const_iterator end = own->end();
+	for(	Children::const_iterator it = own->begin();
+			it != end;
+			++it )
+	{
+		if( ! (*it)->isVisible( maxVersion ) )
+			continue;
+		if( (*it)->isBranch() )
+		{
+			(*it)->browseAllLeafs( leafs, accessFilter, maxVersion );
+			continue;
+		}
+		if( accessFilter != 0 && ! (*it)->checkAccessRight( accessFilter ) )
+			continue;
+		leafs.push_back( (*it)->getID() );
+	}
+}
+
+void Tag::browseAllLeafs(	std::vector< String > &leafs,
+								const NamePattern &pattern,
+								UInt accessFilter,
+								const String &afterID,
+								size_t maxCount,
+								UInt maxVersion ) const
+{
+	const Children *own = getChildren();
+	if( own == NULL )
+		return;
+	// IDs of children begin with ID of this branch and delimiter
+	size_t childPos = id.empty() ? 0 : id.size() + 1;
+	PathView prefix;
+	if( pattern.getPrefix().size() > childPos )
+	{
+		PathView patternPrefix( pattern.getPrefix() );
+		size_t delimPos = patternPrefix.find( delimiter, childPos );
+		if( delimPos != String::npos )
+		{
+			// prefix goes deeper: only one branch may contain matching leafs
+			const Tag *child = findChild( patternPrefix.prefix( delimPos ) );
+			if( child != NULL && child->isVisible( maxVersion ) )
+				child->browseAllLeafs( leafs, pattern, accessFilter, afterID, maxCount, maxVersion );
+			return;
+		}
+		prefix = patternPrefix;
+	}
+	// child on the path to afterID: browsing continues inside of it (branch)
+	// or from the next one (leaf)
+	PathView resumeID;
+	if( ! afterID.empty() )
+		resumeID = PathView( afterID ).prefix( afterID.find( delimiter, childPos ) );
+	const PathView &from = ( resumeID < prefix ) ? prefix : resumeID;
+	Children::const_iterator it = from.empty() ? own->begin() : std::lower_bound( own->begin(), own->end(), from, TagIDLess() );
+	Children::const_iterator end = own->end();
+	Bool resume = ! resumeID.empty() && it != end && PathView( (*it)->id ) == resumeID;
+	for( ; it != end; ++it, resume = False )
+	{
+		if( maxCount != 0 && leafs.size() >= maxCount )
+			return;
+		const Tag *child = *it;
+		if( ! PathView( child->id ).startsWith( prefix ) )
+			break;
+		if( ! child->isVisible( maxVersion ) )
+			continue;
+		if( child->isBranch() )
+		{
+			if( pattern.matchBeginning( child->id + delimiter ) )
+				child->browseAllLeafs( leafs, pattern, accessFilter, resume ? afterID : String(), maxCount, maxVersion );
+			continue;
+		}
+		if( resume )
+			continue; // returned already
+		if( accessFilter != 0 && ! child->checkAccessRight( accessFilter ) )
+			continue;
+		if( pattern.match( child->id ) )
+			leafs.push_back( child->id );
+	}
+}
+
 void Tag::browseLeafs( std::vector< TagBrowseInfo > &leafsArr )
 {
-	leafsArr.reserve( tagsNameCache.size() );
+	const Children *own = getChildren();
+	if( own == NULL )
+		return;
+	leafsArr.reserve( own->size() );
 	TagBrowseInfo tmp;
-	BOOST_FOREACH( map_element el, tagsNameCache )
+	BOOST_FOREACH( Tag *child, *own )
 	{
-		if( el.second->isLeaf() )
+		if( child->isLeaf() )
 		{
-			tmp.fullID = el.second->getID();
-			tmp.shortID = el.second->getShortID();
+			tmp.fullID = child->id;
+			tmp.shortID = child->getShortName();
 			tmp.isLeaf = True;
-			tmp.tagPtr = el.second;
+			tmp.tagPtr = child;
 			leafsArr.push_back( tmp );
 		}
 	}
 }
 
-const os::win32::com::Variant& Tag::read() const
+Value Tag::read() const
+{
+	return value.getValue();
+}
+
+void Tag::read( Value &toValue, UShort &toQuality, TimeStamp &toTimeStamp ) const
+{
+	value.read( toValue, toQuality, toTimeStamp );
+}
+
+void Tag::writeFromOPC( const Value &newVal )
+{
+	if( ! value.write( newVal, TimeStamp::now() ) )
+		return;
+	if( newVal.getType() != indexedType )
+		updateAttributes();
+	notifyListeners();
+	notifyOPCWrite();
+}
+
+void Tag::writeFromOPC( const Value &newVal, UShort quality_, const TimeStamp &ts )
+{
+	if( ! value.write( newVal, quality_, ts ) )
+		return;
+	if( newVal.getType() != indexedType )
+		updateAttributes();
+	notifyListeners();
+	notifyOPCWrite();
+}
+
+void Tag::notifyOPCWrite()
+{
+	for( OpcWriteSubscriber *it = opcWriteSubscribers.load( boost::memory_order_acquire );
+		it != NULL; it = it->next.load( boost::memory_order_acquire ) )
+	{
+		if( ! it->change.empty() )
+			it->change();
+		if( ! it->changeCb.empty() )
+			it->changeCb( this );
+	}
+}
+
+void Tag::addOpcWriteSubscriber( OpcWriteSubscriber *subscriber )
 {
-	return value;
+	subscriber->next.store( NULL, boost::memory_order_relaxed );
+	boost::mutex::scoped_lock guard( private_::listenersGuard( this ) );
+	OpcWriteSubscriber *last = opcWriteSubscribers.load( boost::memory_order_relaxed );
+	if( last == NULL )
+	{
+		opcWriteSubscribers.store( subscriber, boost::memory_order_release );
+		return;
+	}
+	while( last->next.load( boost::memory_order_relaxed ) != NULL )
+		last = last->next.load( boost::memory_order_relaxed );
+	last->next.store( subscriber, boost::memory_order_release );
 }
 
-void Tag::writeFromOPC( const os::win32::com::Variant &newVal )
+void Tag::write( const Value &newVal )
 {
-	if( os::win32::com::Variant::isEqual( value, newVal ) )
+	if( ! value.write( newVal, TimeStamp::now() ) )
 		return;
-	value = newVal;
-	::GetSystemTimeAsFileTime( &timeStamp );
-	if( is_opc_change_subscr )
-		opc_change();
-	if( is_opc_change_subscr_cb )
-		opc_change_cb( this );
+	// value of other type changes canonical type
+	if( newVal.getType() != indexedType )
+		updateAttributes();
+	notifyListeners();
 }
 
-void Tag::write( const os::win32::com::Variant &newVal )
+void Tag::write( const Value &newVal, UShort quality_, const TimeStamp &ts )
 {
-	if( os::win32::com::Variant::isEqual( value, newVal ) )
+	if( ! value.write( newVal, quality_, ts ) )
 		return;
-	value = newVal;
-	::GetSystemTimeAsFileTime( &timeStamp );
+	if( newVal.getType() != indexedType )
+		updateAttributes();
+	notifyListeners();
 }
 
-const FILETIME& Tag::getTimeStamp() const
+void Tag::updateAttributes()
 {
-	return timeStamp;
+	TagAttributesIndex *index = attributesIndex.load( boost::memory_order_acquire );
+	if( index == NULL )
+		return;
+	indexedType = value.getType();
+	index->update( handle, accessRights, indexedType );
 }
 
-void Tag::setQuality( WORD quality_ )
+TimeStamp Tag::getTimeStamp() const
 {
-	quality = quality_;
+	return value.getTimeStamp();
 }
 
-WORD Tag::getQuality() const
+void Tag::setQuality( UShort quality_ )
 {
-	return quality;
+	value.setQuality( quality_ );
+	notifyListeners();
 }
 
-void Tag::setScanRate( DWORD scanRate_ )
+UShort Tag::getQuality() const
+{
+	return value.getQuality();
+}
+
+void Tag::setScanRate( UInt scanRate_ )
 {
 	scanRate = scanRate_;
 }
 
-DWORD Tag::getScanRate()
+UInt Tag::getScanRate()
 {
 	return scanRate;
 }
 
-Bool Tag::isValidProperties( DWORD propertyID )
+void Tag::setEURange( Double lowEU, Double highEU )
+{
+	if( euRange == NULL )
+		euRange = new EURange();
+	euRange->low = lowEU;
+	euRange->high = highEU;
+}
+
+Bool Tag::isAnalog() const
+{
+	return euRange != NULL;
+}
+
+Double Tag::getLowEU() const
+{
+	return euRange == NULL ? 0 : euRange->low;
+}
+
+Double Tag::getHighEU() const
+{
+	return euRange == NULL ? 0 : euRange->high;
+}
+
+Bool Tag::isValidProperties( UInt propertyID )
 {
 	switch( propertyID )
 	{
 	case 0:
-	case OPC_PROPERTY_VALUE:
-	case OPC_PROPERTY_DATATYPE:  
-	case OPC_PROPERTY_QUALITY:
-	case OPC_PROPERTY_SCAN_RATE:
-	case OPC_PROPERTY_TIMESTAMP:
-	case OPC_PROPERTY_ACCESS_RIGHTS:
+	case property::VALUE:
+	case property::DATATYPE:
+	case property::QUALITY:
+	case property::SCAN_RATE:
+	case property::TIMESTAMP:
+	case property::ACCESS_RIGHTS:
 	{
 	break;
 	}	
+	case property::EU_TYPE:
+	case property::HIGH_EU:
+	case property::LOW_EU:
+		return isAnalog();
 	default:
 		return False;
 	}
 	return True;
 }
 
-Bool Tag::checkAccessRight( DWORD checkingAccessRight )
+Bool Tag::checkAccessRight( UInt checkingAccessRight ) const
 {
 	return ( accessRights & checkingAccessRight ) == checkingAccessRight;
 }
 
-std::vector< DWORD > Tag::getAvailableProperties() const
+std::vector< UInt > Tag::getAvailableProperties() const
 {
-	std::vector< DWORD > ret;
+	std::vector< UInt > ret;
 	ret.reserve( 6 );	
-	ret.push_back( OPC_PROPERTY_DATATYPE );
-	ret.push_back( OPC_PROPERTY_VALUE );
-	ret.push_back( OPC_PROPERTY_QUALITY );
-	ret.push_back( OPC_PROPERTY_TIMESTAMP );
-	ret.push_back( OPC_PROPERTY_ACCESS_RIGHTS );
-	ret.push_back( OPC_PROPERTY_SCAN_RATE );
+	ret.push_back( property::DATATYPE );
+	ret.push_back( property::VALUE );
+	ret.push_back( property::QUALITY );
+	ret.push_back( property::TIMESTAMP );
+	ret.push_back( property::ACCESS_RIGHTS );
+	ret.push_back( property::SCAN_RATE );
+	if( isAnalog() )
+	{
+		ret.push_back( property::EU_TYPE );
+		ret.push_back( property::HIGH_EU );
+		ret.push_back( property::LOW_EU );
+	}
 	return ret;
 }
 
-HRESULT Tag::getPropertyValue( DWORD propID, VARIANT &toValue )
+Bool Tag::getPropertyValue( UInt propID, Value &toValue ) const
 {
-	using namespace os::win32::com;
 	switch ( propID )
 	{
-		case OPC_PROPERTY_DATATYPE:
-			return Variant::variantCopy( toValue, Variant( (short)value.getType() ) );
+		case property::DATATYPE:
+			toValue = Value( (short)value.getType() );
+			return True;
+
+		case property::VALUE:
+			toValue = read();
+			return True;
+
+		case property::QUALITY:
+			toValue = Value( (short)value.getQuality() );
+			return True;
+
+		case property::TIMESTAMP:
+			toValue = Value( value.getTimeStamp() );
+			return True;
 
-		case OPC_PROPERTY_VALUE:
-			return Variant::variantCopy( toValue, read() );
+		case property::ACCESS_RIGHTS:
+			toValue = Value( (Int)accessRights );
+			return True;
 
-		case OPC_PROPERTY_QUALITY:
-			return Variant::variantCopy( toValue, Variant( (short)quality ) );
+		case property::SCAN_RATE:
+			toValue = Value( (float)scanRate );
+			return True;
 
-		case OPC_PROPERTY_TIMESTAMP:
-			return Variant::variantCopy( toValue, Variant( timeStamp ) );
+		case property::EU_TYPE:
+			toValue = Value( (Int)eu_type::ANALOG );
+			return isAnalog();
 
-		case OPC_PROPERTY_ACCESS_RIGHTS:
-			return Variant::variantCopy( toValue, Variant( (long)accessRights ) );
+		case property::HIGH_EU:
+			toValue = Value( getHighEU() );
+			return isAnalog();
 
-		case OPC_PROPERTY_SCAN_RATE:
-			return Variant::variantCopy( toValue, Variant( (float)scanRate ) );
+		case property::LOW_EU:
+			toValue = Value( getLowEU() );
+			return isAnalog();
 	}
-	return OPC_E_INVALID_PID;
+	return False;
 }
 
 void Tag::browse( std::vector< TagBrowseInfo > &arr )
 {
-	arr.reserve( tagsNameCache.size() );
+	const Children *own = getChildren();
+	if( own == NULL )
+		return;
+	arr.reserve( own->size() );
 	TagBrowseInfo tmp;
-	BOOST_FOREACH( map_element el, tagsNameCache )
+	BOOST_FOREACH( Tag *child, *own )
 	{
-		tmp.fullID = el.second->getID();
-		tmp.shortID = el.second->getShortID();
-		if( el.second->isLeaf() )
+		tmp.fullID = child->id;
+		tmp.shortID = child->getShortName();
+		if( child->isLeaf() )
 		{
 			tmp.isLeaf = True;
 		}
@@ -368,49 +727,255 @@ void Tag::browse( std::vector< TagBrowseInfo > &arr )
 		{
 			tmp.isLeaf = False;
 		}	
-		tmp.tagPtr = el.second;
+		tmp.tagPtr = child;
+		arr.push_back( tmp );
+	}
+}
+
+String Tag::browseChildren(	std::vector< TagBrowseInfo > &arr, Bool leafs, const String &fromID,
+									size_t maxCount, const NamePattern &nameFilter ) const
+{
+	const Children *own = getChildren();
+	if( own == NULL )
+		return String();
+	// matching children are in range of IDs which begin with literal prefix
+	String first;
+	if( ! nameFilter.getPrefix().empty() )
+	{
+		if( ! id.empty() )
+			first = id + delimiter;
+		first += nameFilter.getPrefix();
+	}
+	const String &from = ( fromID < first ) ? first : fromID;
+	Children::const_iterator it = from.empty() ? own->begin() : std::lower_bound( own->begin(), own->end(), from, TagIDLess() );
+	TagBrowseInfo tmp;
+	for( ; it != own->end(); ++it )
+	{
+		const Tag *child = *it;
+		if( ! first.empty() && child->id.compare( 0, first.size(), first ) != 0 )
+			break;
+		if( child->isLeaf() != leafs )
+			continue;
+		PathView shortID = child->getShortName();
+		if( ! nameFilter.isMatchAll() && ! nameFilter.match( shortID ) )
+			continue;
+		if( maxCount != 0 && arr.size() >= maxCount )
+			return child->getID();
+		tmp.fullID = child->id;
+		tmp.shortID = shortID;
+		tmp.isLeaf = leafs;
+		tmp.tagPtr = *it;
 		arr.push_back( tmp );
 	}
+	return String();
+}
+
+Bool Tag::browsePage(	std::vector< TagBrowseInfo > &arr,
+							UInt filter,
+							const String &fromID,
+							size_t maxCount,
+							const NamePattern &nameFilter,
+							String &nextID ) const
+{
+	arr.clear();
+	const Tag *from = NULL;
+	if( ! fromID.empty() )
+	{
+		from = findChild( fromID );
+		if( from == NULL
+			|| ( filter == browse_filter::LEAFS && from->isBranch() )
+			|| ( filter == browse_filter::BRANCHES && from->isLeaf() ) )
+			return False;
+	}
+	// fromID and nextID may be the same string
+	String next;
+	if( filter != browse_filter::BRANCHES && ( from == NULL || from->isLeaf() ) )
+	{
+		next = browseChildren( arr, True, fromID, maxCount, nameFilter );
+		// leafs are over, branches from the first one
+		if( next.empty() && filter != browse_filter::LEAFS )
+			next = browseChildren( arr, False, String(), maxCount, nameFilter );
+	}
+	else
+		next = browseChildren( arr, False, fromID, maxCount, nameFilter );
+	nextID.swap( next );
+	return True;
 }
 
-void Tag::setTimeStamp( const FILETIME& ts )
+void Tag::setTimeStamp( const TimeStamp& ts )
 {
-	timeStamp = ts;
+	value.setTimeStamp( ts );
+	notifyListeners();
 }
 
 Tag* Tag::getTag( const String &name )
 {
-	std::map< String, Tag*>::iterator it = tagsNameCache.find( name );
-	if( it == tagsNameCache.end() )
+	Tag *tmp = findChild( name );
+	if( tmp == NULL )
 		FRL_THROW_S_CLASS( NotExistTag );
-	return (*it).second;
+	return tmp;
+}
+
+Tag* Tag::findChild( const PathView &name ) const
+{
+	const Children *own = getChildren();
+	if( own == NULL )
+		return NULL;
+	Children::const_iterator it = std::lower_bound( own->begin(), own->end(), name, TagIDLess() );
+	if( it == own->end() || PathView( (*it)->id ) != name )
+		return NULL;
+	return *it;
+}
+
+Tag* Tag::findChildByName( const PathView &shortID ) const
+{
+	const Children *own = getChildren();
+	if( own == NULL )
+		return NULL;
+	// all children begin with same prefix, so they are ordered by short IDs
+	private_::ShortIDLess less( id.empty() ? 0 : id.size() + 1 );
+	Children::const_iterator it = std::lower_bound( own->begin(), own->end(), shortID, less );
+	if( it == own->end() || less.getShortID( *it ) != shortID )
+		return NULL;
+	return *it;
+}
+
+Tag* Tag::findDescendant( const PathView &relativePath ) const
+{
+	const Tag *tag = this;
+	PathTokenizer tokenizer( relativePath, delimiter );
+	PathView segment;
+	while( tag != NULL && tokenizer.next( segment ) )
+		tag = tag->findChildByName( segment );
+	return const_cast< Tag* >( tag );
 }
 
 frl::Bool Tag::isReadable() const
 {
-	return ( accessRights & OPC_READABLE ) == OPC_READABLE;	
+	return ( accessRights & access_rights::READABLE ) == access_rights::READABLE;
 }
 
 void Tag::subscribeToOpcChange( const boost::function< void() > &function_ )
 {
-	FRL_EXCEPT_GUARD();
-	if( is_opc_change_subscr )
-		FRL_THROW_S_CLASS( AlreadySubscribe );
-	opc_change = function_;
-	is_opc_change_subscr = True;
+	OpcWriteSubscriber *subscriber = new OpcWriteSubscriber();
+	subscriber->change = function_;
+	addOpcWriteSubscriber( subscriber );
 }
 
 void Tag::subscribeToOpcChange( const boost::function< void( const address_space::Tag* const ) > &function_ )
 {
-	FRL_EXCEPT_GUARD();
-	if( is_opc_change_subscr_cb )
-		FRL_THROW_S_CLASS( AlreadySubscribe );
-	opc_change_cb = function_;
-	is_opc_change_subscr_cb = True;
+	OpcWriteSubscriber *subscriber = new OpcWriteSubscriber();
+	subscriber->changeCb = function_;
+	addOpcWriteSubscriber( subscriber );
+}
+
+void Tag::addListener( TagListener *listener )
+{
+	if( listener->getListenedTag() == this )
+		return;
+	listener->unsubscribe();
+	boost::mutex::scoped_lock guard( private_::listenersGuard( this ) );
+	TagListener *head = listeners.load( boost::memory_order_relaxed );
+	listener->tag.store( this, boost::memory_order_relaxed );
+	listener->prevListener = NULL;
+	listener->nextListener = head;
+	if( head != NULL )
+		head->prevListener = listener;
+	listeners.store( listener, boost::memory_order_release );
+}
+
+void Tag::removeListener( TagListener *listener )
+{
+	unlinkListener( this, listener );
+}
+
+Bool Tag::unlinkListener( Tag *tag, TagListener *listener )
+{
+	// stripe of lock is taken by address only
+	boost::mutex::scoped_lock guard( private_::listenersGuard( tag ) );
+	if( listener->tag.load( boost::memory_order_relaxed ) != tag )
+		return False;
+	if( listener->prevListener != NULL )
+		listener->prevListener->nextListener = listener->nextListener;
+	else
+		tag->listeners.store( listener->nextListener, boost::memory_order_release );
+	if( listener->nextListener != NULL )
+		listener->nextListener->prevListener = listener->prevListener;
+	listener->tag.store( NULL, boost::memory_order_relaxed );
+	listener->prevListener = listener->nextListener = NULL;
+	return True;
+}
+
+Bool Tag::hasListeners() const
+{
+	return listeners.load( boost::memory_order_acquire ) != NULL;
+}
+
+void Tag::addDemand()
+{
+	demand.fetch_add( 1, boost::memory_order_relaxed );
+}
+
+void Tag::releaseDemand()
+{
+	demand.fetch_sub( 1, boost::memory_order_relaxed );
+}
+
+Bool Tag::isDemanded() const
+{
+	return demand.load( boost::memory_order_relaxed ) != 0;
+}
+
+void Tag::notifyListeners()
+{
+	// tags without listeners are written without locking
+	if( listeners.load( boost::memory_order_acquire ) == NULL )
+		return;
+	boost::mutex::scoped_lock guard( private_::listenersGuard( this ) );
+	for( TagListener *it = listeners.load( boost::memory_order_relaxed ); it != NULL; it = it->nextListener )
+		it->onTagChange( this );
+}
+
+void Tag::releaseListeners()
+{
+	if( listeners.load( boost::memory_order_acquire ) == NULL )
+		return;
+	boost::mutex::scoped_lock guard( private_::listenersGuard( this ) );
+	TagListener *it = listeners.load( boost::memory_order_relaxed );
+	listeners.store( NULL, boost::memory_order_release );
+	while( it != NULL )
+	{
+		TagListener *next = it->nextListener;
+		it->onTagChange( this );
+		it->tag.store( NULL, boost::memory_order_relaxed );
+		it->prevListener = it->nextListener = NULL;
+		it = next;
+	}
+}
+
+void Tag::getMemoryUsage( MemoryUsage &usage ) const
+{
+	if( is_Branch )
+		++usage.branchesNumber;
+	else
+		++usage.leafsNumber;
+	if( ! in_arena )
+		usage.tagsSize += sizeof( Tag );
+	usage.idsSize += private_::stringHeapSize( id );
+	for( const OpcWriteSubscriber *it = opcWriteSubscribers.load( boost::memory_order_acquire );
+		it != NULL; it = it->next.load( boost::memory_order_acquire ) )
+		usage.subscriptionsSize += sizeof( OpcWriteSubscriber );
+	if( euRange != NULL )
+		usage.tagsSize += sizeof( EURange );
+	const Children *own = getChildren();
+	if( own == NULL )
+		return;
+	usage.childrenSize += sizeof( Children ) + own->capacity() * sizeof( Tag* );
+	for( Children::const_iterator it = own->begin(); it != own->end(); ++it )
+		(*it)->getMemoryUsage( usage );
 }
 
 } // namespace address_space
 } // namespace opc
 } // FatRat Library
 
-#endif
@@ -0,0 +1,107 @@
+#include "opc/address_space/frl_opc_tag_arena.h"
+#include "opc/address_space/frl_opc_tag.h"
+
+namespace frl{ namespace opc{ namespace address_space{
+
+namespace private_
+{
+	const size_t minArenaBlock = 256;
+	const size_t cacheLineSize = 64;
+
+	// Every tag starts on cache line boundary, so hot part of tag
+	// (value, quality, time stamp, access rights) does not straddle lines.
+	const size_t tagStride = ( sizeof( Tag ) + cacheLineSize - 1 ) / cacheLineSize * cacheLineSize;
+} // namespace private_
+
+TagArena::TagArena()
+	:	used( 0 ),
+		capacity( 0 ),
+		allocatedSize( 0 ),
+		current( NULL ),
+		freeTags( NULL )
+{
+}
+
+TagArena::~TagArena()
+{
+	for( size_t i = 0; i < blocks.size(); ++i )
+		::operator delete( blocks[i] );
+}
+
+void TagArena::addBlock( size_t tagsNumber )
+{
+	if( tagsNumber < private_::minArenaBlock )
+		tagsNumber = private_::minArenaBlock;
+	size_t size = tagsNumber * private_::tagStride + private_::cacheLineSize - 1;
+	blocks.reserve( blocks.size() + 1 );
+	blocks.push_back( static_cast< char* >( ::operator new( size ) ) );
+	size_t offset = reinterpret_cast< size_t >( blocks.back() ) % private_::cacheLineSize;
+	current = blocks.back() + ( offset == 0 ? 0 : private_::cacheLineSize - offset );
+	used = 0;
+	capacity = tagsNumber;
+	allocatedSize += size;
+}
+
+void TagArena::reserve( size_t tagsNumber )
+{
+	if( capacity - used < tagsNumber )
+		addBlock( tagsNumber );
+}
+
+void* TagArena::allocate()
+{
+	{
+		boost::mutex::scoped_lock guard( freeGuard );
+		if( freeTags != NULL )
+		{
+			void *tag = freeTags;
+			freeTags = *static_cast< void** >( tag );
+			return tag;
+		}
+	}
+	if( used == capacity )
+		addBlock( capacity * 2 );
+	return current + private_::tagStride * used++;
+}
+
+void TagArena::deallocate( void *tag )
+{
+	boost::mutex::scoped_lock guard( freeGuard );
+	*static_cast< void** >( tag ) = freeTags;
+	freeTags = tag;
+}
+
+void TagArena::adopt( TagArena &other )
+{
+	if( &other == this )
+		return;
+	blocks.reserve( blocks.size() + other.blocks.size() );
+	blocks.insert( blocks.end(), other.blocks.begin(), other.blocks.end() );
+	other.blocks.clear();
+	allocatedSize += other.allocatedSize;
+	other.allocatedSize = 0;
+	other.used = other.capacity = 0;
+	other.current = NULL;
+	void *adopted = NULL;
+	{
+		boost::mutex::scoped_lock guard( other.freeGuard );
+		adopted = other.freeTags;
+		other.freeTags = NULL;
+	}
+	// free tags of other arena are linked in front of own ones
+	while( adopted != NULL )
+	{
+		void *next = *static_cast< void** >( adopted );
+		deallocate( adopted );
+		adopted = next;
+	}
+}
+
+size_t TagArena::getAllocatedSize() const
+{
+	return allocatedSize;
+}
+
+} // namespace address_space
+} // namespace opc
+} // FatRat Library
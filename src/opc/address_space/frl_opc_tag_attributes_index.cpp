@@ -0,0 +1,145 @@
+#include "opc/address_space/frl_opc_tag_attributes_index.h"
+#include "opc/address_space/frl_opc_tag.h"
+
+namespace frl{ namespace opc{ namespace address_space{
+
+namespace private_
+{
+	const UInt bitsInWord = 64;
+
+	ULong getWord( const std::vector< ULong > &bitmap, size_t word )
+	{
+		return word < bitmap.size() ? bitmap[word] : 0;
+	}
+} // namespace private_
+
+TagAttributesIndex::Attributes::Attributes()
+	:	accessRights( 0 ),
+		dataType( data_type::EMPTY ),
+		indexed( False )
+{
+}
+
+TagAttributesIndex::TagAttributesIndex()
+	:	count( 0 )
+{
+}
+
+void TagAttributesIndex::setBit( Bitmap &bitmap, UInt slot, Bool value )
+{
+	size_t word = slot / private_::bitsInWord;
+	ULong mask = (ULong)1 << ( slot % private_::bitsInWord );
+	if( word >= bitmap.size() )
+	{
+		if( ! value )
+			return;
+		bitmap.resize( word + 1, 0 );
+	}
+	if( value )
+		bitmap[word] |= mask;
+	else
+		bitmap[word] &= ~mask;
+}
+
+void TagAttributesIndex::update( UInt slot, UInt accessRights, DataType dataType )
+{
+	boost::mutex::scoped_lock lock( guard );
+	if( slot >= slots.size() )
+		slots.resize( slot + 1 );
+	Attributes &attributes = slots[slot];
+	if( attributes.indexed )
+	{
+		if( attributes.accessRights == accessRights && attributes.dataType == dataType )
+			return;
+		if( attributes.dataType != dataType )
+			setBit( types[ attributes.dataType ], slot, False );
+	}
+	else
+	{
+		setBit( leafs, slot, True );
+		++count;
+	}
+	setBit( readable, slot, ( accessRights & access_rights::READABLE ) != 0 );
+	setBit( writable, slot, ( accessRights & access_rights::WRITEABLE ) != 0 );
+	setBit( types[ dataType ], slot, True );
+	attributes.accessRights = accessRights;
+	attributes.dataType = dataType;
+	attributes.indexed = True;
+}
+
+void TagAttributesIndex::remove( UInt slot )
+{
+	boost::mutex::scoped_lock lock( guard );
+	if( slot >= slots.size() || ! slots[slot].indexed )
+		return;
+	setBit( leafs, slot, False );
+	setBit( readable, slot, False );
+	setBit( writable, slot, False );
+	setBit( types[ slots[slot].dataType ], slot, False );
+	slots[slot] = Attributes();
+	--count;
+}
+
+void TagAttributesIndex::find( UInt accessFilter, DataType dataType, std::vector< UInt > &found ) const
+{
+	found.clear();
+	boost::mutex::scoped_lock lock( guard );
+	const Bitmap *byType = &leafs;
+	if( dataType != data_type::EMPTY )
+	{
+		TypeBitmaps::const_iterator it = types.find( dataType );
+		if( it == types.end() )
+			return;
+		byType = &it->second;
+	}
+	Bool needReadable = ( accessFilter & access_rights::READABLE ) != 0;
+	Bool needWritable = ( accessFilter & access_rights::WRITEABLE ) != 0;
+	for( size_t word = 0; word < byType->size(); ++word )
+	{
+		ULong bits = (*byType)[word];
+		if( needReadable )
+			bits &= private_::getWord( readable, word );
+		if( needWritable )
+			bits &= private_::getWord( writable, word );
+		for( UInt bit = 0; bits != 0; ++bit, bits >>= 1 )
+		{
+			if( ( bits & 1 ) == 0 )
+				continue;
+			UInt slot = (UInt)( word * private_::bitsInWord + bit );
+			// other rights are not in bitmaps
+			if( ( slots[slot].accessRights & accessFilter ) == accessFilter )
+				found.push_back( slot );
+		}
+	}
+}
+
+void TagAttributesIndex::clear()
+{
+	boost::mutex::scoped_lock lock( guard );
+	leafs.clear();
+	readable.clear();
+	writable.clear();
+	types.clear();
+	slots.clear();
+	count = 0;
+}
+
+size_t TagAttributesIndex::size() const
+{
+	boost::mutex::scoped_lock lock( guard );
+	return count;
+}
+
+size_t TagAttributesIndex::getMemorySize() const
+{
+	boost::mutex::scoped_lock lock( guard );
+	size_t size = ( leafs.capacity() + readable.capacity() + writable.capacity() ) * sizeof( ULong )
+		+ slots.capacity() * sizeof( Attributes );
+	for( TypeBitmaps::const_iterator it = types.begin(); it != types.end(); ++it )
+		size += sizeof( *it ) + it->second.capacity() * sizeof( ULong );
+	return size;
+}
+
+} // namespace address_space
+} // namespace opc
+} // FatRat Library
@@ -0,0 +1,168 @@
+#include "opc/address_space/frl_opc_tag_handle.h"
+
+namespace frl{ namespace opc{ namespace address_space{
+
+namespace private_
+{
+	const UInt slotsChunk = 1024;
+	const size_t minSlotsDirectory = 16;
+} // namespace private_
+
+TagHandle::TagHandle()
+	:	index( noTagSlot ), generation( 0 )
+{
+}
+
+TagHandle::TagHandle( UInt index_, UInt generation_ )
+	:	index( index_ ), generation( generation_ )
+{
+}
+
+Bool TagHandle::isNull() const
+{
+	return generation == 0;
+}
+
+Bool TagHandle::operator == ( const TagHandle &rhv ) const
+{
+	return index == rhv.index && generation == rhv.generation;
+}
+
+Bool TagHandle::operator != ( const TagHandle &rhv ) const
+{
+	return ! ( *this == rhv );
+}
+
+TagHandleTable::Slot::Slot()
+	:	tag( NULL ), generation( 1 ), nextFree( noTagSlot )
+{
+}
+
+TagHandleTable::Directory::Directory( size_t size_, Directory *previous_ )
+	:	size( size_ ),
+		chunks( new Slot*[ size_ ] ),
+		previous( previous_ )
+{
+	for( size_t i = 0; i < size; ++i )
+		chunks[i] = NULL;
+}
+
+TagHandleTable::TagHandleTable()
+	:	directory( NULL ),
+		used( 0 ),
+		firstFree( noTagSlot ),
+		count( 0 )
+{
+}
+
+TagHandleTable::~TagHandleTable()
+{
+	clear();
+}
+
+void TagHandleTable::clear()
+{
+	Directory *it = directory.exchange( NULL );
+	// the newest directory refers to all chunks
+	for( size_t i = 0; it != NULL && i < it->size; ++i )
+		delete [] it->chunks[i];
+	while( it != NULL )
+	{
+		Directory *previous = it->previous;
+		delete it;
+		it = previous;
+	}
+	used = 0;
+	firstFree = noTagSlot;
+	count = 0;
+}
+
+TagHandleTable::Slot* TagHandleTable::getSlot( UInt index ) const
+{
+	const Directory *dir = directory.load( boost::memory_order_acquire );
+	size_t chunk = index / private_::slotsChunk;
+	if( dir == NULL || chunk >= dir->size || dir->chunks[chunk] == NULL )
+		return NULL;
+	return dir->chunks[chunk] + index % private_::slotsChunk;
+}
+
+UInt TagHandleTable::add( Tag *tag )
+{
+	if( firstFree != noTagSlot )
+	{
+		UInt index = firstFree;
+		Slot *slot = getSlot( index );
+		firstFree = slot->nextFree;
+		slot->tag.store( tag, boost::memory_order_release );
+		++count;
+		return index;
+	}
+	size_t chunk = used / private_::slotsChunk;
+	Directory *dir = directory.load( boost::memory_order_relaxed );
+	if( dir == NULL || chunk >= dir->size )
+	{
+		Directory *grown = new Directory( dir == NULL ? private_::minSlotsDirectory : dir->size * 2, dir );
+		for( size_t i = 0; dir != NULL && i < dir->size; ++i )
+			grown->chunks[i] = dir->chunks[i];
+		directory.store( grown, boost::memory_order_release );
+		dir = grown;
+	}
+	if( dir->chunks[chunk] == NULL )
+		dir->chunks[chunk] = new Slot[ private_::slotsChunk ];
+	UInt index = used++;
+	getSlot( index )->tag.store( tag, boost::memory_order_release );
+	++count;
+	return index;
+}
+
+void TagHandleTable::remove( UInt index )
+{
+	Slot *slot = getSlot( index );
+	if( slot == NULL || slot->tag.load( boost::memory_order_relaxed ) == NULL )
+		return;
+	UInt generation = slot->generation.load( boost::memory_order_relaxed ) + 1;
+	slot->generation.store( generation == 0 ? 1 : generation, boost::memory_order_release );
+	slot->tag.store( NULL, boost::memory_order_release );
+	slot->nextFree = firstFree;
+	firstFree = index;
+	--count;
+}
+
+TagHandle TagHandleTable::getHandle( UInt index ) const
+{
+	const Slot *slot = getSlot( index );
+	if( slot == NULL || slot->tag.load( boost::memory_order_acquire ) == NULL )
+		return TagHandle();
+	return TagHandle( index, slot->generation.load( boost::memory_order_acquire ) );
+}
+
+Tag* TagHandleTable::find( const TagHandle &handle ) const
+{
+	if( handle.isNull() )
+		return NULL;
+	const Slot *slot = getSlot( handle.index );
+	if( slot == NULL || slot->generation.load( boost::memory_order_acquire ) != handle.generation )
+		return NULL;
+	Tag *tag = slot->tag.load( boost::memory_order_acquire );
+	// slot may be freed and taken by other tag meanwhile
+	if( slot->generation.load( boost::memory_order_acquire ) != handle.generation )
+		return NULL;
+	return tag;
+}
+
+size_t TagHandleTable::size() const
+{
+	return count;
+}
+
+size_t TagHandleTable::getMemorySize() const
+{
+	size_t size = ( used + private_::slotsChunk - 1 ) / private_::slotsChunk * private_::slotsChunk * sizeof( Slot );
+	for( const Directory *it = directory.load( boost::memory_order_acquire ); it != NULL; it = it->previous )
+		size += sizeof( Directory ) + it->size * sizeof( Slot* );
+	return size;
+}
+
+} // namespace address_space
+} // namespace opc
+} // FatRat Library
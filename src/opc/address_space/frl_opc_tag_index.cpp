@@ -0,0 +1,219 @@
+#include "opc/address_space/frl_opc_tag_index.h"
+#include "opc/address_space/frl_opc_tag.h"
+
+namespace frl{ namespace opc{ namespace address_space{
+
+namespace private_
+{
+	const size_t minIndexCapacity = 16;
+
+	// marks removed entries, they keep chains of probing unbroken
+	char deletedEntry;
+
+	// load factor is not greater than 0.75
+	size_t getCapacity( size_t tagsNumber )
+	{
+		size_t capacity = minIndexCapacity;
+		while( capacity * 3 < tagsNumber * 4 )
+			capacity *= 2;
+		return capacity;
+	}
+} // namespace private_
+
+TagIndex::Entry::Entry()
+	:	hash( 0 ), tag( NULL )
+{
+}
+
+TagIndex::Table::Table( size_t capacity, Table *previous_ )
+	:	mask( capacity - 1 ),
+		entries( new Entry[ capacity ] ),
+		previous( previous_ )
+{
+}
+
+TagIndex::TagIndex()
+	:	table( NULL ), count( 0 ), used( 0 )
+{
+}
+
+TagIndex::~TagIndex()
+{
+	clear();
+}
+
+size_t TagIndex::hashOf( const String &id )
+{
+	return hashOf( id.data(), id.size() );
+}
+
+size_t TagIndex::hashOf( const Char *id, size_t length )
+{
+	// FNV-1a
+	size_t hash = (size_t)2166136261U;
+	for( const Char *end = id + length; id != end; ++id )
+	{
+		hash ^= (size_t)(*id);
+		hash *= (size_t)16777619U;
+	}
+	return hash;
+}
+
+Tag* TagIndex::deletedTag()
+{
+	return reinterpret_cast< Tag* >( &private_::deletedEntry );
+}
+
+size_t TagIndex::findPos( const Table *where, const PathView &id, size_t hash )
+{
+	size_t pos = hash & where->mask;
+	for( ;; )
+	{
+		const Tag *tag = where->entries[pos].tag.load( boost::memory_order_acquire );
+		if( tag == NULL
+			|| ( tag != deletedTag() && where->entries[pos].hash == hash && PathView( tag->getID() ) == id ) )
+			return pos;
+		pos = ( pos + 1 ) & where->mask;
+	}
+}
+
+void TagIndex::rehash( size_t newCapacity )
+{
+	Table *old = table.load( boost::memory_order_relaxed );
+	Table *grown = new Table( newCapacity, old );
+	used = 0;
+	for( size_t i = 0; old != NULL && i <= old->mask; ++i )
+	{
+		Tag *tag = old->entries[i].tag.load( boost::memory_order_relaxed );
+		if( tag == NULL || tag == deletedTag() )
+			continue;
+		size_t pos = old->entries[i].hash & grown->mask;
+		while( grown->entries[pos].tag.load( boost::memory_order_relaxed ) != NULL )
+			pos = ( pos + 1 ) & grown->mask;
+		grown->entries[pos].hash = old->entries[i].hash;
+		grown->entries[pos].tag.store( tag, boost::memory_order_relaxed );
+		++used;
+	}
+	table.store( grown, boost::memory_order_release );
+}
+
+void TagIndex::reserve( size_t tagsNumber )
+{
+	size_t capacity = private_::getCapacity( tagsNumber );
+	const Table *current = table.load( boost::memory_order_relaxed );
+	if( current == NULL || capacity > current->mask + 1 )
+		rehash( capacity );
+}
+
+size_t TagIndex::getMemorySize() const
+{
+	size_t size = 0;
+	for(	const Table *it = table.load( boost::memory_order_acquire );
+			it != NULL;
+			it = it->previous.load( boost::memory_order_acquire ) )
+		size += sizeof( Table ) + ( it->mask + 1 ) * sizeof( Entry );
+	return size;
+}
+
+Bool TagIndex::insert( Tag *tag )
+{
+	return insert( tag, hashOf( tag->getID() ) );
+}
+
+Bool TagIndex::insert( Tag *tag, size_t hash )
+{
+	reserve( count.load( boost::memory_order_relaxed ) + 1 );
+	Table *current = table.load( boost::memory_order_relaxed );
+	// removed entries are not reused: table is rebuilt when they fill it
+	if( ( used + 1 ) * 4 > ( current->mask + 1 ) * 3 )
+	{
+		rehash( private_::getCapacity( count.load( boost::memory_order_relaxed ) + 1 ) );
+		current = table.load( boost::memory_order_relaxed );
+	}
+	size_t pos = findPos( current, tag->getID(), hash );
+	if( current->entries[pos].tag.load( boost::memory_order_relaxed ) != NULL )
+		return False;
+	current->entries[pos].hash = hash;
+	current->entries[pos].tag.store( tag, boost::memory_order_release );
+	++used;
+	count.fetch_add( 1, boost::memory_order_relaxed );
+	return True;
+}
+
+void TagIndex::insertAll( const TagIndex &other )
+{
+	const Table *from = other.table.load( boost::memory_order_acquire );
+	if( from == NULL )
+		return;
+	reserve( size() + other.size() );
+	for( size_t i = 0; i <= from->mask; ++i )
+	{
+		Tag *tag = from->entries[i].tag.load( boost::memory_order_acquire );
+		if( tag != NULL && tag != deletedTag() )
+			insert( tag, from->entries[i].hash );
+	}
+}
+
+Bool TagIndex::erase( const PathView &id )
+{
+	Table *current = table.load( boost::memory_order_relaxed );
+	if( current == NULL )
+		return False;
+	size_t pos = findPos( current, id, hashOf( id.data(), id.size() ) );
+	if( current->entries[pos].tag.load( boost::memory_order_relaxed ) == NULL )
+		return False;
+	current->entries[pos].tag.store( deletedTag(), boost::memory_order_release );
+	count.fetch_sub( 1, boost::memory_order_relaxed );
+	return True;
+}
+
+Tag* TagIndex::find( const PathView &id ) const
+{
+	const Table *current = table.load( boost::memory_order_acquire );
+	if( current == NULL )
+		return NULL;
+	Tag *tag = current->entries[ findPos( current, id, hashOf( id.data(), id.size() ) ) ].tag.load( boost::memory_order_acquire );
+	// entry may be removed after it was found
+	return tag == deletedTag() ? NULL : tag;
+}
+
+Bool TagIndex::isExist( const PathView &id ) const
+{
+	return find( id ) != NULL;
+}
+
+size_t TagIndex::size() const
+{
+	return count.load( boost::memory_order_relaxed );
+}
+
+void TagIndex::takeReplaced( std::vector< Table* > &tables )
+{
+	Table *current = table.load( boost::memory_order_relaxed );
+	if( current == NULL )
+		return;
+	size_t number = 0;
+	for( Table *it = current->previous; it != NULL; it = it->previous )
+		++number;
+	tables.reserve( tables.size() + number );
+	for( Table *it = current->previous; it != NULL; it = it->previous )
+		tables.push_back( it );
+	current->previous.store( NULL, boost::memory_order_release );
+}
+
+void TagIndex::clear()
+{
+	Table *it = table.exchange( NULL );
+	while( it != NULL )
+	{
+		Table *previous = it->previous;
+		delete it;
+		it = previous;
+	}
+	count = 0;
+	used = 0;
+}
+
+} // namespace address_space
+} // namespace opc
+} // FatRat Library
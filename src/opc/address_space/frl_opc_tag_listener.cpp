@@ -0,0 +1,36 @@
+#include "opc/address_space/frl_opc_tag_listener.h"
+#include "opc/address_space/frl_opc_tag.h"
+
+namespace frl{ namespace opc{ namespace address_space{
+
+TagListener::TagListener()
+	:	tag( NULL ),
+		prevListener( NULL ),
+		nextListener( NULL )
+{
+}
+
+TagListener::~TagListener()
+{
+	unsubscribe();
+}
+
+Tag* TagListener::getListenedTag() const
+{
+	return tag.load( boost::memory_order_acquire );
+}
+
+void TagListener::unsubscribe()
+{
+	// removal of tag may unsubscribe listener meanwhile,
+	// so listened tag is checked again under lock of its listeners
+	for( Tag *listened = getListenedTag(); listened != NULL; listened = getListenedTag() )
+	{
+		if( Tag::unlinkListener( listened, this ) )
+			return;
+	}
+}
+
+} // namespace address_space
+} // namespace opc
+} // FatRat Library
@@ -0,0 +1,86 @@
+#include "opc/address_space/frl_opc_time_stamp.h"
+#if( FRL_PLATFORM != FRL_PLATFORM_WIN32 )
+#include <sys/time.h>
+#endif
+
+namespace frl{ namespace opc{ namespace address_space{
+
+namespace private_
+{
+	// Seconds between January 1, 1601 and January 1, 1970.
+	const ULong unixEpochOffset = 11644473600ULL;
+	// Ticks (100 ns) per day.
+	const Double ticksPerDay = 864000000000.0;
+	// Days between January 1, 1601 and December 30, 1899.
+	const Double dateEpochOffset = 109205.0;
+} // namespace private_
+
+TimeStamp::TimeStamp()
+	:	ticks( 0 )
+{
+}
+
+TimeStamp::TimeStamp( ULong ticks_ )
+	:	ticks( ticks_ )
+{
+}
+
+TimeStamp TimeStamp::now()
+{
+	#if( FRL_PLATFORM == FRL_PLATFORM_WIN32 )
+		FILETIME ft;
+		::GetSystemTimeAsFileTime( &ft );
+		return TimeStamp( ( (ULong)ft.dwHighDateTime << 32 ) | ft.dwLowDateTime );
+	#else
+		timeval tv;
+		::gettimeofday( &tv, NULL );
+		return TimeStamp( ( (ULong)tv.tv_sec + private_::unixEpochOffset ) * 10000000ULL + (ULong)tv.tv_usec * 10ULL );
+	#endif
+}
+
+ULong TimeStamp::getTicks() const
+{
+	return ticks;
+}
+
+void TimeStamp::setTicks( ULong ticks_ )
+{
+	ticks = ticks_;
+}
+
+Double TimeStamp::toDate() const
+{
+	return (Double)ticks / private_::ticksPerDay - private_::dateEpochOffset;
+}
+
+TimeStamp TimeStamp::fromDate( Double date )
+{
+	Double tmp = ( date + private_::dateEpochOffset ) * private_::ticksPerDay;
+	if( tmp < 0 )
+		return TimeStamp();
+	return TimeStamp( (ULong)( tmp + 0.5 ) );
+}
+
+Bool TimeStamp::isNull() const
+{
+	return ticks == 0;
+}
+
+Bool TimeStamp::operator == ( const TimeStamp &rhv ) const
+{
+	return ticks == rhv.ticks;
+}
+
+Bool TimeStamp::operator != ( const TimeStamp &rhv ) const
+{
+	return ticks != rhv.ticks;
+}
+
+Bool TimeStamp::operator < ( const TimeStamp &rhv ) const
+{
+	return ticks < rhv.ticks;
+}
+
+} // namespace address_space
+} // namespace opc
+} // FatRat Library
@@ -0,0 +1,665 @@
+#include "opc/address_space/frl_opc_value.h"
+#include <limits>
+#include "stream_std/frl_sstream.h"
+
+namespace frl{ namespace opc{ namespace address_space{
+
+namespace private_
+{
+	const Long currencyScale = 10000;
+
+	Bool isIntegerType( DataType type )
+	{
+		switch( type )
+		{
+			case data_type::I1:
+			case data_type::UI1:
+			case data_type::I2:
+			case data_type::UI2:
+			case data_type::I4:
+			case data_type::UI4:
+			case data_type::I8:
+			case data_type::UI8:
+			case data_type::BOOL:
+			return True;
+		}
+		return False;
+	}
+
+	template< typename T >
+	Bool inRange( Long val )
+	{
+		if( std::numeric_limits< T >::is_signed )
+			return val >= (Long)std::numeric_limits< T >::min() && val <= (Long)std::numeric_limits< T >::max();
+		return val >= 0 && (ULong)val <= (ULong)std::numeric_limits< T >::max();
+	}
+
+	template< typename T >
+	Bool inRange( double val )
+	{
+		return val >= (double)std::numeric_limits< T >::min() && val <= (double)std::numeric_limits< T >::max();
+	}
+} // namespace private_
+
+Value::Value()
+	:	type( data_type::EMPTY )
+{
+	data.ui8Val = 0;
+}
+
+Value::Value( bool cValue )
+	:	type( data_type::BOOL )
+{
+	data.ui8Val = 0;
+	data.boolVal = cValue;
+}
+
+Value::Value( char cValue )
+	:	type( data_type::I1 )
+{
+	data.ui8Val = 0;
+	data.i1Val = cValue;
+}
+
+Value::Value( unsigned char cValue )
+	:	type( data_type::UI1 )
+{
+	data.ui8Val = 0;
+	data.ui1Val = cValue;
+}
+
+Value::Value( short cValue )
+	:	type( data_type::I2 )
+{
+	data.ui8Val = 0;
+	data.i2Val = cValue;
+}
+
+Value::Value( unsigned short cValue )
+	:	type( data_type::UI2 )
+{
+	data.ui8Val = 0;
+	data.ui2Val = cValue;
+}
+
+Value::Value( int cValue )
+	:	type( data_type::I4 )
+{
+	data.ui8Val = 0;
+	data.i4Val = cValue;
+}
+
+Value::Value( unsigned int cValue )
+	:	type( data_type::UI4 )
+{
+	data.ui8Val = 0;
+	data.ui4Val = cValue;
+}
+
+Value::Value( long cValue )
+{
+	data.ui8Val = 0;
+	if( sizeof( long ) == sizeof( Int ) )
+	{
+		type = data_type::I4;
+		data.i4Val = (Int)cValue;
+	}
+	else
+	{
+		type = data_type::I8;
+		data.i8Val = cValue;
+	}
+}
+
+Value::Value( unsigned long cValue )
+{
+	data.ui8Val = 0;
+	if( sizeof( unsigned long ) == sizeof( UInt ) )
+	{
+		type = data_type::UI4;
+		data.ui4Val = (UInt)cValue;
+	}
+	else
+	{
+		type = data_type::UI8;
+		data.ui8Val = cValue;
+	}
+}
+
+Value::Value( Long cValue )
+	:	type( data_type::I8 )
+{
+	data.i8Val = cValue;
+}
+
+Value::Value( ULong cValue )
+	:	type( data_type::UI8 )
+{
+	data.ui8Val = cValue;
+}
+
+Value::Value( float cValue )
+	:	type( data_type::R4 )
+{
+	data.ui8Val = 0;
+	data.r4Val = cValue;
+}
+
+Value::Value( double cValue )
+	:	type( data_type::R8 )
+{
+	data.r8Val = cValue;
+}
+
+Value::Value( const TimeStamp &cValue )
+	:	type( data_type::DATE )
+{
+	data.r8Val = cValue.toDate();
+}
+
+Value::Value( const String &cValue )
+	:	type( data_type::STRING ), strVal( cValue )
+{
+	data.ui8Val = 0;
+}
+
+Value::Value( const Char *cValue )
+	:	type( data_type::STRING ), strVal( cValue )
+{
+	data.ui8Val = 0;
+}
+
+void Value::clear()
+{
+	type = data_type::EMPTY;
+	data.ui8Val = 0;
+	strVal.clear();
+}
+
+DataType Value::getType() const
+{
+	return type;
+}
+
+Bool Value::isValidType( DataType checkType )
+{
+	switch( checkType )
+	{
+		case data_type::EMPTY:
+		case data_type::I1:
+		case data_type::UI1:
+		case data_type::I2:
+		case data_type::UI2:
+		case data_type::I4:
+		case data_type::UI4:
+		case data_type::I8:
+		case data_type::UI8:
+		case data_type::R4:
+		case data_type::R8:
+		case data_type::CY:
+		case data_type::DATE:
+		case data_type::STRING:
+		case data_type::BOOL:
+		case data_type::ARRAY:
+		return True;
+	}
+	return False;
+}
+
+Bool Value::toDouble( double &dst ) const
+{
+	switch( type )
+	{
+		case data_type::R4:
+			dst = data.r4Val;
+			return True;
+		case data_type::R8:
+		case data_type::DATE:
+			dst = data.r8Val;
+			return True;
+		case data_type::CY:
+			dst = (double)data.i8Val / (double)private_::currencyScale;
+			return True;
+		case data_type::UI8:
+			dst = (double)data.ui8Val;
+			return True;
+		case data_type::STRING:
+		{
+			stream_std::InString ss( strVal );
+			ss >> dst;
+			return ! ss.fail() && ( ss >> std::ws ).eof();
+		}
+	}
+	Long tmp;
+	if( ! toLong( tmp ) )
+		return False;
+	dst = (double)tmp;
+	return True;
+}
+
+Bool Value::toLong( Long &dst ) const
+{
+	switch( type )
+	{
+		case data_type::BOOL:
+			dst = data.boolVal ? 1 : 0;
+			return True;
+		case data_type::I1:
+			dst = data.i1Val;
+			return True;
+		case data_type::UI1:
+			dst = data.ui1Val;
+			return True;
+		case data_type::I2:
+			dst = data.i2Val;
+			return True;
+		case data_type::UI2:
+			dst = data.ui2Val;
+			return True;
+		case data_type::I4:
+			dst = data.i4Val;
+			return True;
+		case data_type::UI4:
+			dst = data.ui4Val;
+			return True;
+		case data_type::I8:
+			dst = data.i8Val;
+			return True;
+		case data_type::UI8:
+			if( data.ui8Val > (ULong)std::numeric_limits< Long >::max() )
+				return False;
+			dst = (Long)data.ui8Val;
+			return True;
+		case data_type::STRING:
+		{
+			stream_std::InString ss( strVal );
+			ss >> dst;
+			return ! ss.fail() && ( ss >> std::ws ).eof();
+		}
+		case data_type::R4:
+		case data_type::R8:
+		case data_type::DATE:
+		case data_type::CY:
+			break;
+		default:
+			return False;
+	}
+	double tmp;
+	if( ! toDouble( tmp ) )
+		return False;
+	if( ! private_::inRange< Long >( tmp ) )
+		return False;
+	dst = (Long)( tmp < 0 ? tmp - 0.5 : tmp + 0.5 );
+	return True;
+}
+
+Bool Value::fromLong( DataType newType, Long src )
+{
+	switch( newType )
+	{
+		case data_type::BOOL:
+			data.boolVal = src != 0;
+			break;
+		case data_type::I1:
+			if( ! private_::inRange< char >( src ) )
+				return False;
+			data.i1Val = (char)src;
+			break;
+		case data_type::UI1:
+			if( ! private_::inRange< unsigned char >( src ) )
+				return False;
+			data.ui1Val = (unsigned char)src;
+			break;
+		case data_type::I2:
+			if( ! private_::inRange< short >( src ) )
+				return False;
+			data.i2Val = (short)src;
+			break;
+		case data_type::UI2:
+			if( ! private_::inRange< unsigned short >( src ) )
+				return False;
+			data.ui2Val = (unsigned short)src;
+			break;
+		case data_type::I4:
+			if( ! private_::inRange< Int >( src ) )
+				return False;
+			data.i4Val = (Int)src;
+			break;
+		case data_type::UI4:
+			if( ! private_::inRange< UInt >( src ) )
+				return False;
+			data.ui4Val = (UInt)src;
+			break;
+		case data_type::I8:
+			data.i8Val = src;
+			break;
+		case data_type::UI8:
+			if( src < 0 )
+				return False;
+			data.ui8Val = (ULong)src;
+			break;
+		default:
+			return fromDouble( newType, (double)src );
+	}
+	return True;
+}
+
+Bool Value::fromDouble( DataType newType, double src )
+{
+	switch( newType )
+	{
+		case data_type::R4:
+			data.r4Val = (float)src;
+			break;
+		case data_type::R8:
+		case data_type::DATE:
+			data.r8Val = src;
+			break;
+		case data_type::CY:
+			if( ! private_::inRange< Long >( src * private_::currencyScale ) )
+				return False;
+			data.i8Val = (Long)( src * private_::currencyScale + ( src < 0 ? -0.5 : 0.5 ) );
+			break;
+		default:
+		{
+			if( ! private_::inRange< Long >( src ) )
+				return False;
+			return fromLong( newType, (Long)( src < 0 ? src - 0.5 : src + 0.5 ) );
+		}
+	}
+	return True;
+}
+
+Bool Value::setType( DataType newType )
+{
+	if( newType == type )
+		return True;
+	if( ! isValidType( newType ) )
+		return False;
+
+	if( newType == data_type::EMPTY )
+	{
+		clear();
+		return True;
+	}
+
+	if( type == data_type::EMPTY )
+	{
+		data.ui8Val = 0;
+		strVal.clear();
+		type = newType;
+		return True;
+	}
+
+	if( newType == data_type::ARRAY || type == data_type::ARRAY )
+		return False;
+
+	Value tmp( *this );
+	if( newType == data_type::STRING )
+	{
+		stream_std::OutString ss;
+		switch( type )
+		{
+			case data_type::BOOL:
+				ss << ( data.boolVal ? FRL_STR( "True" ) : FRL_STR( "False" ) );
+				break;
+			case data_type::R4:
+				ss.precision( std::numeric_limits< float >::digits10 );
+				ss << data.r4Val;
+				break;
+			case data_type::R8:
+			case data_type::DATE:
+			case data_type::CY:
+			{
+				double d;
+				toDouble( d );
+				ss.precision( std::numeric_limits< double >::digits10 );
+				ss << d;
+				break;
+			}
+			case data_type::UI8:
+				ss << data.ui8Val;
+				break;
+			default:
+			{
+				Long l;
+				toLong( l );
+				ss << l;
+			}
+		}
+		tmp.data.ui8Val = 0;
+		tmp.strVal = ss.str();
+	}
+	else
+	{
+		tmp.strVal.clear();
+		if( type == data_type::STRING && newType == data_type::BOOL )
+		{
+			if( strVal == FRL_STR( "True" ) || strVal == FRL_STR( "true" ) )
+				tmp.data.boolVal = true;
+			else if( strVal == FRL_STR( "False" ) || strVal == FRL_STR( "false" ) )
+				tmp.data.boolVal = false;
+			else
+			{
+				Long l;
+				if( ! toLong( l ) )
+					return False;
+				tmp.data.boolVal = l != 0;
+			}
+		}
+		else if( newType == data_type::UI8 && type != data_type::STRING && ! private_::isIntegerType( type ) )
+		{
+			double d;
+			if( ! toDouble( d ) || ! private_::inRange< ULong >( d ) )
+				return False;
+			tmp.data.ui8Val = (ULong)( d + 0.5 );
+		}
+		else if( newType == data_type::UI8 && type == data_type::STRING )
+		{
+			stream_std::InString ss( strVal );
+			ULong ul;
+			ss >> ul;
+			if( ss.fail() || ! ( ss >> std::ws ).eof() || strVal.find( FRL_STR( '-' ) ) != String::npos )
+				return False;
+			tmp.data.ui8Val = ul;
+		}
+		else if( private_::isIntegerType( newType ) && ( private_::isIntegerType( type ) || type == data_type::STRING ) )
+		{
+			Long l;
+			if( ! toLong( l ) || ! tmp.fromLong( newType, l ) )
+				return False;
+		}
+		else
+		{
+			double d;
+			if( ! toDouble( d ) || ! tmp.fromDouble( newType, d ) )
+				return False;
+		}
+	}
+	tmp.type = newType;
+	*this = tmp;
+	return True;
+}
+
+Bool Value::operator == ( const Value &rhv ) const
+{
+	if( type != rhv.type )
+		return False;
+	switch( type )
+	{
+		case data_type::EMPTY:
+		case data_type::ARRAY:
+			return True;
+		case data_type::BOOL:
+			return data.boolVal == rhv.data.boolVal;
+		case data_type::I1:
+			return data.i1Val == rhv.data.i1Val;
+		case data_type::UI1:
+			return data.ui1Val == rhv.data.ui1Val;
+		case data_type::I2:
+			return data.i2Val == rhv.data.i2Val;
+		case data_type::UI2:
+			return data.ui2Val == rhv.data.ui2Val;
+		case data_type::I4:
+			return data.i4Val == rhv.data.i4Val;
+		case data_type::UI4:
+			return data.ui4Val == rhv.data.ui4Val;
+		case data_type::I8:
+		case data_type::CY:
+			return data.i8Val == rhv.data.i8Val;
+		case data_type::UI8:
+			return data.ui8Val == rhv.data.ui8Val;
+		case data_type::R4:
+			return data.r4Val == rhv.data.r4Val;
+		case data_type::R8:
+		case data_type::DATE:
+			return data.r8Val == rhv.data.r8Val;
+		case data_type::STRING:
+			return strVal == rhv.strVal;
+	}
+	return False;
+}
+
+Bool Value::operator != ( const Value &rhv ) const
+{
+	return ! ( *this == rhv );
+}
+
+Value::operator bool() const
+{
+	if( type != data_type::BOOL )
+		FRL_THROW_S_CLASS( InvalidType );
+	return data.boolVal;
+}
+
+Value::operator char() const
+{
+	if( type != data_type::I1 )
+		FRL_THROW_S_CLASS( InvalidType );
+	return data.i1Val;
+}
+
+Value::operator unsigned char() const
+{
+	if( type != data_type::UI1 )
+		FRL_THROW_S_CLASS( InvalidType );
+	return data.ui1Val;
+}
+
+Value::operator short() const
+{
+	if( type != data_type::I2 )
+		FRL_THROW_S_CLASS( InvalidType );
+	return data.i2Val;
+}
+
+Value::operator unsigned short() const
+{
+	if( type != data_type::UI2 )
+		FRL_THROW_S_CLASS( InvalidType );
+	return data.ui2Val;
+}
+
+Value::operator int() const
+{
+	if( type != data_type::I4 )
+		FRL_THROW_S_CLASS( InvalidType );
+	return data.i4Val;
+}
+
+Value::operator unsigned int() const
+{
+	if( type != data_type::UI4 )
+		FRL_THROW_S_CLASS( InvalidType );
+	return data.ui4Val;
+}
+
+Value::operator long() const
+{
+	if( type == data_type::I4 )
+		return data.i4Val;
+	if( type == data_type::I8 && sizeof( long ) == sizeof( Long ) )
+		return (long)data.i8Val;
+	FRL_THROW_S_CLASS( InvalidType );
+}
+
+Value::operator unsigned long() const
+{
+	if( type == data_type::UI4 )
+		return data.ui4Val;
+	if( type == data_type::UI8 && sizeof( unsigned long ) == sizeof( ULong ) )
+		return (unsigned long)data.ui8Val;
+	FRL_THROW_S_CLASS( InvalidType );
+}
+
+Value::operator Long() const
+{
+	if( type != data_type::I8 )
+		FRL_THROW_S_CLASS( InvalidType );
+	return data.i8Val;
+}
+
+Value::operator ULong() const
+{
+	if( type != data_type::UI8 )
+		FRL_THROW_S_CLASS( InvalidType );
+	return data.ui8Val;
+}
+
+Value::operator float() const
+{
+	if( type != data_type::R4 )
+		FRL_THROW_S_CLASS( InvalidType );
+	return data.r4Val;
+}
+
+Value::operator double() const
+{
+	if( type != data_type::R8 )
+		FRL_THROW_S_CLASS( InvalidType );
+	return data.r8Val;
+}
+
+Value::operator TimeStamp() const
+{
+	if( type != data_type::DATE )
+		FRL_THROW_S_CLASS( InvalidType );
+	return TimeStamp::fromDate( data.r8Val );
+}
+
+Value::operator String() const
+{
+	if( type != data_type::STRING )
+		FRL_THROW_S_CLASS( InvalidType );
+	return strVal;
+}
+
+Long Value::getCurrency() const
+{
+	if( type != data_type::CY )
+		FRL_THROW_S_CLASS( InvalidType );
+	return data.i8Val;
+}
+
+void Value::setCurrency( Long cyValue )
+{
+	strVal.clear();
+	type = data_type::CY;
+	data.i8Val = cyValue;
+}
+
+ULong Value::getRawData() const
+{
+	return data.ui8Val;
+}
+
+void Value::setRawData( DataType newType, ULong raw )
+{
+	strVal.clear();
+	type = newType;
+	data.ui8Val = raw;
+}
+
+} // namespace address_space
+} // namespace opc
+} // FatRat Library
@@ -0,0 +1,209 @@
+#include "opc/address_space/frl_opc_value_cell.h"
+
+namespace frl{ namespace opc{ namespace address_space{
+
+ValueCell::ValueCell( DataType type_, UShort quality_ )
+	:	sequence( 0 ),
+		type( type_ ),
+		quality( quality_ ),
+		data( 0 ),
+		timeStamp( TimeStamp::now().getTicks() )
+{
+	if( type_ == data_type::STRING )
+		strVal.reset( new String() );
+}
+
+UInt ValueCell::beginWrite()
+{
+	UInt seq = sequence.load( boost::memory_order_relaxed );
+	for( ;; )
+	{
+		if( ( seq & 1 ) == 0
+			&& sequence.compare_exchange_weak( seq, seq + 1, boost::memory_order_acquire, boost::memory_order_relaxed ) )
+			break;
+		seq = sequence.load( boost::memory_order_relaxed );
+	}
+	boost::atomic_thread_fence( boost::memory_order_release );
+	return seq + 1;
+}
+
+void ValueCell::endWrite( UInt seq )
+{
+	sequence.store( seq + 1, boost::memory_order_release );
+}
+
+void ValueCell::store( const Value &newVal, const boost::shared_ptr< const String > &newStr )
+{
+	type.store( newVal.type, boost::memory_order_relaxed );
+	data.store( newVal.data.ui8Val, boost::memory_order_relaxed );
+	if( newStr || strVal )
+		boost::atomic_store( &strVal, newStr );
+}
+
+namespace private_
+{
+	// String is copied before write section, so readers do not wait for allocation.
+	boost::shared_ptr< const String > makeString( const Value &val, const String &str )
+	{
+		if( val.getType() != data_type::STRING )
+			return boost::shared_ptr< const String >();
+		return boost::shared_ptr< const String >( new String( str ) );
+	}
+} // namespace private_
+
+void ValueCell::load( Value &toValue, const boost::shared_ptr< const String > &str ) const
+{
+	if( toValue.type == data_type::STRING && str )
+		toValue.strVal = *str;
+	else
+		toValue.strVal.clear();
+}
+
+Bool ValueCell::isEqual( const Value &val ) const
+{
+	// called only by writer, so fields are stable
+	if( val.type != type.load( boost::memory_order_relaxed ) )
+		return False;
+	Value tmp;
+	tmp.type = val.type;
+	tmp.data.ui8Val = data.load( boost::memory_order_relaxed );
+	if( tmp.type == data_type::STRING )
+		return strVal && *strVal == val.strVal;
+	return tmp == val;
+}
+
+void ValueCell::read( Value &toValue, UShort &toQuality, TimeStamp &toTimeStamp ) const
+{
+	boost::shared_ptr< const String > str;
+	for( ;; )
+	{
+		UInt seq = sequence.load( boost::memory_order_acquire );
+		if( seq & 1 )
+			continue;
+		toValue.type = type.load( boost::memory_order_relaxed );
+		toValue.data.ui8Val = data.load( boost::memory_order_relaxed );
+		toQuality = quality.load( boost::memory_order_relaxed );
+		toTimeStamp.setTicks( timeStamp.load( boost::memory_order_relaxed ) );
+		if( toValue.type == data_type::STRING )
+			str = boost::atomic_load( &strVal );
+		boost::atomic_thread_fence( boost::memory_order_acquire );
+		if( sequence.load( boost::memory_order_relaxed ) == seq )
+			break;
+	}
+	load( toValue, str );
+}
+
+Value ValueCell::getValue() const
+{
+	Value ret;
+	UShort q;
+	TimeStamp ts;
+	read( ret, q, ts );
+	return ret;
+}
+
+DataType ValueCell::getType() const
+{
+	for( ;; )
+	{
+		UInt seq = sequence.load( boost::memory_order_acquire );
+		if( seq & 1 )
+			continue;
+		DataType ret = type.load( boost::memory_order_relaxed );
+		boost::atomic_thread_fence( boost::memory_order_acquire );
+		if( sequence.load( boost::memory_order_relaxed ) == seq )
+			return ret;
+	}
+}
+
+UShort ValueCell::getQuality() const
+{
+	for( ;; )
+	{
+		UInt seq = sequence.load( boost::memory_order_acquire );
+		if( seq & 1 )
+			continue;
+		UShort ret = quality.load( boost::memory_order_relaxed );
+		boost::atomic_thread_fence( boost::memory_order_acquire );
+		if( sequence.load( boost::memory_order_relaxed ) == seq )
+			return ret;
+	}
+}
+
+TimeStamp ValueCell::getTimeStamp() const
+{
+	for( ;; )
+	{
+		UInt seq = sequence.load( boost::memory_order_acquire );
+		if( seq & 1 )
+			continue;
+		ULong ret = timeStamp.load( boost::memory_order_relaxed );
+		boost::atomic_thread_fence( boost::memory_order_acquire );
+		if( sequence.load( boost::memory_order_relaxed ) == seq )
+			return TimeStamp( ret );
+	}
+}
+
+Bool ValueCell::write( const Value &newVal, const TimeStamp &ts )
+{
+	boost::shared_ptr< const String > newStr = private_::makeString( newVal, newVal.strVal );
+	UInt seq = beginWrite();
+	if( isEqual( newVal ) )
+	{
+		endWrite( seq );
+		return False;
+	}
+	store( newVal, newStr );
+	timeStamp.store( ts.getTicks(), boost::memory_order_relaxed );
+	endWrite( seq );
+	return True;
+}
+
+Bool ValueCell::write( const Value &newVal, UShort newQuality, const TimeStamp &ts )
+{
+	boost::shared_ptr< const String > newStr = private_::makeString( newVal, newVal.strVal );
+	UInt seq = beginWrite();
+	if( isEqual( newVal ) && quality.load( boost::memory_order_relaxed ) == newQuality )
+	{
+		endWrite( seq );
+		return False;
+	}
+	store( newVal, newStr );
+	quality.store( newQuality, boost::memory_order_relaxed );
+	timeStamp.store( ts.getTicks(), boost::memory_order_relaxed );
+	endWrite( seq );
+	return True;
+}
+
+Bool ValueCell::setType( DataType newType )
+{
+	UInt seq = beginWrite();
+	Value tmp;
+	tmp.type = type.load( boost::memory_order_relaxed );
+	tmp.data.ui8Val = data.load( boost::memory_order_relaxed );
+	if( tmp.type == data_type::STRING && strVal )
+		tmp.strVal = *strVal;
+	Bool ret = tmp.setType( newType );
+	if( ret )
+		store( tmp, private_::makeString( tmp, tmp.strVal ) );
+	endWrite( seq );
+	return ret;
+}
+
+void ValueCell::setQuality( UShort newQuality )
+{
+	UInt seq = beginWrite();
+	quality.store( newQuality, boost::memory_order_relaxed );
+	endWrite( seq );
+}
+
+void ValueCell::setTimeStamp( const TimeStamp &ts )
+{
+	UInt seq = beginWrite();
+	timeStamp.store( ts.getTicks(), boost::memory_order_relaxed );
+	endWrite( seq );
+}
+
+} // namespace address_space
+} // namespace opc
+} // FatRat Library
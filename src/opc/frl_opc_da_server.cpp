@@ -8,7 +8,15 @@
 namespace frl{ namespace opc{
 
 DAServer::DAServer( const ServerType& serverType )
-	:	ServerKind( serverType )
+	:	ServerKind( serverType ),
+		addressSpace( NULL )
+{
+	isInit = False;
+}
+
+DAServer::DAServer( const ServerType& serverType, address_space::AddressSpace &addressSpace_ )
+	:	ServerKind( serverType ),
+		addressSpace( &addressSpace_ )
 {
 	isInit = False;
 }
@@ -49,6 +57,8 @@ frl::Bool DAServer::init()
 	}
 
 	factory.isOutProc( True );
+	if( addressSpace != NULL )
+		factory.setAddressSpace( *addressSpace );
 
 	hResult = ::CoRegisterClassObject( lexicalCast<frl::String,CLSID>( getCLSID() ), &factory, CLSCTX_LOCAL_SERVER |
 		CLSCTX_REMOTE_SERVER |
@@ -14,7 +14,8 @@ EnumString::EnumString()
 EnumString::EnumString( const EnumString& other )
 	:	refCount( 0 ),
 		curIndex( other.curIndex ),
-		strings( other.strings )
+		strings( other.strings ),
+		leafs( other.leafs ? new address_space::LeafEnumerator( *other.leafs ) : NULL )
 {
 }
 
@@ -70,6 +71,23 @@ STDMETHODIMP EnumString::Next( ULONG celt, LPOLESTR* rgelt, ULONG* pceltFetched
 		return E_POINTER;
 	}
 
+	if( leafs )
+	{
+		String id;
+		ULONG fetched = 0;
+		for( ; fetched < celt && leafs->next( id ); ++fetched )
+		{
+			#if( FRL_CHARACTER == FRL_CHARACTER_UNICODE )
+				rgelt[fetched] = util::duplicateString( id );
+			#else
+				rgelt[fetched] = util::duplicateString( string2wstring( id ) );
+			#endif
+		}
+		if( pceltFetched )
+			*pceltFetched = fetched;
+		return fetched == celt ? S_OK : S_FALSE;
+	}
+
 	if( curIndex >= strings.size() )
 		return S_FALSE;
 
@@ -105,6 +123,9 @@ STDMETHODIMP EnumString::Next( ULONG celt, LPOLESTR* rgelt, ULONG* pceltFetched
 
 STDMETHODIMP EnumString::Skip( ULONG celt )
 {
+	if( leafs )
+		return leafs->skip( celt ) == celt ? S_OK : S_FALSE;
+
 	if (curIndex + celt > strings.size())
 	{
 		curIndex = strings.size();
@@ -118,6 +139,8 @@ STDMETHODIMP EnumString::Skip( ULONG celt )
 STDMETHODIMP EnumString::Reset()
 {
 	curIndex = 0;
+	if( leafs )
+		leafs->reset();
 	return S_OK;
 }
 
@@ -142,6 +165,14 @@ STDMETHODIMP EnumString::Clone( IEnumString** ppEnum )
 void EnumString::init( const std::vector< String >& items )
 {
 	strings = items;
+	leafs.reset();
+	Reset();
+}
+
+void EnumString::init( const address_space::LeafEnumerator &leafs_ )
+{
+	strings.clear();
+	leafs.reset( new address_space::LeafEnumerator( leafs_ ) );
 	Reset();
 }
 
@@ -0,0 +1,175 @@
+#include <boost/bind.hpp>
+#include "opc/frl_opc_executor.h"
+
+namespace frl{ namespace opc{
+
+Executor::Strand::Strand( Executor &executor )
+	:	state( new State() )
+{
+	state->executor = &executor;
+	state->scheduled = False;
+}
+
+void Executor::Strand::post( const Task &task )
+{
+	boost::mutex::scoped_lock lock( state->guard );
+	state->tasks.push_back( task );
+	if( state->scheduled )
+		return;
+	state->scheduled = True;
+	state->executor->post( boost::bind( &Strand::runNext, state ) );
+}
+
+Executor::Strand::Next::Next( boost::shared_ptr< State > &state_ )
+	:	state( state_ )
+{
+}
+
+Executor::Strand::Next::~Next()
+{
+	boost::mutex::scoped_lock lock( state->guard );
+	if( state->tasks.empty() )
+	{
+		state->scheduled = False;
+		return;
+	}
+	try
+	{
+		state->executor->post( boost::bind( &Strand::runNext, state ) ); // other tasks wait not longer than one task of strand
+	}
+	catch( ... )
+	{
+		state->scheduled = False; // next post to strand runs it again
+	}
+}
+
+void Executor::Strand::runNext( boost::shared_ptr< State > state )
+{
+	Task task;
+	{
+		boost::mutex::scoped_lock lock( state->guard );
+		task.swap( state->tasks.front() );
+		state->tasks.pop_front();
+	}
+	Next next( state );
+	task();
+}
+
+Executor::Executor( UInt workersNumber )
+	:	current( &Executor::forget ),
+		queued( 0 ),
+		waiting( 0 ),
+		next( 0 ),
+		shutdown( False )
+{
+	if( workersNumber == 0 )
+		workersNumber = boost::thread::hardware_concurrency();
+	if( workersNumber == 0 )
+		workersNumber = 1;
+	for( UInt i = 0; i < workersNumber; ++i )
+		workers.push_back( new Worker() );
+	for( UInt i = 0; i < workersNumber; ++i )
+		threads.create_thread( boost::bind( &Executor::work, this, workers[i] ) );
+}
+
+Executor::~Executor()
+{
+	{
+		boost::mutex::scoped_lock lock( idleGuard );
+		shutdown = True;
+		idleCondition.notify_all();
+	}
+	threads.join_all();
+	for( size_t i = 0; i < workers.size(); ++i )
+		delete workers[i];
+}
+
+void Executor::forget( Worker* )
+{
+	// workers are owned by executor
+}
+
+void Executor::post( const Task &task )
+{
+	Worker *worker = current.get();
+	if( worker == NULL )
+		worker = workers[ next.fetch_add( 1, boost::memory_order_relaxed ) % workers.size() ];
+	// counted before it is queued, so it is never taken uncounted
+	queued.fetch_add( 1 );
+	{
+		boost::mutex::scoped_lock lock( worker->guard );
+		worker->tasks.push_back( task );
+	}
+	// waiting worker either sees task counted or is woken (both counters are seq_cst)
+	if( waiting.load() != 0 )
+	{
+		boost::mutex::scoped_lock lock( idleGuard );
+		idleCondition.notify_one();
+	}
+}
+
+Bool Executor::take( Worker *worker, Task &task )
+{
+	{
+		boost::mutex::scoped_lock lock( worker->guard );
+		if( ! worker->tasks.empty() )
+		{
+			task.swap( worker->tasks.front() );
+			worker->tasks.pop_front();
+			return True;
+		}
+	}
+	for( size_t i = 0; i < workers.size(); ++i )
+	{
+		Worker *victim = workers[i];
+		if( victim == worker )
+			continue;
+		boost::mutex::scoped_lock lock( victim->guard );
+		if( ! victim->tasks.empty() )
+		{
+			task.swap( victim->tasks.back() );
+			victim->tasks.pop_back();
+			return True;
+		}
+	}
+	return False;
+}
+
+void Executor::work( Worker *worker )
+{
+	current.reset( worker );
+	Task task;
+	for( ;; )
+	{
+		if( take( worker, task ) )
+		{
+			queued.fetch_sub( 1, boost::memory_order_relaxed );
+			try
+			{
+				task();
+			}
+			catch( ... )
+			{
+				// error of task does not stop worker
+			}
+			task.clear();
+			continue;
+		}
+		boost::mutex::scoped_lock lock( idleGuard );
+		waiting.fetch_add( 1 );
+		// counted task may be on its way into queue yet
+		while( queued.load() == 0 && ! shutdown )
+			idleCondition.wait( lock );
+		waiting.fetch_sub( 1, boost::memory_order_relaxed );
+		if( queued.load() == 0 )
+			return; // shutdown, all tasks are run
+	}
+}
+
+size_t Executor::getWorkersNumber() const
+{
+	return workers.size();
+}
+
+} // namespace opc
+} // FatRat Library
@@ -138,16 +138,20 @@ GroupElem Group::clone()
 	newGroup->lastUpdate = lastUpdate;
 	newGroup->localeID = localeID;
 	newGroup->server = server;
+	newGroup->addressSpace = addressSpace;
 	newGroup->timeBias = timeBias;
 	newGroup->updateRate = updateRate;
 	newGroup->clientHandle = clientHandle;
 	newGroup->deleted = deleted;
 
-	GroupItemElemList::const_iterator end = itemList.end();
-	for( GroupItemElemList::const_iterator it = itemList.begin(); it != end; ++it )
+	boost::mutex::scoped_lock guard( groupGuard );
+	for( size_t slot = 0; slot < items.getSlots(); ++slot )
 	{
-		GroupItemElem item( (*it).second->clone() );
-		newGroup->itemList.insert( std::pair< OPCHANDLE, GroupItemElem > ( item->getServerHandle(), item ) );
+		if( ! items.isUsed( slot ) )
+			continue;
+		GroupItemElem item( items.getItem( slot )->clone() );
+		OPCHANDLE handle = newGroup->items.insert( item, items.getClientHandle( slot ), items.isActive( slot ), items.getDeadband( slot ) );
+		item->attach( &newGroup->changeQueue, handle );
 	}
 	return newGroup;
 }
@@ -4,18 +4,23 @@
 #include "../dependency/vendors/opc_foundation/opcerror.h"
 #include "opc/address_space/frl_opc_tag.h"
 #include "opc/frl_opc_group.h"
+#include "opc/frl_opc_server.h"
 
 using namespace frl::opc::address_space;
 
 namespace frl{ namespace opc{
 
 GroupBase::GroupBase()
+	:	server( NULL ),
+		addressSpace( NULL )
 {
 	Init();
 }
 
 GroupBase::GroupBase( const String &groupName )
-	:	name( groupName )
+	:	name( groupName ),
+		server( NULL ),
+		addressSpace( NULL )
 {
 	Init();
 }
@@ -50,22 +55,47 @@ void GroupBase::isDeleted( Bool deleteFlag )
 	deleted = deleteFlag;
 }
 
-void GroupBase::onUpdateTimer()
+Bool GroupBase::onUpdateTimer()
 {
+	// inactive or not connected group is polled: its changes are not taken
 	if( ! actived )
-		return;
+		return False;
 
 	boost::mutex::scoped_lock guard( groupGuard );
 
 	if( ! isConnected( IID_IOPCDataCallback ) )
-		return;
+		return False;
+
+	// only items changed since last update are checked
+	changeQueue.take( changedHandles );
+	changedSlots.clear();
+	deadbandFilter.clear();
+	Double sentValue, currentValue, threshold;
+	for( size_t i = 0; i < changedHandles.size(); ++i )
+	{
+		size_t slot = items.find( changedHandles[i] );
+		if( slot == GroupItemTable::npos )
+			continue; // item removed
+		const GroupItemElem &item = items.getItem( slot );
+		item->clearDirty();
+		if( items.isActive( slot ) && item->isChange() )
+		{
+			Float percent = items.getDeadband( slot );
+			item->getDeadbandCheck( percent == invalidDeadBand ? deadband : percent, sentValue, currentValue, threshold );
+			deadbandFilter.add( sentValue, currentValue, threshold );
+			changedSlots.push_back( slot );
+		}
+	}
 
+	// all changes are checked by deadband at once
+	deadbandFilter.run();
 	std::list< OPCHANDLE > handles;
-	GroupItemElemList::iterator end = itemList.end();
-	for( GroupItemElemList::iterator it = itemList.begin(); it != end; ++it )
+	for( size_t i = 0; i < changedSlots.size(); ++i )
 	{
-		if( (*it).second->isChange() && (*it).second->isActived() )
-			handles.push_back( (*it).first );
+		if( ! deadbandFilter.isPassed( i ) )
+			continue; // suppressed item is checked again on its next change
+		items.getItem( changedSlots[i] )->setSent();
+		handles.push_back( items.getHandle( changedSlots[i] ) );
 	}
 
 	if( ! handles.empty() )
@@ -74,12 +104,12 @@ void GroupBase::onUpdateTimer()
 		GroupElem tmp = GroupElem( dynamic_cast< Group* >( this ) );
 		AsyncRequestListElem request( new AsyncRequest( tmp, async_request::UPDATE, handles) );
 		request->setTransactionID( 0 );
-		doAsyncRefresh( request );	
+		doAsyncRefresh( request, True );
 	}
 
 	if( keepAlive == 0 ) // keep alive not used
 	{
-		return;
+		return True;
 	}
 
 	FILETIME curTime;
@@ -91,8 +121,44 @@ void GroupBase::onUpdateTimer()
 		GroupElem tmp = GroupElem( dynamic_cast< Group* >( this ) );
 		AsyncRequestListElem request( new AsyncRequest( tmp, async_request::UPDATE, handles) );
 		request->setTransactionID( 0 );
-		doAsyncRefresh( request );	
+		doAsyncRefresh( request, True );
 	}
+	return False;
+}
+
+void GroupBase::setItemActived( size_t slot, Bool activedFlag )
+{
+	// changes while item was inactive were dropped by onUpdateTimer
+	if( activedFlag && ! items.isActive( slot ) )
+		items.getItem( slot )->markChanged();
+	items.setActive( slot, activedFlag );
+	items.getItem( slot )->setDemand( activedFlag && actived );
+}
+
+void GroupBase::updateItemsDemand()
+{
+	for( size_t slot = 0; slot < items.getSlots(); ++slot )
+	{
+		if( items.isUsed( slot ) )
+			items.getItem( slot )->setDemand( items.isActive( slot ) && actived );
+	}
+}
+
+void GroupBase::setWakeUp( const boost::function< void() > &wakeUp )
+{
+	changeQueue.setWakeUp( wakeUp );
+}
+
+ULong GroupBase::getDeadbandChecked()
+{
+	boost::mutex::scoped_lock guard( groupGuard );
+	return deadbandFilter.getChecked();
+}
+
+ULong GroupBase::getSuppressedUpdates()
+{
+	boost::mutex::scoped_lock guard( groupGuard );
+	return deadbandFilter.getSuppressed();
 }
 
 void GroupBase::doAsyncRead( IOPCDataCallback* callBack, const AsyncRequestListElem &request )
@@ -145,15 +211,14 @@ void GroupBase::doAsyncRead( IOPCDataCallback* callBack, const AsyncRequestListE
 	}
 
 	HRESULT masterError = S_OK;	
-	GroupItemElemList::iterator iter;
-	GroupItemElemList::iterator groupIterEnd = itemList.end();
+	boost::mutex::scoped_lock guard( groupGuard ); // items are not changed meanwhile
 
 	const std::list< ItemHVQT >  *handles = &request->getItemHVQTList();
 	size_t i = 0;
 	BOOST_FOREACH( const ItemHVQT& el, *handles )
 	{
-		iter = itemList.find( el.getHandle() );
-		if( iter == groupIterEnd )
+		size_t slot = items.find( el.getHandle() );
+		if( slot == GroupItemTable::npos )
 		{
 			masterError = S_FALSE;
 			pErrors[i] = OPC_E_INVALIDHANDLE;
@@ -161,15 +226,16 @@ void GroupBase::doAsyncRead( IOPCDataCallback* callBack, const AsyncRequestListE
 			continue;
 		}
 
-		pHandles[i] = iter->second->getClientHandle();
+		pHandles[i] = items.getClientHandle( slot );
+		const GroupItemElem &item = items.getItem( slot );
 
 		try
 		{
-			pErrors[i] = ( iter->second->readValue() ).copyTo( pValue[i] );
+			pErrors[i] = ( item->readValue() ).copyTo( pValue[i] );
 		}
 		catch( Tag::NotExistTag& )
 		{
-			pErrors[i] = OPC_E_INVALIDHANDLE;
+			pErrors[i] = OPC_E_UNKNOWNITEMID;
 		}
 
 		if( FAILED( pErrors[i] ) )
@@ -179,11 +245,12 @@ void GroupBase::doAsyncRead( IOPCDataCallback* callBack, const AsyncRequestListE
 			continue;
 		}
 
-		pQuality[i] = iter->second->getQuality();
-		pTimeStamp[i] = iter->second->getTimeStamp();
+		pQuality[i] = item->getQuality();
+		pTimeStamp[i] = item->getTimeStamp();
 		++i;
 	}
 
+	guard.unlock();
 	callBack->OnReadComplete(	request->getTransactionID(),
 		clientHandle,
 		S_OK,
@@ -201,7 +268,7 @@ void GroupBase::doAsyncRead( IOPCDataCallback* callBack, const AsyncRequestListE
 	os::win32::com::freeMemory( pErrors );
 }
 
-void GroupBase::doAsyncRefresh( const AsyncRequestListElem &request )
+void GroupBase::doAsyncRefresh( const AsyncRequestListElem &request, Bool checked )
 {
 	IOPCDataCallback* callBack = NULL;
 	HRESULT hResult = getCallback( IID_IOPCDataCallback, (IUnknown**)&callBack );
@@ -280,31 +347,37 @@ void GroupBase::doAsyncRefresh( const AsyncRequestListElem &request )
 		return;
 	}
 
-	GroupItemElemList::iterator iter;
-	GroupItemElemList::iterator groupIterEnd = itemList.end();
 	
 	const std::list< ItemHVQT >  *handles = &request->getItemHVQTList();
 	size_t i = 0;	
 	BOOST_FOREACH( const ItemHVQT& el, *handles )
 	{
-		iter = itemList.find( el.getHandle() );
-		if( iter == groupIterEnd )
+		size_t slot = items.find( el.getHandle() );
+		if( slot == GroupItemTable::npos )
 		{
 			pErrors[i] = OPC_E_INVALIDHANDLE;
 			++i;
 			continue;
 		}
-		pHandles[i] = iter->second->getClientHandle();
+		pHandles[i] = items.getClientHandle( slot );
+		const GroupItemElem &item = items.getItem( slot );
+		if( checked )
+		{
+			// not newer VQT than one which passed deadband
+			pErrors[i] = item->getChecked( pValue[i], pQuality[i], pTimeStamp[i] );
+			++i;
+			continue;
+		}
 		try
 		{
 			if( request->getSource() == OPC_DS_CACHE )
-				pErrors[i] = iter->second->getCachedValue().copyTo( pValue[i] );
+				pErrors[i] = item->getCachedValue().copyTo( pValue[i] );
 			else
-				pErrors[i] = iter->second->readValue().copyTo( pValue[i] );
+				pErrors[i] = item->readValue().copyTo( pValue[i] );
 		}
 		catch( Tag::NotExistTag& )
 		{
-			pErrors[i] = OPC_E_INVALIDHANDLE;
+			pErrors[i] = OPC_E_UNKNOWNITEMID;
 		}
 
 		if( FAILED( pErrors[i] ) )
@@ -313,8 +386,8 @@ void GroupBase::doAsyncRefresh( const AsyncRequestListElem &request )
 			continue;
 		}
 
-		pQuality[i] = iter->second->getQuality();
-		pTimeStamp[i] = iter->second->getTimeStamp();
+		pQuality[i] = item->getQuality();
+		pTimeStamp[i] = item->getTimeStamp();
 		++i;
 	}
 
@@ -356,24 +429,32 @@ void GroupBase::doAsyncWrite( IOPCDataCallback* callBack, const AsyncRequestList
 	}
 
 	HRESULT masterError = S_OK;
-	GroupItemElemList::iterator iter;
-	GroupItemElemList::iterator groupIterEnd = itemList.end();
-	
+	boost::mutex::scoped_lock guard( groupGuard ); // items are not changed meanwhile
+
 	const std::list< ItemHVQT >  *handles = &request->getItemHVQTList();
 	size_t i = 0;
 	BOOST_FOREACH( const ItemHVQT& el, *handles )
 	{
-		iter = itemList.find( el.getHandle() );
-		if( iter == groupIterEnd )
+		size_t slot = items.find( el.getHandle() );
+		if( slot == GroupItemTable::npos )
 		{
 			masterError = S_FALSE;
 			pErrors[i] = OPC_E_INVALIDHANDLE;
 			++i;
 			continue;
 		}
-		pHandles[i] = iter->second->getClientHandle();
+		pHandles[i] = items.getClientHandle( slot );
+		const GroupItemElem &item = items.getItem( slot );
 
-		if( ! iter->second->isWritable() )
+		if( ! item->isTagExist() )
+		{
+			masterError = S_FALSE;
+			pErrors[i] = OPC_E_UNKNOWNITEMID;
+			++i;
+			continue;
+		}
+
+		if( ! item->isWritable() )
 		{
 			masterError = S_FALSE;
 			pErrors[i] = OPC_E_BADRIGHTS;
@@ -389,7 +470,10 @@ void GroupBase::doAsyncWrite( IOPCDataCallback* callBack, const AsyncRequestList
 			continue;
 		}
 
-		pErrors[i] = iter->second->writeValue( el.getValue() );
+		WORD quality = el.getQuality();
+		pErrors[i] = item->writeValue( el.getValue(),
+			el.isQualitySpecified() ? &quality : NULL,
+			el.isTimeStampSpecified() ? &el.getTimeStamp() : NULL );
 
 		if( FAILED( pErrors[i] ) )
 		{
@@ -397,19 +481,10 @@ void GroupBase::doAsyncWrite( IOPCDataCallback* callBack, const AsyncRequestList
 			++i;
 			continue;
 		}
-
-		if( el.isQualitySpecified() )
-		{
-			iter->second->setQuality( el.getQuality() );
-		}
-
-		if( el.isTimeStampSpecified() )
-		{
-			iter->second->setTimeStamp( el.getTimeStamp() );
-		}
 		++i;
 	}
 
+	guard.unlock();
 	callBack->OnWriteComplete(	request->getTransactionID(),
 		clientHandle,
 		masterError,
@@ -423,6 +498,7 @@ void GroupBase::doAsyncWrite( IOPCDataCallback* callBack, const AsyncRequestList
 void GroupBase::setServerPtr( OPCServer *serverPtr )
 {
 	server = serverPtr;
+	addressSpace = &serverPtr->getAddressSpace();
 }
 
 const String GroupBase::getName()
@@ -3,28 +3,36 @@
 #include "opc/frl_opc_group_item.h"
 #include "../dependency/vendors/opc_foundation/opcerror.h"
 #include "opc/address_space/frl_opc_address_space.h"
+#include "opc/frl_opc_util.h"
 
 using namespace frl::opc::address_space;
 
 namespace frl{ namespace opc{
 
-GroupItem::GroupItem()
-	:	clientHandle( 0 ),
-		actived( False ),
+GroupItem::GroupItem( address_space::AddressSpace &space_ )
+	:	space( &space_ ),
+		demanding( False ),
 		requestDataType( VT_EMPTY ),
-		tagRef( NULL ),
-		deadBand( invalidDeadBand )
+		sentValue( 0 ),
+		sentQuality( 0 ),
+		sent( False ),
+		checkedExist( False ),
+		checkedValue( 0 ),
+		checkedQuality( 0 ),
+		checked( False )
 {
 	resetTimeStamp();
+	checkedTimeStamp = lastChange;
 }
 
 GroupItem::~GroupItem()
 {
+	setDemand( False );
+	unsubscribe();
 }
 
 void GroupItem::Init( OPCITEMDEF &itemDef )
 {
-	clientHandle = itemDef.hClient;
 	#if( FRL_CHARACTER == FRL_CHARACTER_UNICODE )
 		if( itemDef.szItemID )
 			itemID = itemDef.szItemID;
@@ -36,24 +44,33 @@ void GroupItem::Init( OPCITEMDEF &itemDef )
 		if( itemDef.szAccessPath )
 			accessPath = wstring2string( itemDef.szAccessPath );
 	#endif
-	
-	actived = ( itemDef.bActive == TRUE || itemDef.bActive == VARIANT_TRUE );
 	requestDataType = itemDef.vtRequestedDataType;
 }
 
-void GroupItem::isActived( Bool activedFlag )
+void GroupItem::attach( address_space::ChangeQueue *queue, OPCHANDLE serverHandle )
 {
-	actived = activedFlag;
+	setQueue( queue, serverHandle );
+	PinnedTag tag( *this );
+	if( tag.get() != NULL )
+		tag->addListener( this );
+	markChanged();
 }
 
-frl::Bool GroupItem::isActived() const
+void GroupItem::setDemand( Bool demand )
 {
-	return actived;
-}
-
-void GroupItem::setClientHandle( OPCHANDLE handle )
-{
-	clientHandle = handle;
+	if( demand == demanding )
+		return;
+	PinnedTag tag( *this );
+	if( tag.get() == NULL )
+	{
+		demanding = False; // demand of removed tag is gone with it
+		return;
+	}
+	if( demand )
+		tag->addDemand();
+	else
+		tag->releaseDemand();
+	demanding = demand;
 }
 
 void GroupItem::setRequestDataType( VARTYPE type )
@@ -61,11 +78,6 @@ void GroupItem::setRequestDataType( VARTYPE type )
 	requestDataType = type;
 }
 
-OPCHANDLE GroupItem::getClientHandle() const
-{
-	return clientHandle;
-}
-
 const String& GroupItem::getItemID() const
 {
 	return itemID;
@@ -81,34 +93,70 @@ VARTYPE GroupItem::getReguestDataType() const
 	return requestDataType;
 }
 
-const os::win32::com::Variant& GroupItem::readValue()
+GroupItem::PinnedTag::PinnedTag( GroupItem &item )
+	:	version( item.space->getVersion() ),
+		tag( item.getTag() )
 {
-	if( tagRef == NULL )
-		tagRef = opcAddressSpace::getInstance().getLeaf( itemID );
-
-	cachedValue = tagRef->read();
-	lastChange = tagRef->getTimeStamp();
-	return cachedValue;
 }
 
-HRESULT GroupItem::writeValue( const VARIANT &newValue )
+Tag* GroupItem::getTag()
 {
-	try
+	if( tagHandle.isNull() )
 	{
-		if( tagRef == NULL )
-			tagRef = opcAddressSpace::getInstance().getLeaf( itemID );
+		Tag *tag = space->findLeaf( itemID );
+		tagHandle = space->getHandle( tag );
+		return tag;
 	}
-	catch( Tag::NotExistTag& )
+	return space->findTag( tagHandle );
+}
+
+const os::win32::com::Variant& GroupItem::readValue()
+{
+	PinnedTag tag( *this );
+	if( tag.get() == NULL )
 	{
-		return OPC_E_INVALIDHANDLE;
+		resetTimeStamp(); // removal of tag is reported once
+		FRL_THROW_S_CLASS( Tag::NotExistTag );
 	}
+
+	Value value;
+	UShort quality;
+	TimeStamp timeStamp;
+	tag->read( value, quality, timeStamp );
+	util::valueToVariant( value, cachedValue.getRef() );
+	lastChange = util::timeStampToFileTime( timeStamp );
+	return cachedValue;
+}
+
+HRESULT GroupItem::writeValue( const VARIANT &newValue )
+{
+	return writeValue( newValue, NULL, NULL );
+}
+
+HRESULT GroupItem::writeValue( const VARIANT &newValue, const WORD *quality, const FILETIME *timeStamp )
+{
+	PinnedTag tag( *this );
+	if( tag.get() == NULL )
+		return OPC_E_UNKNOWNITEMID;
 	VARIANT tmp;
 	::VariantInit( &tmp );
 	os::win32::com::Variant::variantCopy( &tmp, &newValue );
-	HRESULT result = ::VariantChangeType( &tmp, &tmp, 0, tagRef->getCanonicalDataType() );
+	HRESULT result = ::VariantChangeType( &tmp, &tmp, 0, tag->getCanonicalDataType() );
 	if( FAILED( result) )
+	{
+		::VariantClear( &tmp );
 		return result;
-	tagRef->writeFromOPC( tmp );
+	}
+	Value value;
+	result = util::variantToValue( tmp, value );
+	::VariantClear( &tmp );
+	if( FAILED( result ) )
+		return result;
+	if( quality == NULL && timeStamp == NULL )
+		tag->writeFromOPC( value );
+	else
+		tag->writeFromOPC( value, quality != NULL ? *quality : tag->getQuality(),
+			timeStamp != NULL ? util::fileTimeToTimeStamp( *timeStamp ) : TimeStamp::now() );
 	return S_OK;
 }
 
@@ -119,42 +167,46 @@ const FILETIME& GroupItem::getTimeStamp() const
 
 DWORD GroupItem::getAccessRights()
 {
-	if( tagRef == NULL )
-		tagRef = opcAddressSpace::getInstance().getLeaf( itemID );
+	PinnedTag tag( *this );
+	if( tag.get() == NULL )
+		return 0;
 
-	return tagRef->getAccessRights();
+	return tag->getAccessRights();
 }
 
 WORD GroupItem::getQuality()
 {
-	if( tagRef == NULL )
-		tagRef = opcAddressSpace::getInstance().getLeaf( itemID );
+	PinnedTag tag( *this );
+	if( tag.get() == NULL )
+		return OPC_QUALITY_BAD;
 
-	return tagRef->getQuality();
+	return tag->getQuality();
 }
 
 frl::Bool GroupItem::isChange()
 {
-	if( tagRef == NULL )
-		tagRef = opcAddressSpace::getInstance().getLeaf( itemID );
+	PinnedTag tag( *this );
+	// removed tag is changed until removal is reported by readValue
+	if( tag.get() == NULL )
+		return ! tagHandle.isNull() && ( lastChange.dwHighDateTime != 0 || lastChange.dwLowDateTime != 0 );
 
-	FILETIME tmp = tagRef->getTimeStamp();
+	FILETIME tmp = util::timeStampToFileTime( tag->getTimeStamp() );
 	return ( ( lastChange.dwHighDateTime != tmp.dwHighDateTime)
 				|| ( lastChange.dwLowDateTime != tmp.dwLowDateTime ) );
 }
 
 GroupItem* GroupItem::clone() const
 {
-	GroupItem *grItem= new GroupItem();
-	grItem->clientHandle = clientHandle;
-	grItem->actived = actived;
+	GroupItem *grItem= new GroupItem( *space );
 	grItem->accessPath = accessPath;
 	grItem->itemID = itemID;
 	grItem->requestDataType = requestDataType;
 	grItem->lastChange = lastChange;
 	grItem->cachedValue = cachedValue;
-	grItem->tagRef = tagRef;
-	grItem->deadBand = deadBand;
+	grItem->tagHandle = tagHandle;
+	grItem->sentValue = sentValue;
+	grItem->sentQuality = sentQuality;
+	grItem->sent = sent;
 	return grItem;
 }
 
@@ -171,40 +223,101 @@ void GroupItem::resetTimeStamp()
 
 void GroupItem::setTimeStamp( const FILETIME& ts )
 {
-	if( tagRef == NULL )
-		tagRef = opcAddressSpace::getInstance().getLeaf( itemID );
-	tagRef->setTimeStamp( ts );
+	PinnedTag tag( *this );
+	if( tag.get() == NULL )
+		return;
+	tag->setTimeStamp( util::fileTimeToTimeStamp( ts ) );
 }
 
 void GroupItem::setQuality( WORD quality )
 {
-	if( tagRef == NULL )
-		tagRef = opcAddressSpace::getInstance().getLeaf( itemID );
-	tagRef->setQuality( quality );
+	PinnedTag tag( *this );
+	if( tag.get() == NULL )
+		return;
+	tag->setQuality( quality );
 }
 
-void GroupItem::setDeadBand( Float newDeadBand )
+frl::Bool GroupItem::isAnalog()
 {
-	deadBand = newDeadBand;
+	PinnedTag tag( *this );
+	if( tag.get() == NULL )
+		return False;
+	return tag->isAnalog();
 }
 
-frl::Float GroupItem::getDeadBand()
+void GroupItem::getDeadbandCheck( Float percent, Double &sentValue_, Double &currentValue, Double &threshold )
 {
-	return deadBand;
+	sentValue_ = 0;
+	currentValue = 0;
+	threshold = DeadbandFilter::noDeadband;
+	checked = False;
+	PinnedTag tag( *this );
+	checkedExist = tag.get() != NULL;
+	if( tag.get() == NULL )
+		return;
+	Value value;
+	UShort quality;
+	TimeStamp timeStamp;
+	tag->read( value, quality, timeStamp );
+	util::valueToVariant( value, checkedVariant.getRef() );
+	checkedTimeStamp = util::timeStampToFileTime( timeStamp );
+	checkedQuality = quality;
+	if( ! tag->isAnalog() || value.getType() == data_type::EMPTY || ! value.setType( data_type::R8 ) )
+		return; // value is not numeric
+	checkedValue = value;
+	checked = True;
+	currentValue = checkedValue;
+	if( ! sent || sentQuality != quality )
+		return;
+	sentValue_ = sentValue;
+	threshold = DeadbandFilter::getThreshold( percent, tag->getLowEU(), tag->getHighEU() );
+}
+
+HRESULT GroupItem::getChecked( VARIANT &value, WORD &quality, FILETIME &timeStamp )
+{
+	if( ! checkedExist )
+	{
+		resetTimeStamp(); // removal of tag is reported once
+		return OPC_E_UNKNOWNITEMID;
+	}
+	cachedValue = checkedVariant;
+	lastChange = checkedTimeStamp;
+	quality = checkedQuality;
+	timeStamp = checkedTimeStamp;
+	return cachedValue.copyTo( value );
+}
+
+void GroupItem::setSent()
+{
+	sent = checked;
+	sentValue = checkedValue;
+	sentQuality = checkedQuality;
 }
 
 frl::Bool GroupItem::isWritable()
 {
-	if( tagRef == NULL )
-		tagRef = opcAddressSpace::getInstance().getLeaf( itemID );
-	return tagRef->isWritable();
+	PinnedTag tag( *this );
+	if( tag.get() == NULL )
+		return False;
+	return tag->isWritable();
 }
 
 frl::Bool GroupItem::isReadable()
 {
-	if( tagRef == NULL )
-		tagRef = opcAddressSpace::getInstance().getLeaf( itemID );
-	return tagRef->isReadable();
+	PinnedTag tag( *this );
+	if( tag.get() == NULL )
+		return False;
+	return tag->isReadable();
+}
+
+frl::Bool GroupItem::isTagExist()
+{
+	return PinnedTag( *this ).get() != NULL;
+}
+
+address_space::AddressSpace& GroupItem::getAddressSpace() const
+{
+	return *space;
 }
 
 } // namespace opc
@@ -1,26 +1,41 @@
 #include "frl_platform.h"
 #if( FRL_PLATFORM == FRL_PLATFORM_WIN32 )
-#include <Windows.h>
+#include <boost/bind.hpp>
 #include "opc/frl_opc_group_manager.h"
 #include "opc/frl_opc_group.h"
 
 namespace frl{ namespace opc{
 
+namespace private_
+{
+	// Task of scheduler, holds group while it is scheduled.
+	// Group without changes sleeps until its item changes.
+	UInt updateGroup( GroupElem group )
+	{
+		if( group->onUpdateTimer() )
+			return UpdateScheduler::idle;
+		return group->getUpdateRate();
+	}
+} // namespace private_
+
 GroupManager::GroupManager()
+	:	scheduler( opcUpdateScheduler::getInstance() )
 {
-	updateThread = boost::thread(boost::bind( &GroupManager::updateGroups, this ) );
+	scheduler.start();
 }
 
 GroupManager::~GroupManager()
 {
-	stopUpdate.signal();
-	updateThread.join();
+	for( GroupElemHandlesMap::iterator it = handles_map.begin(); it != handles_map.end(); ++it )
+		scheduler.remove( it->first );
 }
 
 void GroupManager::insert( GroupElem& group )
 {
 	handles_map.insert( std::pair< OPCHANDLE, GroupElem >( group->getServerHandle(), group ) );
 	names_map.insert( std::pair< String, GroupElem >( group->getName(), group ) );
+	scheduler.add( group->getServerHandle(), boost::bind( &private_::updateGroup, group ), group->getUpdateRate() );
+	group->setWakeUp( boost::bind( &UpdateScheduler::wakeUp, &scheduler, group->getServerHandle() ) );
 }
 
 GroupElem GroupManager::addGroup( String &name )
@@ -51,6 +66,7 @@ bool GroupManager::removeGroup( String &name )
 	Group *ptr = handle_it->second.get();
 	ptr->AddRef();
 	handles_map.erase( handle_it );
+	scheduler.remove( tmp_handle );
 	return ptr->Release() == 0;
 }
 
@@ -72,6 +88,7 @@ bool GroupManager::removeGroup( OPCHANDLE handle )
 	Group *ptr = name_it->second.get();
 	ptr->AddRef();
 	names_map.erase( name_it );
+	scheduler.remove( handle );
 	return ptr->Release() == 0;
 }
 
@@ -174,29 +191,6 @@ size_t GroupManager::getGroupCount()
 	return handles_map.size();
 }
 
-void GroupManager::updateGroups()
-{
-	while( ! stopUpdate.timedWait( 50 ) )
-	{
-		boost::mutex::scoped_lock lock( guard );
-		boost::thread_group gr;
-		FILETIME ftime;
-		::GetSystemTimeAsFileTime( &ftime );
-		ULONGLONG time = *(reinterpret_cast< ULONGLONG* >( &ftime ) );
-		GroupElemNamesMap::iterator end = names_map.end();
-		for(	GroupElemNamesMap::iterator it = names_map.begin();
-			it != end;
-			++it )
-		{
-			if( ( ( time - it->second->getLastUpdateTick() ) / 10000 ) >= it->second->getUpdateRate() )
-			{
-				gr.create_thread( boost::bind( &Group::onUpdateTimer, it->second.get() ) );
-			}
-		}
-		gr.join_all();
-	}
-}
-
 } // namespace opc
 } // FatRat Library
 
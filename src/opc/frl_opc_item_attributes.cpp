@@ -60,6 +60,7 @@ ItemAttributes& ItemAttributes::operator=( const ItemAttributes& rhv )
 		return *this;
 
 	freeStrings();
+	VariantClear( &attributes->vEUInfo );
 	os::win32::com::zeroMemory( attributes );
 
 	attributes->bActive = rhv.attributes->bActive;
@@ -78,35 +79,60 @@ ItemAttributes& ItemAttributes::operator=( const ItemAttributes& rhv )
 	return *this;
 }
 
-ItemAttributes& ItemAttributes::operator=( const std::pair< OPCHANDLE, GroupItemElem >& newItem )
+void ItemAttributes::assign( const GroupItemTable &items, size_t slot )
 {
 	freeStrings();
+	VariantClear( &attributes->vEUInfo );
 	os::win32::com::zeroMemory( attributes );
 
-	attributes->hServer = newItem.first;
+	const GroupItemElem &newItem = items.getItem( slot );
+	attributes->hServer = items.getHandle( slot );
 
-	attributes->bActive = newItem.second->isActived();
-	attributes->hClient = newItem.second->getClientHandle();
+	attributes->bActive = items.isActive( slot );
+	attributes->hClient = items.getClientHandle( slot );
 
 	#if( FRL_CHARACTER == FRL_CHARACTER_UNICODE )
-		attributes->szItemID = util::duplicateString( newItem.second->getItemID() );
+		attributes->szItemID = util::duplicateString( newItem->getItemID() );
 	#else
-		attributes->szItemID = util::duplicateString( string2wstring( newItem.second->getItemID() ) );
+		attributes->szItemID = util::duplicateString( string2wstring( newItem->getItemID() ) );
 	#endif
 
 	#if( FRL_CHARACTER == FRL_CHARACTER_UNICODE )
-		attributes->szAccessPath = util::duplicateString( newItem.second->getAccessPath() );
+		attributes->szAccessPath = util::duplicateString( newItem->getAccessPath() );
 	#else
-		attributes->szAccessPath = util::duplicateString( string2wstring( newItem.second->getAccessPath() ) );
+		attributes->szAccessPath = util::duplicateString( string2wstring( newItem->getAccessPath() ) );
 	#endif
 
-	address_space::Tag *item = opcAddressSpace::getInstance().getTag( newItem.second->getItemID() );
-	attributes->dwAccessRights = item->getAccessRights();
 	attributes->dwBlobSize = 0;
 	attributes->pBlob = NULL;
+	attributes->vtRequestedDataType = newItem->getReguestDataType();
+	GroupItem::PinnedTag item( *newItem );
+	if( item.get() == NULL )
+	{
+		// tag was removed: item is unknown, no rights and no data
+		attributes->dwAccessRights = 0;
+		attributes->vtCanonicalDataType = VT_EMPTY;
+		return;
+	}
+	attributes->dwAccessRights = item->getAccessRights();
 	attributes->vtCanonicalDataType = item->getCanonicalDataType();
-	attributes->vtRequestedDataType = newItem.second->getReguestDataType();
-	return *this;
+	if( item->isAnalog() )
+	{
+		// EU info of analog item: array of low and high EU
+		SAFEARRAY *range = SafeArrayCreateVector( VT_R8, 0, 2 );
+		if( range != NULL )
+		{
+			LONG index = 0;
+			Double limit = item->getLowEU();
+			SafeArrayPutElement( range, &index, &limit );
+			index = 1;
+			limit = item->getHighEU();
+			SafeArrayPutElement( range, &index, &limit );
+			attributes->dwEUType = OPC_ANALOG;
+			attributes->vEUInfo.vt = VT_ARRAY | VT_R8;
+			attributes->vEUInfo.parray = range;
+		}
+	}
 }
 
 void ItemAttributes::copyTo( OPCITEMATTRIBUTES& dst )
@@ -1,5 +1,6 @@
 #include "frl_platform.h"
 #if( FRL_PLATFORM == FRL_PLATFORM_WIN32 )
+#include <boost/bind.hpp>
 #include "opc/frl_opc_request_manager.h"
 #include "opc/frl_opc_group_manager.h"
 #include "opc/frl_opc_group.h"
@@ -8,23 +9,30 @@
 namespace frl{ namespace opc{
 
 RequestManager::RequestManager()
-	:	stopIt( false )
+	:	executor( opcExecutor::getInstance() ),
+		posted( 0 )
 {
-	processThread = boost::thread(boost::bind( &RequestManager::process, this ) );
 }
 
 RequestManager::~RequestManager()
 {
-	stopIt = true;
-	addReqEvent.signal();
-	processThread.join();
+	boost::mutex::scoped_lock lock( scopeGuard );
+	request_map.clear();
+	// requests passed to executor refer to manager
+	while( posted != 0 )
+		idleCondition.wait( lock );
 }
 
 void RequestManager::addRequest( AsyncRequestListElem& request )
 {
 	boost::mutex::scoped_lock lock( scopeGuard );
 	request_map.insert( std::pair< OPCHANDLE, AsyncRequestListElem >( request->getCancelID(), request ) );
-	addReqEvent.signal();
+	OPCHANDLE group_id = request->getGroup()->getServerHandle();
+	Strands::iterator it = strands.find( group_id );
+	if( it == strands.end() )
+		it = strands.insert( std::make_pair( group_id, Executor::Strand( executor ) ) ).first;
+	++posted;
+	it->second.post( boost::bind( &RequestManager::process, this, request->getCancelID() ) );
 }
 
 bool RequestManager::cancelRequest( OPCHANDLE handle )
@@ -66,12 +74,17 @@ void RequestManager::doAsync( AsyncRequestListElem& request )
 	ipCallback->Release();
 }
 
-void RequestManager::removeItemFromRequest( OPCHANDLE item_id )
+void RequestManager::removeItemFromRequest( OPCHANDLE group_id, OPCHANDLE item_id )
 {
 	boost::mutex::scoped_lock lock( scopeGuard );
 	std::map< OPCHANDLE, AsyncRequestListElem >::iterator it;
 	for( it = request_map.begin(); it != request_map.end(); )
 	{
+		if( it->second->getGroup()->getServerHandle() != group_id )
+		{
+			++it;
+			continue;
+		}
 		it->second->removeHandle( item_id );
 		if( it->second->getCounts() == 0 )
 			request_map.erase( it++ );
@@ -91,30 +104,36 @@ void RequestManager::removeGroupFromRequest( OPCHANDLE group_id )
 		else
 			++it;
 	}
+	strands.erase( group_id );
+}
+
+RequestManager::Processed::Processed( RequestManager &manager_ )
+	:	manager( manager_ )
+{
+}
+
+RequestManager::Processed::~Processed()
+{
+	boost::mutex::scoped_lock lock( manager.scopeGuard );
+	if( --manager.posted == 0 )
+		manager.idleCondition.notify_all();
 }
 
-void RequestManager::process()
+void RequestManager::process( OPCHANDLE cancelID )
 {
+	Processed processed( *this ); // after request is released
 	AsyncRequestListElem request;
-	while( ! stopIt )
 	{
-		addReqEvent.wait();
-		while( getNextRequest( request ) )
+		boost::mutex::scoped_lock lock( scopeGuard );
+		std::map< OPCHANDLE, AsyncRequestListElem >::iterator it = request_map.find( cancelID );
+		if( it != request_map.end() )
 		{
-			doAsync( request );
+			request = it->second;
+			request_map.erase( it );
 		}
 	}
-}
-
-bool RequestManager::getNextRequest( AsyncRequestListElem &request )
-{
-	boost::mutex::scoped_lock lock( scopeGuard );
-	if( request_map.empty() )
-		return false;
-	std::map< OPCHANDLE, AsyncRequestListElem >::iterator req = request_map.begin();
-	request = req->second;
-	request_map.erase( req );
-	return true;
+	if( request ) // not removed meanwhile
+		doAsync( request );
 }
 
 } // namespace opc
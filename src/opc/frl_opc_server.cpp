@@ -16,8 +16,20 @@ namespace frl{ namespace opc{
 OPCServer::OPCServer()
 	:	refCount( 0 )
 {
-	// call opcAddressSpace::getInstance().finalConstruct first !
-	if( ! opcAddressSpace::getInstance().isInit() )
+	init();
+}
+
+OPCServer::OPCServer( address_space::AddressSpace &addressSpace_ )
+	:	OPCServerBase( addressSpace_ ),
+		refCount( 0 )
+{
+	init();
+}
+
+void OPCServer::init()
+{
+	// call finalConstruct of address space first !
+	if( ! addressSpace.isInit() )
 		FRL_THROW_S_CLASS( address_space::AddressSpace::NotFinalConstruct );
 
 	os::win32::com::zeroMemory<OPCSERVERSTATUS>( &serverStatus );
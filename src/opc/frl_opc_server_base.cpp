@@ -5,10 +5,27 @@
 
 namespace frl{ namespace opc{
 
+OPCServerBase::OPCServerBase()
+	:	addressSpace( opcAddressSpace::getInstance() ),
+		crawler( opcAddressSpace::getInstance() )
+{
+}
+
+OPCServerBase::OPCServerBase( address_space::AddressSpace &addressSpace_ )
+	:	addressSpace( addressSpace_ ),
+		crawler( addressSpace_ )
+{
+}
+
 OPCServerBase::~OPCServerBase()
 {
 }
 
+address_space::AddressSpace& OPCServerBase::getAddressSpace()
+{
+	return addressSpace;
+}
+
 void OPCServerBase::removeGroupFromRequestList( OPCHANDLE group_handle )
 {
 	request_manager.removeGroupFromRequest( group_handle );
@@ -42,9 +59,9 @@ frl::Bool OPCServerBase::asyncRequestCancel( DWORD id )
 	return ( request_manager.cancelRequest( id ) );
 }
 
-void OPCServerBase::removeItemFromRequestList( OPCHANDLE item_handle )
+void OPCServerBase::removeItemFromRequestList( OPCHANDLE group_handle, OPCHANDLE item_handle )
 {
-	request_manager.removeItemFromRequest( item_handle );
+	request_manager.removeItemFromRequest( group_handle, item_handle );
 }
 
 void OPCServerBase::addAsyncRequest( AsyncRequestListElem &request )
@@ -9,7 +9,8 @@ LONG OPCServerFactory::serverLocks = 0;
 
 OPCServerFactory::OPCServerFactory()
 	:	refCount( 1 ),
-		outProc( False )
+		outProc( False ),
+		addressSpace( NULL )
 {
 }
 
@@ -53,7 +54,11 @@ STDMETHODIMP OPCServerFactory::CreateInstance(
 {
 	if( ( pUnkOuter != NULL ) && ( riid != IID_IUnknown ) )
 		return CLASS_E_NOAGGREGATION ;
-	frl::opc::OPCServer *server = new frl::opc::OPCServer();
+	frl::opc::OPCServer *server = NULL;
+	if( addressSpace == NULL )
+		server = new frl::opc::OPCServer();
+	else
+		server = new frl::opc::OPCServer( *addressSpace );
 	
 	if( server == NULL )
 		return E_OUTOFMEMORY;
@@ -85,6 +90,11 @@ STDMETHODIMP OPCServerFactory::LockServer( /* [in] */ BOOL fLock )
 	return S_OK;
 }
 
+void OPCServerFactory::setAddressSpace( address_space::AddressSpace &addressSpace_ )
+{
+	addressSpace = &addressSpace_;
+}
+
 void OPCServerFactory::isOutProc( Bool isOutProc )
 {
 	outProc = isOutProc;
@@ -0,0 +1,325 @@
+#include <algorithm>
+#include <boost/bind.hpp>
+#include <boost/chrono/system_clocks.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include "opc/frl_opc_update_scheduler.h"
+
+namespace frl{ namespace opc{
+
+namespace private_
+{
+	const size_t innerSlots = 256;
+	const size_t outerSlots = 64;
+} // namespace private_
+
+const UInt UpdateScheduler::idle;
+
+UpdateScheduler::UpdateScheduler( UInt tick_ )
+	:	executor( opcExecutor::getInstance() ),
+		tick( tick_ == 0 ? 1 : tick_ ),
+		inner( private_::innerSlots ),
+		outer( private_::outerSlots ),
+		currentTick( 0 ),
+		running( 0 ),
+		stopped( True )
+{
+}
+
+UpdateScheduler::UpdateScheduler( Executor &executor_, UInt tick_ )
+	:	executor( executor_ ),
+		tick( tick_ == 0 ? 1 : tick_ ),
+		inner( private_::innerSlots ),
+		outer( private_::outerSlots ),
+		currentTick( 0 ),
+		running( 0 ),
+		stopped( True )
+{
+}
+
+UpdateScheduler::~UpdateScheduler()
+{
+	stop();
+	wait();
+	// entries return into wheels after run
+	for( Entries::iterator it = entries.begin(); it != entries.end(); ++it )
+	{
+		if( it->second->sleeping )
+			delete it->second;
+	}
+	for( size_t i = 0; i < inner.size(); ++i )
+	{
+		for( size_t j = 0; j < inner[i].size(); ++j )
+			delete inner[i][j];
+	}
+	for( size_t i = 0; i < outer.size(); ++i )
+	{
+		for( size_t j = 0; j < outer[i].size(); ++j )
+			delete outer[i][j];
+	}
+}
+
+UInt UpdateScheduler::toTicks( UInt period ) const
+{
+	UInt ticks = ( period + tick - 1 ) / tick;
+	return ticks == 0 ? 1 : ticks;
+}
+
+void UpdateScheduler::schedule( Entry *entry )
+{
+	if( entry->due - currentTick < inner.size() )
+		inner[ entry->due % inner.size() ].push_back( entry );
+	else
+		outer[ ( entry->due / inner.size() ) % outer.size() ].push_back( entry );
+}
+
+void UpdateScheduler::unschedule( Entry *entry )
+{
+	// entry is in one of slots its due tick maps to
+	std::vector< Entry* > *slot = &inner[ entry->due % inner.size() ];
+	std::vector< Entry* >::iterator it = std::find( slot->begin(), slot->end(), entry );
+	if( it == slot->end() )
+	{
+		slot = &outer[ ( entry->due / inner.size() ) % outer.size() ];
+		it = std::find( slot->begin(), slot->end(), entry );
+	}
+	*it = slot->back();
+	slot->pop_back();
+}
+
+void UpdateScheduler::cascade( ULong turn )
+{
+	pending.clear();
+	pending.swap( outer[ turn % outer.size() ] );
+	for( std::vector< Entry* >::iterator it = pending.begin(); it != pending.end(); ++it )
+	{
+		if( (*it)->removed )
+			delete *it;
+		else
+			schedule( *it ); // into inner wheel or back for one of next turns of outer wheel
+	}
+}
+
+void UpdateScheduler::dispatch( Entry *entry )
+{
+	entry->running = True;
+	entry->woken = False;
+	++running;
+	executor.post( boost::bind( &UpdateScheduler::runEntry, this, entry ) );
+}
+
+Bool UpdateScheduler::add( UInt id, const Task &task, UInt period )
+{
+	boost::mutex::scoped_lock lock( guard );
+	Entries::iterator it = entries.lower_bound( id );
+	if( it != entries.end() && it->first == id )
+		return False;
+	Entry *entry = new Entry();
+	entry->task = task;
+	entry->period = toTicks( period );
+	entry->due = currentTick + entry->period;
+	entry->running = False;
+	entry->removed = False;
+	entry->sleeping = False;
+	entry->woken = False;
+	entries.insert( it, std::make_pair( id, entry ) );
+	schedule( entry );
+	return True;
+}
+
+void UpdateScheduler::remove( UInt id )
+{
+	Task released; // destroyed without lock
+	boost::mutex::scoped_lock lock( guard );
+	Entries::iterator it = entries.find( id );
+	if( it == entries.end() )
+		return;
+	Entry *entry = it->second;
+	entries.erase( it );
+	// entry leaves wheel when it is due, entry passed to executor is deleted after run
+	entry->removed = True;
+	if( ! entry->running )
+		released.swap( entry->task );
+	if( entry->sleeping )
+		delete entry;
+}
+
+void UpdateScheduler::reschedule( UInt id, UInt period )
+{
+	boost::mutex::scoped_lock lock( guard );
+	Entries::iterator it = entries.find( id );
+	if( it == entries.end() )
+		return;
+	Entry *entry = it->second;
+	entry->period = toTicks( period );
+	if( entry->running || entry->sleeping )
+		return; // running task is rescheduled by period it returns
+	unschedule( entry );
+	entry->due = currentTick + entry->period;
+	schedule( entry );
+}
+
+void UpdateScheduler::wakeUp( UInt id )
+{
+	boost::mutex::scoped_lock lock( guard );
+	Entries::iterator it = entries.find( id );
+	if( it == entries.end() )
+		return;
+	Entry *entry = it->second;
+	if( entry->running )
+		entry->woken = True;
+	else if( entry->sleeping )
+	{
+		entry->sleeping = False;
+		entry->due = std::max( entry->due + entry->period, currentTick + 1 );
+		schedule( entry );
+	}
+}
+
+void UpdateScheduler::process( ULong now )
+{
+	boost::mutex::scoped_lock lock( guard );
+	ULong target = now / tick;
+	if( target <= currentTick )
+		return;
+	if( target - currentTick > inner.size() )
+	{
+		// after long pause every entry is placed anew, missed runs are skipped
+		pending.clear();
+		for( size_t i = 0; i < inner.size(); ++i )
+		{
+			pending.insert( pending.end(), inner[i].begin(), inner[i].end() );
+			inner[i].clear();
+		}
+		for( size_t i = 0; i < outer.size(); ++i )
+		{
+			pending.insert( pending.end(), outer[i].begin(), outer[i].end() );
+			outer[i].clear();
+		}
+		currentTick = target - 1;
+		for( std::vector< Entry* >::iterator it = pending.begin(); it != pending.end(); ++it )
+		{
+			if( (*it)->removed )
+			{
+				delete *it;
+				continue;
+			}
+			(*it)->due = std::max( (*it)->due, target );
+			schedule( *it );
+		}
+	}
+	for( ULong t = currentTick + 1; t <= target; ++t )
+	{
+		currentTick = t;
+		if( t % inner.size() == 0 )
+			cascade( t / inner.size() );
+		pending.clear();
+		pending.swap( inner[ t % inner.size() ] );
+		for( std::vector< Entry* >::iterator it = pending.begin(); it != pending.end(); ++it )
+		{
+			if( (*it)->removed )
+				delete *it;
+			else if( (*it)->due > t )
+				schedule( *it );
+			else
+				dispatch( *it );
+		}
+	}
+}
+
+void UpdateScheduler::runEntry( Entry *entry )
+{
+	boost::mutex::scoped_lock lock( guard );
+	UInt period = 0;
+	Bool failed = False;
+	if( ! entry->removed )
+	{
+		lock.unlock();
+		try
+		{
+			period = entry->task();
+		}
+		catch( ... )
+		{
+			failed = True; // task runs again at its period
+		}
+		lock.lock();
+	}
+	entry->running = False;
+	if( entry->removed )
+	{
+		// nobody refers to entry any more
+		lock.unlock();
+		delete entry;
+		lock.lock();
+	}
+	else if( ! failed && period == idle && ! entry->woken )
+		entry->sleeping = True; // due keeps tick of this run
+	else
+	{
+		if( ! failed && period != idle )
+			entry->period = toTicks( period );
+		// phase is kept unless run took longer than period
+		entry->due = std::max( entry->due + entry->period, currentTick + 1 );
+		schedule( entry );
+	}
+	if( --running == 0 )
+		idleCondition.notify_all();
+}
+
+void UpdateScheduler::wait()
+{
+	boost::mutex::scoped_lock lock( guard );
+	while( running != 0 )
+		idleCondition.wait( lock );
+}
+
+void UpdateScheduler::run()
+{
+	ULong started; // time goes on after restart
+	{
+		boost::mutex::scoped_lock lock( guard );
+		started = currentTick * tick;
+	}
+	// monotonic clock, setting of system time does not shift updates
+	boost::chrono::steady_clock::time_point begin = boost::chrono::steady_clock::now();
+	boost::mutex::scoped_lock lock( stopGuard );
+	while( ! stopped )
+	{
+		lock.unlock();
+		boost::chrono::milliseconds elapsed = boost::chrono::duration_cast< boost::chrono::milliseconds >( boost::chrono::steady_clock::now() - begin );
+		process( started + ( elapsed.count() > 0 ? (ULong)elapsed.count() : 0 ) );
+		lock.lock();
+		if( ! stopped )
+			stopCondition.timed_wait( lock, boost::posix_time::milliseconds( tick ) );
+	}
+}
+
+void UpdateScheduler::start()
+{
+	boost::mutex::scoped_lock lock( stopGuard );
+	if( ! stopped )
+		return;
+	stopped = False;
+	timer = boost::thread( boost::bind( &UpdateScheduler::run, this ) );
+}
+
+void UpdateScheduler::stop()
+{
+	{
+		boost::mutex::scoped_lock lock( stopGuard );
+		if( stopped )
+			return;
+		stopped = True;
+		stopCondition.notify_all();
+	}
+	timer.join();
+}
+
+size_t UpdateScheduler::size()
+{
+	boost::mutex::scoped_lock lock( guard );
+	return entries.size();
+}
+
+} // namespace opc
+} // FatRat Library
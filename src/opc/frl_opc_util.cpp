@@ -5,6 +5,9 @@
 #include "../dependency/vendors/opc_foundation/opcerror.h"
 #include "os/win32/com/frl_os_win32_com_allocator.h"
 #include "stream_std/frl_sstream.h"
+#include "frl_string.h"
+#include "opc/address_space/frl_opc_tag.h"
+#include "opc/address_space/frl_opc_name_pattern.h"
 
 namespace frl
 {
@@ -70,6 +73,15 @@ wchar_t* duplicateString( const std::wstring &string )
 	return duplicateString( string.c_str() );
 }
 
+Char* duplicateString( const address_space::PathView &string )
+{
+	// view is not zero terminated
+	Char *ret = os::win32::com::allocMemory< Char >( string.size() + 1 );
+	std::char_traits< Char >::copy( ret, string.data(), string.size() );
+	ret[ string.size() ] = 0;
+	return ret;
+}
+
 HRESULT getErrorString( HRESULT dwError, LCID lcid, LPWSTR **ppString )
 {
 	switch ( dwError )
@@ -372,203 +384,14 @@ HRESULT getErrorString( HRESULT dwError, LCID lcid, LPWSTR **ppString )
 
 
 // Based on "Alarms and Events Custom Interface Standard. Version 1.10. Final Release. OCTOBER 2, 2002"
+// For many strings compile address_space::NamePattern once instead.
 Bool matchStringPattern( const String &str, const String& pattern, Bool caseSensitive )
 {
 	if( pattern.empty() )
 		return True;
 	if( str.empty() )
 		return False;
-
-	String tmpStr, tmpPattern;
-	if( ! caseSensitive )
-	{
-		tmpStr = lexicalCast< String, String >( str, lexicalMutators::lower() );
-		tmpPattern = lexicalCast< String, String >( pattern, lexicalMutators::lower() );
-		if( tmpStr == tmpPattern )
-			return True;
-	}
-	else
-	{
-		if( str == pattern )
-			return True;
-
-		tmpStr = str;
-		tmpPattern = pattern;
-	}
-
-	Char charSetSimb, stringSimb, l;
-	size_t patternPos = 0;
-	size_t sourcePos = 0;
-	while( sourcePos < tmpStr.length() && patternPos < tmpPattern.length() )
-	{
-		stringSimb = tmpPattern[patternPos++];
-		if( patternPos > tmpPattern.length() )
-		{
-			return( sourcePos >= tmpStr.length() ); // if end of string true
-		}
-
-		switch( stringSimb )
-		{
-		// match zero or more char.
-		case FRL_STR('*'):
-			{
-				while( sourcePos < tmpStr.length() ) 
-				{   
-					if( matchStringPattern(	tmpStr.substr( sourcePos++, tmpStr.length() - 1 ),
-						pattern.substr( patternPos, tmpPattern.length() - 1 ),
-						caseSensitive) )
-					{
-						return True;
-					}
-				}
-				return matchStringPattern( tmpStr, tmpPattern.substr( patternPos, tmpPattern.length() - 1 ), caseSensitive);
-			}
-			break;
-
-		// match any one char
-		case FRL_STR('?'):
-			{
-				// if end of source string
-				if( sourcePos >= tmpStr.length() ) 
-				{
-					return False;  
-				}
-				++sourcePos;
-				break;
-			}
-
-		// match char set 
-		case FRL_STR('['): 
-			{
-				charSetSimb = tmpStr[sourcePos++];;
-
-				if( sourcePos > tmpStr.length())
-					return False; // syntax
-
-				l = FRL_STR('\0'); 
-
-				// match a char if NOT in set []
-				if( tmpPattern[patternPos] == FRL_STR('!') ) 
-				{
-					++patternPos;
-
-					stringSimb = tmpPattern[patternPos++];
-
-					while( patternPos < tmpPattern.length() ) 
-					{
-						if (stringSimb == FRL_STR(']')) // if end of char set, then 
-						{
-							break; // no match found 
-						}
-
-						if (stringSimb == FRL_STR('-')) 
-						{
-							// check a range of chars? 
-							stringSimb = tmpPattern[patternPos];
-
-							// get high limit of range 
-							if (patternPos > tmpPattern.length() || stringSimb == FRL_STR(']') )
-							{
-								return False; // syntax 
-							}
-
-							if( charSetSimb >= l && charSetSimb <= stringSimb) 
-							{
-								return False; // if in range, return false
-							}
-						} 
-
-						l = stringSimb;
-
-						if (charSetSimb == stringSimb) // if char matches this element 
-						{
-							return False; // return false 
-						}
-
-						stringSimb = tmpPattern[patternPos++];
-					} 
-				}
-
-				// match if char is in set []
-				else 
-				{
-					stringSimb = tmpPattern[patternPos++];
-
-					while(patternPos < tmpPattern.length() ) 
-					{
-						if (stringSimb == FRL_STR(']')) // if end of char set, then no match found 
-						{
-							return False;
-						}
-
-						if (stringSimb == FRL_STR('-')) 
-						{   
-							// check a range of chars? 
-							stringSimb = tmpPattern[patternPos];
-
-							// get high limit of range 
-							if (patternPos > tmpPattern.length() || stringSimb == FRL_STR(']') )
-							{
-								return False; // syntax 
-							}
-
-							if (charSetSimb >= l  &&  charSetSimb <= stringSimb) 
-							{
-								break; // if in range, move on 
-							}
-						} 
-
-						l = stringSimb;
-
-						if (charSetSimb == stringSimb) // if char matches this element move on 
-						{
-							break;           
-						}
-
-						stringSimb = tmpPattern[patternPos++];
-					} 
-
-					while (patternPos < tmpPattern.length() && stringSimb != FRL_STR(']') ) // got a match in char set skip to end of set
-					{
-						stringSimb = tmpPattern[patternPos++];             
-					}
-				}
-			}
-			break; 
-
-		// match digit.
-		case FRL_STR('#'):
-			{
-				charSetSimb = tmpStr[sourcePos++]; 
-
-				if( charSetSimb < 48 || charSetSimb > 57 )
-				{
-					return False; // not a digit
-				}
-			}
-			break;
-
-		// match exact char.
-		default: 
-			{
-				charSetSimb = tmpStr[sourcePos++]; 
-
-				if (charSetSimb != stringSimb) // check for exact char
-				{
-					return False; // not a match
-				}
-
-				// check if end of pattern and still string data left.
-				if (patternPos >= tmpPattern.length() && sourcePos < tmpStr.length()-1)
-				{
-					return False;
-				}
-			}
-			break;
-
-		}
-	}
-	return True;
+	return address_space::NamePattern( pattern, caseSensitive ).match( str );
 }
 
 struct daOPCProp
@@ -644,6 +467,192 @@ VARTYPE getPropertyType( DWORD propID )
 	return VT_EMPTY;
 }
 
+HRESULT valueToVariant( const address_space::Value &from, VARIANT &to )
+{
+	using namespace address_space;
+	::VariantClear( &to );
+	switch( from.getType() )
+	{
+		case data_type::EMPTY:
+		break;
+
+		case data_type::BOOL:
+			to.boolVal = bool( from ) ? VARIANT_TRUE : VARIANT_FALSE;
+		break;
+
+		case data_type::I1:
+			to.cVal = char( from );
+		break;
+
+		case data_type::UI1:
+			to.bVal = (unsigned char)( from );
+		break;
+
+		case data_type::I2:
+			to.iVal = short( from );
+		break;
+
+		case data_type::UI2:
+			to.uiVal = (unsigned short)( from );
+		break;
+
+		case data_type::I4:
+			to.lVal = int( from );
+		break;
+
+		case data_type::UI4:
+			to.ulVal = (unsigned int)( from );
+		break;
+
+		case data_type::I8:
+			to.llVal = Long( from );
+		break;
+
+		case data_type::UI8:
+			to.ullVal = ULong( from );
+		break;
+
+		case data_type::R4:
+			to.fltVal = float( from );
+		break;
+
+		case data_type::R8:
+			to.dblVal = double( from );
+		break;
+
+		case data_type::CY:
+			to.cyVal.int64 = from.getCurrency();
+		break;
+
+		case data_type::DATE:
+		{
+			Value tmp( from );
+			tmp.setType( data_type::R8 );
+			to.date = double( tmp );
+		}
+		break;
+
+		case data_type::STRING:
+		{
+			#if( FRL_CHARACTER == FRL_CHARACTER_UNICODE )
+				to.bstrVal = ::SysAllocString( String( from ).c_str() );
+			#else
+				to.bstrVal = ::SysAllocString( string2wstring( String( from ) ).c_str() );
+			#endif
+			if( to.bstrVal == NULL )
+				return E_OUTOFMEMORY;
+		}
+		break;
+
+		default:
+			return DISP_E_TYPEMISMATCH;
+	}
+	to.vt = from.getType();
+	return S_OK;
+}
+
+HRESULT variantToValue( const VARIANT &from, address_space::Value &to )
+{
+	using namespace address_space;
+	switch( from.vt )
+	{
+		case VT_EMPTY:
+			to.clear();
+		break;
+
+		case VT_BOOL:
+			to = Value( from.boolVal != VARIANT_FALSE );
+		break;
+
+		case VT_I1:
+			to = Value( from.cVal );
+		break;
+
+		case VT_UI1:
+			to = Value( from.bVal );
+		break;
+
+		case VT_I2:
+			to = Value( from.iVal );
+		break;
+
+		case VT_UI2:
+			to = Value( from.uiVal );
+		break;
+
+		case VT_I4:
+			to = Value( (Int)from.lVal );
+		break;
+
+		case VT_UI4:
+			to = Value( (UInt)from.ulVal );
+		break;
+
+		case VT_I8:
+			to = Value( (Long)from.llVal );
+		break;
+
+		case VT_UI8:
+			to = Value( (ULong)from.ullVal );
+		break;
+
+		case VT_R4:
+			to = Value( from.fltVal );
+		break;
+
+		case VT_R8:
+			to = Value( from.dblVal );
+		break;
+
+		case VT_CY:
+			to.setCurrency( from.cyVal.int64 );
+		break;
+
+		case VT_DATE:
+			to = Value( (double)from.date );
+			to.setType( data_type::DATE );
+		break;
+
+		case VT_BSTR:
+		{
+			if( from.bstrVal == NULL )
+				to = Value( String() );
+			else
+			#if( FRL_CHARACTER == FRL_CHARACTER_UNICODE )
+				to = Value( String( from.bstrVal ) );
+			#else
+				to = Value( wstring2string( from.bstrVal ) );
+			#endif
+		}
+		break;
+
+		default:
+			return DISP_E_TYPEMISMATCH;
+	}
+	return S_OK;
+}
+
+FILETIME timeStampToFileTime( const address_space::TimeStamp &from )
+{
+	FILETIME ft;
+	ft.dwLowDateTime = (DWORD)( from.getTicks() & 0xFFFFFFFF );
+	ft.dwHighDateTime = (DWORD)( from.getTicks() >> 32 );
+	return ft;
+}
+
+address_space::TimeStamp fileTimeToTimeStamp( const FILETIME &from )
+{
+	return address_space::TimeStamp( ( (ULong)from.dwHighDateTime << 32 ) | from.dwLowDateTime );
+}
+
+HRESULT getTagPropertyValue( const address_space::Tag &tag, DWORD propID, VARIANT &to )
+{
+	address_space::Value tmp;
+	if( ! tag.getPropertyValue( propID, tmp ) )
+		return OPC_E_INVALID_PID;
+	return valueToVariant( tmp, to );
+}
+
 }	// namespace util
 } // namespace opc
 } // FatRat Library
@@ -59,10 +59,10 @@ STDMETHODIMP_(ULONG) EnumOPCItemAttributes::Release( void )
 	return ret;
 }
 
-void EnumOPCItemAttributes::addItem( const std::pair< OPCHANDLE, GroupItemElem >& newItem )
+void EnumOPCItemAttributes::addItem( const GroupItemTable &items, size_t slot )
 {
 	ItemAttributes attrib;
-	attrib = newItem;
+	attrib.assign( items, slot );
 	itemList.push_back( attrib );
 }
 
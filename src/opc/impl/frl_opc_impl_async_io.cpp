@@ -126,17 +126,16 @@ STDMETHODIMP AsyncIO::Read(
 	std::list<OPCHANDLE> handles;
 
 	boost::mutex::scoped_lock guard( groupGuard );
-	GroupItemElemList::iterator end = itemList.end();
 	for( DWORD i = 0; i < dwCount; ++i )
 	{
-		GroupItemElemList::iterator it = itemList.find( phServer[i] );
-		if( it == end )
+		size_t slot = items.find( phServer[i] );
+		if( slot == GroupItemTable::npos )
 		{
 			result = S_FALSE;
 			(*ppErrors)[i] = OPC_E_INVALIDHANDLE;
 			continue;
 		}
-		handles.push_back( (*it).first );
+		handles.push_back( phServer[i] );
 		(*ppErrors)[i] = S_OK;
 	}
 
@@ -272,17 +271,16 @@ STDMETHODIMP AsyncIO::Write(
 	std::list< OPCHANDLE > handles;
 
 	boost::mutex::scoped_lock guard( groupGuard );
-	GroupItemElemList::iterator end = itemList.end();
 	for( DWORD i = 0; i < dwCount; ++i )
 	{
-		GroupItemElemList::iterator it = itemList.find( phServer[i] );
-		if( it == end )
+		size_t slot = items.find( phServer[i] );
+		if( slot == GroupItemTable::npos )
 		{
 			result = S_FALSE;
 			(*ppErrors)[i] = OPC_E_INVALIDHANDLE;
 			continue;
 		}
-		handles.push_back( (*it).first );
+		handles.push_back( phServer[i] );
 		(*ppErrors)[i] = S_OK;
 	}
 
@@ -382,16 +380,11 @@ STDMETHODIMP AsyncIO::Refresh2(
 	if( ! actived )
 		return E_FAIL;
 
-	if( itemList.empty() )
+	if( items.empty() )
 		return E_FAIL;
 
 	std::list< OPCHANDLE > handles;
-	GroupItemElemList::iterator end = itemList.end();
-	for( GroupItemElemList::iterator it = itemList.begin(); it != end; ++it )
-	{
-		if( (*it).second->isActived() )
-			handles.push_back( (*it).first );
-	}
+	items.getActiveHandles( handles );
 
 	if( handles.empty() )
 		return E_FAIL;
@@ -793,18 +786,24 @@ STDMETHODIMP AsyncIO::WriteVQT(
 	std::list< ItemHVQT > itemsHVQTList;
 
 	boost::mutex::scoped_lock guard( groupGuard );
-	GroupItemElemList::iterator end = itemList.end();
 	for( DWORD i = 0; i < dwCount; ++i )
 	{
-		GroupItemElemList::iterator it = itemList.find( phServer[i] );
-		if( it == end )
+		size_t slot = items.find( phServer[i] );
+		if( slot == GroupItemTable::npos )
 		{
 			result = S_FALSE;
 			(*ppErrors)[i] = OPC_E_INVALIDHANDLE;
 			continue;
 		}
 
-		if( ! (*it).second->isWritable() )
+		if( ! items.getItem( slot )->isTagExist() )
+		{
+			result = S_FALSE;
+			(*ppErrors)[i] = OPC_E_UNKNOWNITEMID;
+			continue;
+		}
+
+		if( ! items.getItem( slot )->isWritable() )
 		{
 			result = S_FALSE;
 			(*ppErrors)[i] = OPC_E_BADRIGHTS;
@@ -819,7 +818,7 @@ STDMETHODIMP AsyncIO::WriteVQT(
 		}
 
 		ItemHVQT tmp;
-		tmp.setHandle( (*it).first );
+		tmp.setHandle( phServer[i] );
 		tmp.setValue( pItemVQT[i].vDataValue );
 
 		if( pItemVQT[i].bQualitySpecified )
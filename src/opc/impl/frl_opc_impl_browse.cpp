@@ -53,6 +53,7 @@ STDMETHODIMP BrowseImpl::GetProperties(
 	os::win32::com::zeroMemory< OPCITEMPROPERTIES >( *ppItemProperties, dwItemCount );
 
 	HRESULT ret = S_OK;
+	address_space::NamespaceVersionPtr version = addressSpace.getVersion();
 	address_space::Tag *item = NULL;
 	for( DWORD i = 0; i < dwItemCount; ++i )
 	{
@@ -69,11 +70,8 @@ STDMETHODIMP BrowseImpl::GetProperties(
 			String itemID = wstring2string( pszItemIDs[i] );
 		#endif
 
-		try
-		{
-			item = opcAddressSpace::getInstance().getTag( itemID );
-		}
-		catch( address_space::Tag::NotExistTag& )
+		item = addressSpace.findTag( itemID );
+		if( item == NULL )
 		{
 			(*ppItemProperties)[i].hrErrorID = OPC_E_UNKNOWNITEMID;
 			ret = S_FALSE;
@@ -82,7 +80,7 @@ STDMETHODIMP BrowseImpl::GetProperties(
 
 		if( dwPropertyCount == 0 )
 		{
-			std::vector< DWORD > propArray = item->getAvailableProperties();
+			std::vector< UInt > propArray = item->getAvailableProperties();
 			size_t arrSize = propArray.size();
 
 			(*ppItemProperties)[i].pItemProperties = os::win32::com::allocMemory<OPCITEMPROPERTY>( arrSize );
@@ -99,7 +97,7 @@ STDMETHODIMP BrowseImpl::GetProperties(
 				(*ppItemProperties)[i].pItemProperties[j].hrErrorID = S_OK;
 				if( bReturnPropertyValues == TRUE )
 				{
-					item->getPropertyValue( propArray[j], (*ppItemProperties)[i].pItemProperties[j].vValue );
+					util::getTagPropertyValue( *item, propArray[j], (*ppItemProperties)[i].pItemProperties[j].vValue );
 				}
 			}
 		} // if
@@ -119,7 +117,7 @@ STDMETHODIMP BrowseImpl::GetProperties(
 					(*ppItemProperties)[i].pItemProperties[j].hrErrorID = S_OK;
 					if( bReturnPropertyValues == TRUE )
 					{
-						item->getPropertyValue( pdwPropertyIDs[j] , (*ppItemProperties)[i].pItemProperties[j].vValue );
+						util::getTagPropertyValue( *item, pdwPropertyIDs[j], (*ppItemProperties)[i].pItemProperties[j].vValue );
 					}
 				}
 				else
@@ -242,14 +240,8 @@ STDMETHODIMP BrowseImpl::Browse(
 			String itemID = wstring2string( szItemID );
 		#endif
 
-		try
-		{
-			crawler.goTo( itemID );
-		}
-		catch( frl::Exception& )
-		{
+		if( ! crawler.goTo( itemID ) )
 			return OPC_E_UNKNOWNITEMID;
-		}
 	}
 
 	String cp;
@@ -260,88 +252,35 @@ STDMETHODIMP BrowseImpl::Browse(
 		#else
 			cp = wstring2string( *pszContinuationPoint );
 		#endif
-		if( ! opcAddressSpace::getInstance().isExistTag( cp ) )
-			return OPC_E_INVALIDCONTINUATIONPOINT;
-	}
-
-	std::vector< address_space::TagBrowseInfo > itemsList;
-	switch( dwBrowseFilter )
-	{
-	case OPC_BROWSE_FILTER_BRANCHES:
-		crawler.browseBranches( itemsList );
-		break;
-
-	case OPC_BROWSE_FILTER_ITEMS:
-		crawler.browseLeafs( itemsList );
-		break;
-
-	case OPC_BROWSE_FILTER_ALL:
-		crawler.browse( itemsList );
-		break;
-	} // switch
-
-	if( itemsList.empty() )
-		return S_OK;
-
-	if( ! cp.empty() )
-	{
-		Bool flag = False;
-
-		// find continuation point
-		std::vector< address_space::TagBrowseInfo > tmp;
-		BOOST_FOREACH( address_space::TagBrowseInfo& el, itemsList )
-		{
-			if( ! flag && el.fullID == cp ) // if found
-				flag = True;
-			if( flag )
-				tmp.push_back( el ); // add all follow items
-		}
-		if( ! flag )
-			return OPC_E_INVALIDCONTINUATIONPOINT; // continuation point not found
-		itemsList.swap( tmp );
 	}
 
+	// filter compiled once for all children
+	address_space::NamePattern nameFilter;
 	if( szElementNameFilter != NULL && wcslen( szElementNameFilter ) != 0 )
 	{
-		std::vector< address_space::TagBrowseInfo > filtredItems;
-		filtredItems.reserve( itemsList.size() );
 		#if( FRL_CHARACTER == FRL_CHARACTER_UNICODE )
-			String filter = szElementNameFilter;
+			nameFilter = address_space::NamePattern( szElementNameFilter );
 		#else
-			String filter = wstring2string( szElementNameFilter );
+			nameFilter = address_space::NamePattern( wstring2string( szElementNameFilter ) );
 		#endif
-		BOOST_FOREACH( address_space::TagBrowseInfo& el, itemsList )
-		{
-			if( util::matchStringPattern( el.shortID, filter ) )
-				filtredItems.push_back( el );
-		}
-		itemsList.swap( filtredItems );
 	}
 
-	if( itemsList.empty() )
-		return S_FALSE;
+	// only requested page is collected, browsing resumes from continuation point in O(log n);
+	// IDs of page refer to tags, which stay allocated while version is held
+	address_space::NamespaceVersionPtr version = addressSpace.getVersion();
+	std::vector< address_space::TagBrowseInfo > itemsList;
+	String nextCP;
+	if( ! crawler.browsePage( itemsList, (UInt)dwBrowseFilter, cp, (size_t)dwMaxElementsReturned, nameFilter, nextCP ) )
+		return OPC_E_INVALIDCONTINUATIONPOINT;
 
-	if( dwMaxElementsReturned != 0
-		&& ( dwMaxElementsReturned < (DWORD)itemsList.size() ) )
-	{
-		#if( FRL_CHARACTER == FRL_CHARACTER_UNICODE )
-			*pszContinuationPoint = util::duplicateString( itemsList[dwMaxElementsReturned].fullID );
-		#else
-			*pszContinuationPoint = util::duplicateString( string2wstring( itemsList[dwMaxElementsReturned].fullID ) );
-		#endif
+	if( itemsList.empty() )
+		return nameFilter.isMatchAll() ? S_OK : S_FALSE;
 
-		std::vector< address_space::TagBrowseInfo > tmp( dwMaxElementsReturned );
-		tmp.assign( itemsList.begin(), itemsList.begin() + dwMaxElementsReturned );
-		itemsList.swap( tmp );			
-	}
-	else
-	{
-		#if( FRL_CHARACTER == FRL_CHARACTER_UNICODE )
-			*pszContinuationPoint = util::duplicateString( FRL_STR("") );
-		#else
-			*pszContinuationPoint = util::duplicateString( string2wstring( FRL_STR("") ) );
-		#endif
-	}
+	#if( FRL_CHARACTER == FRL_CHARACTER_UNICODE )
+		*pszContinuationPoint = util::duplicateString( nextCP );
+	#else
+		*pszContinuationPoint = util::duplicateString( string2wstring( nextCP ) );
+	#endif
 
 	size_t size = itemsList.size();
 	*pdwCount = (DWORD)size;
@@ -354,8 +293,8 @@ STDMETHODIMP BrowseImpl::Browse(
 			(*ppBrowseElements)[i].szName = util::duplicateString( itemsList[i].shortID );
 			(*ppBrowseElements)[i].szItemID = util::duplicateString( itemsList[i].fullID );
 		#else
-			(*ppBrowseElements)[i].szName = util::duplicateString( string2wstring( itemsList[i].shortID ) );
-			(*ppBrowseElements)[i].szItemID = util::duplicateString( string2wstring( itemsList[i].fullID ) );
+			(*ppBrowseElements)[i].szName = util::duplicateString( string2wstring( itemsList[i].shortID.toString() ) );
+			(*ppBrowseElements)[i].szItemID = util::duplicateString( string2wstring( itemsList[i].fullID.toString() ) );
 		#endif
 
 		if( itemsList[i].isLeaf )
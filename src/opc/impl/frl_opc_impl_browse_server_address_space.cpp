@@ -1,5 +1,6 @@
 #include "opc/impl/frl_opc_impl_browse_server_address_space.h"
 #if( FRL_PLATFORM == FRL_PLATFORM_WIN32 )
+#include <algorithm>
 #include <boost/foreach.hpp>
 #include "frl_string.h"
 #include "opc/frl_opc_enum_string.h"
@@ -106,14 +107,8 @@ STDMETHODIMP BrowseServerAddressSpace::ChangeBrowsePosition(
 				String inString = wstring2string( szString );
 			#endif
 
-			try
-			{
-				crawler.goDown( inString );
-			}
-			catch( frl::Exception& )
-			{
+			if( ! crawler.goDown( inString ) )
 				return E_INVALIDARG;
-			}
 			return S_OK;
 		}
 
@@ -131,14 +126,8 @@ STDMETHODIMP BrowseServerAddressSpace::ChangeBrowsePosition(
 				String inString = wstring2string( szString );
 			#endif
 
-			try
-			{
-				crawler.goTo( inString );
-			}
-			catch( frl::Exception& )
-			{
+			if( ! crawler.goTo( inString ) )
 				return E_INVALIDARG;
-			}
 			return S_OK;
 		}
 	}
@@ -246,10 +235,21 @@ STDMETHODIMP BrowseServerAddressSpace::BrowseOPCItemIDs(
 		return E_OUTOFMEMORY;
 	std::vector<String> items;
 
+	// filter compiled once for all elements
+	address_space::NamePattern filter;
+	if( szFilterCriteria != NULL && wcslen( szFilterCriteria ) != 0 )
+	{
+		#if( FRL_CHARACTER == FRL_CHARACTER_UNICODE )
+			filter = address_space::NamePattern( szFilterCriteria );
+		#else
+			filter = address_space::NamePattern( wstring2string( szFilterCriteria ) );
+		#endif
+	}
+
 	switch( dwBrowseFilterType )
 	{
 	case OPC_LEAF:
-		crawler.browseLeafs( items, dwAccessRightsFilter );
+		crawler.browseLeafs( items, dwAccessRightsFilter, vtDataTypeFilter );
 		break;
 
 	case OPC_BRANCH:
@@ -257,24 +257,38 @@ STDMETHODIMP BrowseServerAddressSpace::BrowseOPCItemIDs(
 		break;
 
 	case OPC_FLAT:
-		// If OPC_FLAT we must returns all leafs from address space.
-		opcAddressSpace::getInstance().getAllLeafs( items, dwAccessRightsFilter );
-		break;
+		{
+			if( vtDataTypeFilter != VT_EMPTY )
+			{
+				// few leafs of one type: they are taken from index of types
+				addressSpace.findLeafs( items, dwAccessRightsFilter, vtDataTypeFilter );
+				std::sort( items.begin(), items.end() );
+				break;
+			}
+			// If OPC_FLAT we must returns all leafs from address space.
+			// Leafs are collected by chunks while client calls Next,
+			// so full list of names is never built.
+			address_space::LeafEnumerator leafs( addressSpace, filter, dwAccessRightsFilter );
+			Bool isEmpty = ! leafs.hasNext();
+			pEnum->init( leafs );
+			HRESULT hResult = pEnum->QueryInterface( IID_IEnumString, (void**) ppIEnumString );
+			if( FAILED( hResult ) )
+			{
+				delete pEnum;
+				return hResult;
+			}
+			return isEmpty ? S_FALSE : S_OK;
+		}
 	}
 
 	// filtration by name
-	if( szFilterCriteria != NULL && wcslen( szFilterCriteria ) != 0 )
+	if( ! filter.isMatchAll() )
 	{
-		#if( FRL_CHARACTER == FRL_CHARACTER_UNICODE )
-			String filter = szFilterCriteria;
-		#else
-			String filter = wstring2string( szFilterCriteria );
-		#endif
 		std::vector< String > filtredItems;
 		filtredItems.reserve( items.size() );
 		BOOST_FOREACH( String& el, items )
 		{
-			if( util::matchStringPattern( el, filter ) )
+			if( filter.match( el ) )
 				filtredItems.push_back( el );
 		}
 		items.swap( filtredItems );
@@ -380,20 +394,15 @@ STDMETHODIMP BrowseServerAddressSpace::GetItemID(
 		return S_OK;
 	}
 
+	address_space::NamespaceVersionPtr version = addressSpace.getVersion();
 	address_space::Tag *tag;
 
 	if( crawler.getCurPosPath().size() )
-	{
-		if( ! opcAddressSpace::getInstance().isExistTag( crawler.getCurPosPath() + opcAddressSpace::getInstance().getDelimiter() + itemDataID) )
-			return E_INVALIDARG;
-		tag = opcAddressSpace::getInstance().getTag( crawler.getCurPosPath() + opcAddressSpace::getInstance().getDelimiter() + itemDataID );
-	}
+		tag = addressSpace.findTag( crawler.getCurPosPath() + addressSpace.getDelimiter() + itemDataID );
 	else
-	{
-		if( ! opcAddressSpace::getInstance().isExistTag( itemDataID) )
-			return E_INVALIDARG;
-		tag = opcAddressSpace::getInstance().getTag( itemDataID );
-	}
+		tag = addressSpace.findTag( itemDataID );
+	if( tag == NULL )
+		return E_INVALIDARG;
 	
 	#if( FRL_CHARACTER == FRL_CHARACTER_UNICODE )
 		*szItemID = util::duplicateString( tag->getID() );
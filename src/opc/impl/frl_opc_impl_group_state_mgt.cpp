@@ -4,6 +4,7 @@
 #include "../dependency/vendors/opc_foundation/opcerror.h"
 #include "opc/frl_opc_server.h"
 #include "opc/frl_opc_group.h"
+#include "opc/frl_opc_update_scheduler.h"
 
 namespace frl { namespace opc { namespace impl {
 
@@ -170,6 +171,7 @@ STDMETHODIMP GroupStateMgt::SetState( /* [in][unique] */ DWORD *pRequestedUpdate
 		}
 
 		*pRevisedUpdateRate = updateRate = dwUpdateRate;
+		opcUpdateScheduler::getInstance().reschedule( getServerHandle(), updateRate );
 	}
 
 	if( pTimeBias != NULL )
@@ -189,21 +191,19 @@ STDMETHODIMP GroupStateMgt::SetState( /* [in][unique] */ DWORD *pRequestedUpdate
 		else
 			actived = False;
 
+		if( actived != oldState )
+			updateItemsDemand();
+
 		if( actived )
 		{
 			if( ! oldState )
 			{
-				if( itemList.size() )
+				if( items.size() )
 				{
 					if( isConnected( IID_IOPCDataCallback ) )
 					{
 						std::list< OPCHANDLE > handles;
-						GroupItemElemList::iterator end = itemList.end();
-						for( GroupItemElemList::iterator it = itemList.begin(); it != end; ++it )
-						{
-							if( (*it).second->isActived() )
-								handles.push_back( (*it).first );
-						}
+						items.getActiveHandles( handles );
 						if( handles.size() )
 						{
 							GroupElem tmp = GroupElem( dynamic_cast< Group* >( this ) );
@@ -107,17 +107,21 @@ STDMETHODIMP ItemDeadBandMgt::SetItemDeadband(
 
 	HRESULT result = S_OK;			
 	boost::mutex::scoped_lock guard( groupGuard );
-	GroupItemElemList::iterator it;
-	GroupItemElemList::iterator end = itemList.end();
 	for( DWORD i = 0; i < dwCount; ++i )
 	{
-		it = itemList.find( phServer[i] );
-		if( it == end )
+		size_t slot = items.find( phServer[i] );
+		if( slot == GroupItemTable::npos )
 		{
 			(*ppErrors)[i] = OPC_E_INVALIDHANDLE;
 			result = S_FALSE;
 			continue;
 		}
+		if( ! items.getItem( slot )->isAnalog() )
+		{
+			(*ppErrors)[i] = OPC_E_DEADBANDNOTSUPPORTED;
+			result = S_FALSE;
+			continue;
+		}
 
 		if( pPercentDeadband[i] < 0.0 || pPercentDeadband[i] > 100.0 )
 		{
@@ -126,7 +130,7 @@ STDMETHODIMP ItemDeadBandMgt::SetItemDeadband(
 			continue;
 		}
 
-		(*it).second->setDeadBand( pPercentDeadband[i] );
+		items.setDeadband( slot, pPercentDeadband[i] );
 		(*ppErrors)[i] = S_OK;
 	}
 	return result;
@@ -237,19 +241,23 @@ STDMETHODIMP ItemDeadBandMgt::GetItemDeadband(
 	HRESULT result = S_OK;
 	boost::mutex::scoped_lock guard( groupGuard );
 	Float tmpDeadBand;
-	GroupItemElemList::iterator it;
-	GroupItemElemList::iterator end = itemList.end();
 	for( DWORD i = 0; i < dwCount; ++i )
 	{
-		it = itemList.find( phServer[i] );
-		if( it == end )
+		size_t slot = items.find( phServer[i] );
+		if( slot == GroupItemTable::npos )
 		{
 			(*ppErrors)[i] = OPC_E_INVALIDHANDLE;
 			result = S_FALSE;
 			continue;
 		}
+		if( ! items.getItem( slot )->isAnalog() )
+		{
+			(*ppErrors)[i] = OPC_E_DEADBANDNOTSUPPORTED;
+			result = S_FALSE;
+			continue;
+		}
 
-		tmpDeadBand = (*it).second->getDeadBand();
+		tmpDeadBand = items.getDeadband( slot );
 		if( tmpDeadBand == invalidDeadBand )
 		{
 			(*ppErrors)[i] = OPC_E_DEADBANDNOTSET;
@@ -338,25 +346,29 @@ STDMETHODIMP ItemDeadBandMgt::ClearItemDeadband(
 	HRESULT result = S_OK;
 	boost::mutex::scoped_lock guard( groupGuard );
 	Float tmpDeadBand;
-	GroupItemElemList::iterator it;
-	GroupItemElemList::iterator end = itemList.end();
 	for( DWORD i = 0; i < dwCount; ++i )
 	{
-		it = itemList.find( phServer[i] );
-		if( it == end )
+		size_t slot = items.find( phServer[i] );
+		if( slot == GroupItemTable::npos )
 		{
 			(*ppErrors)[i] = OPC_E_INVALIDHANDLE;
 			result = S_FALSE;
 			continue;
 		}
-		tmpDeadBand = (*it).second->getDeadBand();
+		if( ! items.getItem( slot )->isAnalog() )
+		{
+			(*ppErrors)[i] = OPC_E_DEADBANDNOTSUPPORTED;
+			result = S_FALSE;
+			continue;
+		}
+		tmpDeadBand = items.getDeadband( slot );
 		if( tmpDeadBand == invalidDeadBand )
 		{
 			(*ppErrors)[i] = OPC_E_DEADBANDNOTSET;
 			result = S_FALSE;
 			continue;
 		}
-		(*it).second->setDeadBand( invalidDeadBand );
+		items.setDeadband( slot, invalidDeadBand );
 	}
 	return result;
 }
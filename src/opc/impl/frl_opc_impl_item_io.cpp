@@ -4,6 +4,7 @@
 #include "../dependency/vendors/opc_foundation/opcerror.h"
 #include "os/win32/com/frl_os_win32_com_allocator.h"
 #include "opc/address_space/frl_opc_address_space.h"
+#include "opc/frl_opc_util.h"
 
 namespace frl { namespace opc { namespace impl {
 
@@ -164,22 +165,24 @@ STDMETHODIMP OPCItemIO::Read(
 	os::win32::com::zeroMemory< HRESULT >( *ppErrors, dwCount );
 
 	HRESULT res = S_OK;
+	address_space::NamespaceVersionPtr version = addressSpace.getVersion();
 	address_space::Tag *item = NULL;
 	String itemID;
+	address_space::Value value;
+	UShort quality;
+	address_space::TimeStamp timeStamp;
 	for( DWORD i = 0; i < dwCount; ++i )
 	{
-		try
-		{
-			#if( FRL_CHARACTER == FRL_CHARACTER_UNICODE )
-				if( pszItemIDs[i] )
-					itemID = pszItemIDs[i];
-			#else
-				if( pszItemIDs[i] )
-					itemID = wstring2string( pszItemIDs[i] );
-			#endif
-			item = opcAddressSpace::getInstance().getLeaf( itemID );
-		}
-		catch( frl::Exception& )
+		itemID.clear();
+		#if( FRL_CHARACTER == FRL_CHARACTER_UNICODE )
+			if( pszItemIDs[i] )
+				itemID = pszItemIDs[i];
+		#else
+			if( pszItemIDs[i] )
+				itemID = wstring2string( pszItemIDs[i] );
+		#endif
+		item = addressSpace.findLeaf( itemID );
+		if( item == NULL )
 		{
 			(*ppErrors)[i] = OPC_E_INVALIDITEMID;
 			res = S_FALSE;
@@ -193,14 +196,15 @@ STDMETHODIMP OPCItemIO::Read(
 			continue;
 		}
 
-		(*ppErrors)[i] = os::win32::com::Variant::variantCopy( (*ppvValues)[i], item->read() );
+		item->read( value, quality, timeStamp );
+		(*ppErrors)[i] = util::valueToVariant( value, (*ppvValues)[i] );
 		if( FAILED( (*ppErrors)[i] ) )
 		{
 			res = S_FALSE;
 			continue;
 		}
-		(*ppwQualities)[i] = item->getQuality();
-		(*ppftTimeStamps)[i] = item->getTimeStamp();
+		(*ppwQualities)[i] = quality;
+		(*ppftTimeStamps)[i] = util::timeStampToFileTime( timeStamp );
 	}
 	return res;
 }
@@ -304,22 +308,21 @@ STDMETHODIMP OPCItemIO::WriteVQT(
 	os::win32::com::zeroMemory< HRESULT >( *ppErrors, dwCount );
 
 	HRESULT res = S_OK;
+	address_space::NamespaceVersionPtr version = addressSpace.getVersion();
 	address_space::Tag *item = NULL;
 	String itemID;
 	for( DWORD i = 0; i < dwCount; ++i )
 	{
-		try
-		{
-			#if( FRL_CHARACTER == FRL_CHARACTER_UNICODE )
-				if( pszItemIDs[i] )
-					itemID = pszItemIDs[i];
-			#else
-				if( pszItemIDs[i] )
-					itemID = wstring2string( pszItemIDs[i] );
-			#endif
-			item = opcAddressSpace::getInstance().getLeaf( itemID );
-		}
-		catch( frl::Exception& )
+		itemID.clear();
+		#if( FRL_CHARACTER == FRL_CHARACTER_UNICODE )
+			if( pszItemIDs[i] )
+				itemID = pszItemIDs[i];
+		#else
+			if( pszItemIDs[i] )
+				itemID = wstring2string( pszItemIDs[i] );
+		#endif
+		item = addressSpace.findLeaf( itemID );
+		if( item == NULL )
 		{
 			(*ppErrors)[i] = OPC_E_INVALIDITEMID;
 			res = S_FALSE;
@@ -345,11 +348,20 @@ STDMETHODIMP OPCItemIO::WriteVQT(
 		os::win32::com::Variant::variantCopy( &tmp, &pItemVQT[i].vDataValue );
 		(*ppErrors)[i] = ::VariantChangeType( &tmp, &tmp, 0, item->getCanonicalDataType() );
 		if( FAILED( (*ppErrors)[i] ) )
+		{
+			::VariantClear( &tmp );
+			res = S_FALSE;
+			continue;
+		}
+		address_space::Value value;
+		(*ppErrors)[i] = util::variantToValue( tmp, value );
+		::VariantClear( &tmp );
+		if( FAILED( (*ppErrors)[i] ) )
 		{
 			res = S_FALSE;
 			continue;
 		}
-		item->writeFromOPC( tmp );
+		item->writeFromOPC( value );
 
 		if( pItemVQT[i].bQualitySpecified )
 		{
@@ -358,7 +370,7 @@ STDMETHODIMP OPCItemIO::WriteVQT(
 
 		if( pItemVQT[i].bTimeStampSpecified )
 		{
-			item->setTimeStamp( pItemVQT[i].ftTimeStamp );
+			item->setTimeStamp( util::fileTimeToTimeStamp( pItemVQT[i].ftTimeStamp ) );
 		}
 	}
 	return res;
@@ -143,7 +143,9 @@ STDMETHODIMP ItemMgt::AddItems(
 			String itemID = wstring2string( pItemArray[i].szItemID );
 		#endif
 
-		if( ! opcAddressSpace::getInstance().isExistLeaf( itemID ) )
+		address_space::NamespaceVersionPtr version = addressSpace->getVersion();
+		address_space::Tag *tag = addressSpace->findLeaf( itemID );
+		if( tag == NULL )
 		{
 			(*ppErrors)[i] = OPC_E_UNKNOWNITEMID;
 			res = S_FALSE;
@@ -157,16 +159,24 @@ STDMETHODIMP ItemMgt::AddItems(
 			continue;
 		}
 
-		GroupItemElem item( new GroupItem() );
+		GroupItemElem item( new GroupItem( *addressSpace ) );
 		item->Init( pItemArray[i] );
-		(*ppAddResults)[i].hServer = item->getServerHandle();
+		Bool itemActived = ( pItemArray[i].bActive == TRUE || pItemArray[i].bActive == VARIANT_TRUE );
+		OPCHANDLE serverHandle = items.insert( item, pItemArray[i].hClient, itemActived, invalidDeadBand );
+		if( serverHandle == 0 )
+		{
+			(*ppErrors)[i] = E_OUTOFMEMORY; // no more slots in group
+			res = S_FALSE;
+			continue;
+		}
+		(*ppAddResults)[i].hServer = serverHandle;
 
-		address_space::Tag *tag = opcAddressSpace::getInstance().getTag( itemID );
 		(*ppAddResults)[i].vtCanonicalDataType = tag->getCanonicalDataType();
 		(*ppAddResults)[i].dwAccessRights = tag->getAccessRights();
 		(*ppAddResults)[i].dwBlobSize = 0;
 		(*ppAddResults)[i].pBlob = NULL;
-		itemList.insert( std::pair< OPCHANDLE, GroupItemElem > ( item->getServerHandle(), item ));
+		item->attach( &changeQueue, serverHandle );
+		item->setDemand( itemActived && actived );
 		(*ppErrors)[i] = S_OK;
 	}
 	return res;
@@ -278,7 +288,9 @@ STDMETHODIMP ItemMgt::ValidateItems(
 			itemID = wstring2string( pItemArray[i].szItemID );
 		#endif
 
-		if( ! opcAddressSpace::getInstance().isExistLeaf( itemID ) )
+		address_space::NamespaceVersionPtr version = addressSpace->getVersion();
+		address_space::Tag *item = addressSpace->findLeaf( itemID );
+		if( item == NULL )
 		{
 			(*ppErrors)[i] = OPC_E_UNKNOWNITEMID;
 			res = S_FALSE;
@@ -292,7 +304,6 @@ STDMETHODIMP ItemMgt::ValidateItems(
 			continue;
 		}
 
-		address_space::Tag *item = opcAddressSpace::getInstance().getTag(itemID );
 		ppValidationResults[0][i].vtCanonicalDataType = item->getCanonicalDataType();
 		ppValidationResults[0][i].dwAccessRights = item->getAccessRights();
 		ppValidationResults[0][i].dwBlobSize = 0;
@@ -367,21 +378,19 @@ STDMETHODIMP ItemMgt::RemoveItems(
 	os::win32::com::zeroMemory<HRESULT>( *ppErrors, dwCount );
 
 	HRESULT res = S_OK;
-	GroupItemElemList::iterator it;
 	boost::mutex::scoped_lock guard( groupGuard );
-	GroupItemElemList::iterator end = itemList.end();
 	for( DWORD i = 0; i < dwCount; ++i )
 	{
-		it = itemList.find( phServer[i] );
-		if( it == end ) 
+		size_t slot = items.find( phServer[i] );
+		if( slot == GroupItemTable::npos ) 
 		{
 			(*ppErrors)[i] = OPC_E_INVALIDHANDLE;
 			res = S_FALSE;
 			continue;
 		}
 		// and disconnected from all async requests
-		server->removeItemFromRequestList( phServer[i] );
-		itemList.erase( it );
+		server->removeItemFromRequestList( getServerHandle(), phServer[i] );
+		items.erase( slot );
 	}
 	return res;
 }
@@ -449,19 +458,17 @@ STDMETHODIMP ItemMgt::SetActiveState(
 	os::win32::com::zeroMemory<HRESULT>( *ppErrors, dwCount );
 
 	HRESULT res = S_OK;
-	GroupItemElemList::iterator it;
 	boost::mutex::scoped_lock guard( groupGuard );
-	GroupItemElemList::iterator end = itemList.end();
 	for( DWORD i = 0; i < dwCount; ++i )
 	{
-		it = itemList.find( phServer[i] );
-		if ( it == end )
+		size_t slot = items.find( phServer[i] );
+		if( slot == GroupItemTable::npos )
 		{
 			(*ppErrors)[i] = OPC_E_INVALIDHANDLE;
 			res = S_FALSE;
 			continue;
 		}
-		(*it).second->isActived( ( bActive == VARIANT_TRUE ) || ( bActive == TRUE ) );
+		setItemActived( slot, ( bActive == VARIANT_TRUE ) || ( bActive == TRUE ) );
 		(*ppErrors)[i] = S_OK;
 	}
 	return res;
@@ -531,19 +538,17 @@ STDMETHODIMP ItemMgt::SetClientHandles(
 	os::win32::com::zeroMemory< HRESULT >( *ppErrors, dwCount );
 
 	HRESULT res = S_OK;
-	GroupItemElemList::iterator it;
 	boost::mutex::scoped_lock guard( groupGuard );
-	GroupItemElemList::iterator end = itemList.end();
 	for( DWORD i = 0; i < dwCount; ++i )
 	{
-		it = itemList.find( phServer[i] );
-		if( it == end )
+		size_t slot = items.find( phServer[i] );
+		if( slot == GroupItemTable::npos )
 		{
 			(*ppErrors)[i] = OPC_E_INVALIDHANDLE;
 			res = S_FALSE;
 		}
 		else
-			(*it).second->setClientHandle( phClient[i] );
+			items.setClientHandle( slot, phClient[i] );
 	}
 	return res;
 }
@@ -618,13 +623,11 @@ STDMETHODIMP ItemMgt::SetDatatypes( /* [in] */ DWORD dwCount, /* [size_is][in] *
 	os::win32::com::zeroMemory< HRESULT >( *ppErrors, dwCount );
 
 	HRESULT res = S_OK;
-	GroupItemElemList::iterator it;
 	boost::mutex::scoped_lock guard( groupGuard );
-	GroupItemElemList::iterator end = itemList.end();
 	for( DWORD i = 0; i < dwCount; ++i )
 	{
-		it = itemList.find( phServer[i] );
-		if( it == end )
+		size_t slot = items.find( phServer[i] );
+		if( slot == GroupItemTable::npos )
 		{
 			(*ppErrors)[i] = OPC_E_INVALIDHANDLE;
 			res = S_FALSE;
@@ -636,7 +639,7 @@ STDMETHODIMP ItemMgt::SetDatatypes( /* [in] */ DWORD dwCount, /* [size_is][in] *
 			res = S_FALSE;
 			continue;
 		}
-		(*it).second->setRequestDataType( pRequestedDatatypes[i] );
+		items.getItem( slot )->setRequestDataType( pRequestedDatatypes[i] );
 	}
 	return res;
 }
@@ -680,14 +683,18 @@ STDMETHODIMP ItemMgt::CreateEnumerator( /* [in] */ REFIID riid, /* [iid_is][out]
 
 	if ( riid == IID_IEnumOPCItemAttributes)
 	{
-		if( itemList.empty() )
+		if( items.empty() )
 			return S_FALSE;
 
 		EnumOPCItemAttributes *temp = new EnumOPCItemAttributes();
 		if (temp == NULL)
 			return E_OUTOFMEMORY;
 
-		std::for_each( itemList.begin(), itemList.end(), boost::bind( &EnumOPCItemAttributes::addItem, temp, _1 ) );
+		for( size_t slot = 0; slot < items.getSlots(); ++slot )
+		{
+			if( items.isUsed( slot ) )
+				temp->addItem( items, slot );
+		}
 		return temp->QueryInterface(riid,(void**)ppUnk);
 	}
 	return E_INVALIDARG;
@@ -88,20 +88,15 @@ STDMETHODIMP OPCItemProperties::QueryAvailableProperties(
 		String itemID = wstring2string( szItemID );
 	#endif
 
-	if( opcAddressSpace::getInstance().isExistBranch( itemID ) )
+	if( addressSpace.isExistBranch( itemID ) )
 		return S_OK;
 
-	address_space::Tag *item = NULL;
-	try
-	{
-		item = opcAddressSpace::getInstance().getTag( itemID );
-	}
-	catch( address_space::Tag::NotExistTag& )
-	{
+	address_space::NamespaceVersionPtr version = addressSpace.getVersion();
+	address_space::Tag *item = addressSpace.findTag( itemID );
+	if( item == NULL )
 		return OPC_E_UNKNOWNITEMID;
-	}	
 
-	std::vector< DWORD > propArray = item->getAvailableProperties();
+	std::vector< UInt > propArray = item->getAvailableProperties();
 	*pdwCount = (DWORD) propArray.size();
 
 	*ppPropertyIDs = os::win32::com::allocMemory<DWORD>( *pdwCount );
@@ -227,15 +222,10 @@ STDMETHODIMP OPCItemProperties::GetItemProperties(
 		String itemID = wstring2string( szItemID );
 	#endif
 
-	address_space::Tag *item = NULL;
-	try
-	{
-		item = opcAddressSpace::getInstance().getLeaf( itemID );
-	}
-	catch( frl::opc::address_space::Tag::NotExistTag& )
-	{
-		return OPC_E_UNKNOWNITEMID;	
-	}
+	address_space::NamespaceVersionPtr version = addressSpace.getVersion();
+	address_space::Tag *item = addressSpace.findLeaf( itemID );
+	if( item == NULL )
+		return OPC_E_UNKNOWNITEMID;
 
 	*ppvData = os::win32::com::allocMemory< VARIANT >( dwCount );
 	if( *ppvData == NULL )
@@ -252,7 +242,7 @@ STDMETHODIMP OPCItemProperties::GetItemProperties(
 	HRESULT res = S_OK;
 	for( DWORD i = 0; i < dwCount; ++i )
 	{
-		(*ppErrors)[i] = item->getPropertyValue( pdwPropertyIDs[i], (*ppvData)[i] );
+		(*ppErrors)[i] = util::getTagPropertyValue( *item, pdwPropertyIDs[i], (*ppvData)[i] );
 		if( FAILED( (*ppErrors)[i] ) )
 			res = S_FALSE;
 	}
@@ -344,15 +334,10 @@ STDMETHODIMP OPCItemProperties::LookupItemIDs(
 		String itemID = wstring2string( szItemID );
 	#endif
 
-	address_space::Tag *item = NULL;
-	try
-	{
-		item = opcAddressSpace::getInstance().getLeaf( itemID );
-	}
-	catch( address_space::Tag::NotExistTag& )
-	{
+	address_space::NamespaceVersionPtr version = addressSpace.getVersion();
+	address_space::Tag *item = addressSpace.findLeaf( itemID );
+	if( item == NULL )
 		return OPC_E_UNKNOWNITEMID;
-	}	
 
 	*ppszNewItemIDs = os::win32::com::allocMemory< LPWSTR >( dwCount );
 	if( ppszNewItemIDs == NULL )
@@ -162,19 +162,24 @@ STDMETHODIMP SyncIO::Read(
 	HRESULT result = S_OK;
 
 	boost::mutex::scoped_lock guard( groupGuard );
-	GroupItemElemList::iterator it;
-	GroupItemElemList::iterator end = itemList.end();
 	for( DWORD i = 0; i < dwCount; ++i )
 	{
-		it = itemList.find( phServer[i] );
-		if( it == end )
+		size_t slot = items.find( phServer[i] );
+		if( slot == GroupItemTable::npos )
 		{
 			result = S_FALSE;
 			(*ppErrors)[i] = OPC_E_INVALIDHANDLE;
 			continue;
 		}
 
-		if( ! (*it).second->isReadable() )
+		if( ! items.getItem( slot )->isTagExist() )
+		{
+			result = S_FALSE;
+			(*ppErrors)[i] = OPC_E_UNKNOWNITEMID;
+			continue;
+		}
+
+		if( ! items.getItem( slot )->isReadable() )
 		{
 			result = S_FALSE;
 			(*ppErrors)[i] = OPC_E_BADRIGHTS;
@@ -184,13 +189,13 @@ STDMETHODIMP SyncIO::Read(
 		try
 		{
 			if( dwSource == OPC_DS_CACHE )
-				( *ppErrors )[i] = ( (*it).second->getCachedValue().copyTo( (*ppItemValues)[i].vDataValue ) );
+				( *ppErrors )[i] = ( items.getItem( slot )->getCachedValue().copyTo( (*ppItemValues)[i].vDataValue ) );
 			else
-				( *ppErrors )[i] = ( (*it).second->readValue() ).copyTo( (*ppItemValues)[i].vDataValue );
+				( *ppErrors )[i] = ( items.getItem( slot )->readValue() ).copyTo( (*ppItemValues)[i].vDataValue );
 		}
 		catch( Tag::NotExistTag& )
 		{
-			( *ppErrors )[i] = OPC_E_INVALIDHANDLE;
+			( *ppErrors )[i] = OPC_E_UNKNOWNITEMID;
 		}
 
 		if( FAILED( ( *ppErrors)[i] ) )
@@ -199,13 +204,13 @@ STDMETHODIMP SyncIO::Read(
 			continue;
 		}
 
-		if ( ( ! (*it).second->isActived() || ! actived ) && dwSource == OPC_DS_CACHE )
+		if ( ( ! items.isActive( slot ) || ! actived ) && dwSource == OPC_DS_CACHE )
 			(*ppItemValues)[i].wQuality = OPC_QUALITY_OUT_OF_SERVICE;
 		else
-			(*ppItemValues)[i].wQuality = (*it).second->getQuality();
+			(*ppItemValues)[i].wQuality = items.getItem( slot )->getQuality();
 
-		(*ppItemValues)[i].hClient = (*it).second->getClientHandle();
-		(*ppItemValues)[i].ftTimeStamp = (*it).second->getTimeStamp();
+		(*ppItemValues)[i].hClient = items.getClientHandle( slot );
+		(*ppItemValues)[i].ftTimeStamp = items.getItem( slot )->getTimeStamp();
 	}
 
 	return result;
@@ -328,19 +333,24 @@ STDMETHODIMP SyncIO::Write(
 
 	HRESULT result = S_OK;
 	boost::mutex::scoped_lock guard( groupGuard );
-	GroupItemElemList::iterator it;
-	GroupItemElemList::iterator end = itemList.end();
 	for( DWORD i = 0; i < dwCount; ++i )
 	{
-		it = itemList.find( phServer[i] );
-		if( it == end )
+		size_t slot = items.find( phServer[i] );
+		if( slot == GroupItemTable::npos )
 		{
 			result = S_FALSE;
 			(*ppErrors)[i] = OPC_E_INVALIDHANDLE;
 			continue;
 		}
 
-		if( ! (*it).second->isWritable() )
+		if( ! items.getItem( slot )->isTagExist() )
+		{
+			result = S_FALSE;
+			(*ppErrors)[i] = OPC_E_UNKNOWNITEMID;
+			continue;
+		}
+
+		if( ! items.getItem( slot )->isWritable() )
 		{
 			result = S_FALSE;
 			(*ppErrors)[i] = OPC_E_BADRIGHTS;
@@ -354,7 +364,7 @@ STDMETHODIMP SyncIO::Write(
 			continue;
 		}
 
-		(*ppErrors)[i] = (*it).second->writeValue( pItemValues[i] );
+		(*ppErrors)[i] = items.getItem( slot )->writeValue( pItemValues[i] );
 
 		if( FAILED( (*ppErrors)[i] ) )
 			result = S_FALSE;
@@ -511,18 +521,23 @@ STDMETHODIMP SyncIO::ReadMaxAge(
 	HRESULT result = S_OK;
 
 	boost::mutex::scoped_lock guard( groupGuard );
-	GroupItemElemList::iterator it;
-	GroupItemElemList::iterator end = itemList.end();
 	for( DWORD i = 0; i < dwCount; ++i )
 	{
-		it = itemList.find( phServer[i] );
-		if( it == end )
+		size_t slot = items.find( phServer[i] );
+		if( slot == GroupItemTable::npos )
 		{
 			result = S_FALSE;
 			(*ppErrors)[i] = OPC_E_INVALIDHANDLE;
 			continue;
 		}
-		if( ! (*it).second->isReadable() )
+		if( ! items.getItem( slot )->isTagExist() )
+		{
+			result = S_FALSE;
+			(*ppErrors)[i] = OPC_E_UNKNOWNITEMID;
+			continue;
+		}
+
+		if( ! items.getItem( slot )->isReadable() )
 		{
 			result = S_FALSE;
 			(*ppErrors)[i] = OPC_E_BADRIGHTS;
@@ -532,16 +547,16 @@ STDMETHODIMP SyncIO::ReadMaxAge(
 		{
 			if( pdwMaxAge[i] == 0xFFFFFFFF )
 			{
-				( *ppErrors )[i] = (*it).second->getCachedValue().copyTo( (*ppvValues)[i] );
+				( *ppErrors )[i] = items.getItem( slot )->getCachedValue().copyTo( (*ppvValues)[i] );
 			}
 			else
 			{
-				( *ppErrors )[i] = (*it).second->readValue().copyTo( (*ppvValues)[i]  );
+				( *ppErrors )[i] = items.getItem( slot )->readValue().copyTo( (*ppvValues)[i]  );
 			}
 		}
 		catch( Tag::NotExistTag& )
 		{
-			( *ppErrors )[i] = OPC_E_INVALIDHANDLE;
+			( *ppErrors )[i] = OPC_E_UNKNOWNITEMID;
 		}
 
 		if( FAILED( ( *ppErrors)[i] ) )
@@ -550,8 +565,8 @@ STDMETHODIMP SyncIO::ReadMaxAge(
 			continue;
 		}
 
-		(*ppwQualities)[i] = (*it).second->getQuality();
-		(*ppftTimeStamps)[i] = (*it).second->getTimeStamp();
+		(*ppwQualities)[i] = items.getItem( slot )->getQuality();
+		(*ppftTimeStamps)[i] = items.getItem( slot )->getTimeStamp();
 	}
 	return result;
 }
@@ -668,12 +683,11 @@ STDMETHODIMP SyncIO::WriteVQT(
 	os::win32::com::zeroMemory< HRESULT >( *ppErrors, dwCount );
 
 	HRESULT res = S_OK;
-	GroupItemElemList::iterator it;
-	GroupItemElemList::iterator end = itemList.end();
+	boost::mutex::scoped_lock guard( groupGuard );
 	for( DWORD i = 0; i < dwCount; ++i )
 	{
-		it = itemList.find( phServer[i] );
-		if( it == end )
+		size_t slot = items.find( phServer[i] );
+		if( slot == GroupItemTable::npos )
 		{
 			res = S_FALSE;
 			(*ppErrors)[i] = OPC_E_INVALIDHANDLE;
@@ -687,29 +701,29 @@ STDMETHODIMP SyncIO::WriteVQT(
 			continue;
 		}
 
-		if( ! (*it).second->isWritable() )
+		if( ! items.getItem( slot )->isTagExist() )
 		{
 			res = S_FALSE;
-			(*ppErrors)[i] = OPC_E_BADRIGHTS;
+			(*ppErrors)[i] = OPC_E_UNKNOWNITEMID;
 			continue;
 		}
 
-		(*ppErrors)[i] = (*it).second->writeValue( pItemVQT[i].vDataValue );
-
-		if( FAILED( (*ppErrors)[i] ) )
+		if( ! items.getItem( slot )->isWritable() )
 		{
 			res = S_FALSE;
+			(*ppErrors)[i] = OPC_E_BADRIGHTS;
 			continue;
 		}
 
-		if( pItemVQT[i].bQualitySpecified )
-		{
-			(*it).second->setQuality( pItemVQT[i].wQuality );
-		}
+		// value, quality and time stamp are changed together
+		(*ppErrors)[i] = items.getItem( slot )->writeValue( pItemVQT[i].vDataValue,
+			pItemVQT[i].bQualitySpecified ? &pItemVQT[i].wQuality : NULL,
+			pItemVQT[i].bTimeStampSpecified ? &pItemVQT[i].ftTimeStamp : NULL );
 
-		if( pItemVQT[i].bTimeStampSpecified )
+		if( FAILED( (*ppErrors)[i] ) )
 		{
-			(*it).second->setTimeStamp( pItemVQT[i].ftTimeStamp );
+			res = S_FALSE;
+			continue;
 		}
 	}
 	return res;
@@ -1,4 +1,9 @@
 #include "sys/frl_sys_util.h"
+#if( FRL_PLATFORM != FRL_PLATFORM_WIN32 )
+#include <errno.h>
+#include <string.h>
+#include "frl_string.h"
+#endif
 
 namespace frl{ namespace sys{ namespace util{
 
@@ -51,6 +56,20 @@ String getCodeErrorDescription( WORD langID, DWORD error )
 	}
 	return out;
 }
+#else
+String getLastErrorDescription()
+{
+	return getCodeErrorDescription( errno );
+}
+
+String getCodeErrorDescription( Int error )
+{
+	#if( FRL_CHARACTER == FRL_CHARACTER_UNICODE )
+		return string2wstring( strerror( error ) );
+	#else
+		return strerror( error );
+	#endif
+}
 #endif // FRL_PLATFORM_WIN32
 
 } // namespace util
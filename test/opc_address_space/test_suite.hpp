@@ -2,6 +2,23 @@
 #define opc_address_space_test_suite_h_
 #include <boost/test/unit_test.hpp>
 #include "opc/address_space/frl_opc_address_space.h"
+#include "opc/address_space/frl_opc_leaf_enumerator.h"
+#include "opc/address_space/frl_opc_change_queue.h"
+#include "opc/address_space/frl_opc_sampling_scheduler.h"
+#include "opc/address_space/frl_opc_addr_space_crawler.h"
+#include "opc/address_space/frl_opc_deadband_filter.h"
+#include "opc/frl_opc_update_scheduler.h"
+#include "opc/frl_opc_executor.h"
+#include "opc/frl_opc_item_table.h"
+#include "stream_std/frl_sstream.h"
+#include "frl_lexical_cast.h"
+#include <boost/thread/thread.hpp>
+#include <boost/bind.hpp>
+#include <boost/scoped_array.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <limits>
+#include <stdexcept>
 
 BOOST_AUTO_TEST_SUITE( opc_address_space )
 
@@ -17,6 +34,16 @@ BOOST_AUTO_TEST_CASE( create_branch_in_root_branch )
 	BOOST_CHECK_NO_THROW( BOOST_CHECK( addressSpace.getBranch( branchName )->getID() == branchName ) );
 }
 
+BOOST_AUTO_TEST_CASE( final_construct_delimiter )
+{
+	using namespace frl::opc::address_space;
+	AddressSpace addressSpace;
+	BOOST_CHECK_THROW( addressSpace.finalConstruct( FRL_STR( "::" ) ), AddressSpace::InvalidParameter );
+	BOOST_CHECK_THROW( addressSpace.addBranch( FRL_STR( "branch1" ) ), AddressSpace::NotFinalConstruct );
+	addressSpace.finalConstruct( FRL_STR( "" ) );
+	BOOST_CHECK( addressSpace.getDelimiter() == FRL_STR( "." ) );
+}
+
 BOOST_AUTO_TEST_CASE( create_branch_in_branch )
 {
 	using namespace frl::opc::address_space;
@@ -159,6 +186,1752 @@ BOOST_AUTO_TEST_CASE( create_double_leaf )
 	BOOST_CHECK_THROW( addressSpace.addLeaf( FRL_STR( "leaf1" ) ), Tag::IsExistTag );
 }
 
+BOOST_AUTO_TEST_CASE( value_change_type )
+{
+	using namespace frl::opc::address_space;
+	Value val( 10 );
+	BOOST_CHECK( val.getType() == data_type::I4 );
+	BOOST_CHECK( val.setType( data_type::R8 ) );
+	BOOST_CHECK( double( val ) == 10.0 );
+	BOOST_CHECK( val.setType( data_type::STRING ) );
+	BOOST_CHECK( frl::String( val ) == FRL_STR( "10" ) );
+	BOOST_CHECK( val.setType( data_type::UI1 ) );
+	BOOST_CHECK( (unsigned char)( val ) == 10 );
+
+	Value str( FRL_STR( "not number" ) );
+	BOOST_CHECK( ! str.setType( data_type::I4 ) );
+	BOOST_CHECK( str.getType() == data_type::STRING );
+
+	Value big( 1000 );
+	BOOST_CHECK( ! big.setType( data_type::I1 ) );
+	BOOST_CHECK_THROW( static_cast< float >( big ), Value::InvalidType );
+
+	Value empty;
+	BOOST_CHECK( empty.setType( data_type::R4 ) );
+	BOOST_CHECK( float( empty ) == 0.0f );
+}
+
+BOOST_AUTO_TEST_CASE( time_stamp_date_conversion )
+{
+	using namespace frl::opc::address_space;
+	// January 1, 1970 as OLE date
+	TimeStamp ts = TimeStamp::fromDate( 25569.0 );
+	BOOST_CHECK( ts.getTicks() == 116444736000000000ULL );
+	BOOST_CHECK( ts.toDate() == 25569.0 );
+	BOOST_CHECK( ts < TimeStamp::now() );
+}
+
+BOOST_AUTO_TEST_CASE( tag_write_and_property )
+{
+	using namespace frl::opc::address_space;
+	AddressSpace addressSpace;
+	addressSpace.finalConstruct( FRL_STR(".") );
+	Tag *tag = addressSpace.addLeaf( FRL_STR( "leaf1" ) );
+	tag->setTimeStamp( TimeStamp() );
+	tag->write( 0.5 );
+	BOOST_CHECK( double( tag->read() ) == 0.5 );
+	BOOST_CHECK( ! tag->getTimeStamp().isNull() );
+
+	Value prop;
+	BOOST_CHECK( tag->getPropertyValue( property::DATATYPE, prop ) );
+	BOOST_CHECK( short( prop ) == data_type::R8 );
+	BOOST_CHECK( ! tag->getPropertyValue( 1000, prop ) );
+}
+
+BOOST_AUTO_TEST_CASE( lookup_many_leafs )
+{
+	using namespace frl::opc::address_space;
+	AddressSpace addressSpace;
+	addressSpace.finalConstruct( FRL_STR(".") );
+	addressSpace.addBranch( FRL_STR( "branch1" ) );
+	std::vector< frl::String > names;
+	for( int i = 0; i < 1000; ++i )
+	{
+		frl::stream_std::OutString ss;
+		ss << FRL_STR( "branch1.leaf" ) << i;
+		names.push_back( ss.str() );
+		BOOST_CHECK_NO_THROW( addressSpace.addLeaf( names.back() ) );
+	}
+	for( size_t i = 0; i < names.size(); ++i )
+	{
+		BOOST_CHECK( addressSpace.isExistLeaf( names[i] ) );
+		BOOST_CHECK( addressSpace.getLeaf( names[i] )->getID() == names[i] );
+	}
+	BOOST_CHECK( ! addressSpace.isExistLeaf( FRL_STR( "branch1.leaf1000" ) ) );
+	BOOST_CHECK( ! addressSpace.isExistLeaf( FRL_STR( "branch1" ) ) );
+	BOOST_CHECK( addressSpace.isExistBranch( FRL_STR( "branch1" ) ) );
+
+	std::vector< frl::String > all;
+	addressSpace.getAllLeafs( all, 0 );
+	BOOST_CHECK( all.size() == names.size() );
+}
+
+BOOST_AUTO_TEST_CASE( find_tag_without_exceptions )
+{
+	using namespace frl::opc::address_space;
+	AddressSpace addressSpace;
+	addressSpace.finalConstruct( FRL_STR(".") );
+	addressSpace.addBranch( FRL_STR( "branch1" ) );
+	Tag *leaf = addressSpace.addLeaf( FRL_STR( "branch1.leaf1" ) );
+
+	BOOST_CHECK( addressSpace.findLeaf( FRL_STR( "branch1.leaf1" ) ) == leaf );
+	BOOST_CHECK( addressSpace.findTag( FRL_STR( "branch1.leaf1" ) ) == leaf );
+	BOOST_CHECK( addressSpace.findTag( FRL_STR( "branch1" ) ) == addressSpace.getBranch( FRL_STR( "branch1" ) ) );
+	BOOST_CHECK( addressSpace.findTag( FRL_STR( "" ) ) == addressSpace.getRootBranch() );
+	BOOST_CHECK( addressSpace.findLeaf( FRL_STR( "branch1" ) ) == NULL );
+	BOOST_CHECK( addressSpace.findBranch( FRL_STR( "branch1.leaf1" ) ) == NULL );
+	BOOST_CHECK( addressSpace.findTag( FRL_STR( "branch2.leaf1" ) ) == NULL );
+	BOOST_CHECK( addressSpace.getBranch( FRL_STR( "branch1" ) )->findChild( FRL_STR( "branch1.leaf1" ) ) == leaf );
+	BOOST_CHECK_THROW( addressSpace.getTag( FRL_STR( "branch2" ) ), Tag::NotExistTag );
+}
+
+namespace opc_address_space_test
+{
+	struct ValueCellWriter
+	{
+		frl::opc::address_space::ValueCell *cell;
+		void operator()()
+		{
+			using namespace frl::opc::address_space;
+			for( frl::ULong i = 1; i <= 200000; ++i )
+			{
+				if( i % 2 )
+					cell->write( Value( (double)i ), TimeStamp( i ) );
+				else
+					cell->write( Value( frl::String( i % 100, FRL_STR( 'x' ) ) ), TimeStamp( i ) );
+			}
+		}
+	};
+
+	struct ValueCellReader
+	{
+		frl::opc::address_space::ValueCell *cell;
+		bool *torn;
+		void operator()()
+		{
+			using namespace frl::opc::address_space;
+			Value val;
+			frl::UShort quality;
+			TimeStamp ts;
+			for( int i = 0; i < 200000; ++i )
+			{
+				cell->read( val, quality, ts );
+				frl::ULong ticks = ts.getTicks();
+				if( val.getType() == data_type::R8 )
+				{
+					if( double( val ) != (double)ticks )
+						*torn = true;
+				}
+				else if( val.getType() == data_type::STRING )
+				{
+					if( frl::String( val ).size() != ticks % 100 )
+						*torn = true;
+				}
+			}
+		}
+	};
+
+	struct TagWriter
+	{
+		frl::opc::address_space::Tag *tag;
+		int count;
+		void operator()()
+		{
+			for( int i = 1; i <= count; ++i )
+				tag->write( frl::opc::address_space::Value( i ) );
+		}
+	};
+
+	struct CountingListener : public frl::opc::address_space::TagListener
+	{
+		int changes;
+		CountingListener() : changes( 0 ) {}
+		~CountingListener() { unsubscribe(); }
+		void onTagChange( const frl::opc::address_space::Tag* ) { ++changes; }
+	};
+
+	// Removes tags one by one while their listeners unsubscribe.
+	struct TagRemover
+	{
+		frl::opc::address_space::AddressSpace *space;
+		int count;
+		void operator()()
+		{
+			for( int i = 0; i < count; ++i )
+				space->removeTag( FRL_STR( "leaf" ) + frl::lexicalCast< int, frl::String >( i ) );
+		}
+	};
+
+	void countCall( int *counter )
+	{
+		++*counter;
+	}
+	// Reads whole tree while other thread adds batches of batchSize leafs.
+	struct NamespaceReader
+	{
+		frl::opc::address_space::AddressSpace *space;
+		size_t batchSize;
+		bool *torn;
+		void operator()()
+		{
+			std::vector< frl::String > leafs;
+			size_t last = 0;
+			for( int i = 0; i < 300; ++i )
+			{
+				space->getAllLeafs( leafs, 0 );
+				if( leafs.size() % batchSize != 0 || leafs.size() < last )
+					*torn = true;
+				last = leafs.size();
+			}
+		}
+	};
+
+	// Resolves tags by ID and by handle while other thread removes and re-adds them.
+	struct HandleReader
+	{
+		frl::opc::address_space::AddressSpace *space;
+		frl::opc::address_space::TagHandle first;
+		bool *torn;
+		void operator()()
+		{
+			using namespace frl::opc::address_space;
+			for( int i = 0; i < 20000; ++i )
+			{
+				NamespaceVersionPtr version = space->getVersion();
+				if( space->findTag( first ) != NULL )
+					*torn = true;
+				Tag *tag = space->findLeaf( FRL_STR( "device.leaf" ) );
+				if( tag == NULL )
+					continue;
+				Tag *byHandle = space->findTag( space->getHandle( tag ) );
+				if( ( byHandle != NULL && byHandle != tag ) || tag->getID() != FRL_STR( "device.leaf" ) )
+					*torn = true;
+			}
+		}
+	};
+
+	// Remembers sizes of batches passed by scheduler.
+	struct RecordingDriver : public frl::opc::address_space::SamplingDriver
+	{
+		std::vector< size_t > calls;
+		void sample( const std::vector< frl::opc::address_space::Tag* > &tags )
+		{
+			calls.push_back( tags.size() );
+			for( size_t i = 0; i < tags.size(); ++i )
+				tags[i]->write( frl::opc::address_space::Value( (int)calls.size() ) );
+		}
+	};
+
+	// Builds subtree "plant.<device>" of one device in its own address space.
+	struct PartBuilder
+	{
+		frl::opc::address_space::AddressSpace *part;
+		int device;
+		void operator()()
+		{
+			using namespace frl::opc::address_space;
+			std::vector< LeafDefinition > leafs;
+			for( int i = 0; i < 300; ++i )
+			{
+				frl::stream_std::OutString ss;
+				ss << FRL_STR( "plant.dev" ) << device << FRL_STR( ".ch" ) << i % 3 << FRL_STR( ".v" ) << i;
+				leafs.push_back( LeafDefinition( ss.str(), data_type::R8,
+					i == 0 ? access_rights::READABLE | access_rights::WRITEABLE : access_rights::READABLE ) );
+			}
+			part->addLeafs( leafs );
+		}
+	};
+
+	// Task of UpdateScheduler which counts its runs.
+	struct PeriodicTask
+	{
+		frl::UInt *runs;
+		frl::UInt period;
+		frl::UInt operator()()
+		{
+			++*runs;
+			return period;
+		}
+	};
+
+	// Task of UpdateScheduler which counts its runs and throws.
+	struct FailingTask
+	{
+		frl::UInt *runs;
+		frl::UInt operator()()
+		{
+			++*runs;
+			throw std::runtime_error( "update failed" );
+		}
+	};
+
+	// Task of UpdateScheduler which takes changes and sleeps until next change.
+	struct DrainingTask
+	{
+		frl::opc::address_space::ChangeQueue *queue;
+		std::vector< frl::UInt > *taken;
+		frl::UInt *runs;
+		frl::UInt operator()()
+		{
+			++*runs;
+			std::vector< frl::UInt > keys;
+			queue->take( keys );
+			taken->insert( taken->end(), keys.begin(), keys.end() );
+			return frl::opc::UpdateScheduler::idle;
+		}
+	};
+
+	// Task of strand, records its index and whether other task of strand ran meanwhile.
+	struct OrderedTask
+	{
+		std::vector< int > *done;
+		int *inside;
+		bool *overlapped;
+		int index;
+		void operator()()
+		{
+			if( (*inside)++ != 0 )
+				*overlapped = true;
+			done->push_back( index );
+			boost::this_thread::yield();
+			--*inside;
+		}
+	};
+
+	// Task which counts its runs and posts next task count times.
+	struct ChainTask
+	{
+		frl::opc::Executor *executor;
+		boost::mutex *guard;
+		int *runs;
+		int count;
+		void operator()()
+		{
+			{
+				boost::mutex::scoped_lock lock( *guard );
+				++*runs;
+			}
+			if( count == 0 )
+				return;
+			ChainTask next = *this;
+			--next.count;
+			executor->post( next );
+		}
+	};
+
+	// Task which counts its run and throws.
+	struct ThrowingTask
+	{
+		boost::mutex *guard;
+		int *runs;
+		void operator()()
+		{
+			{
+				boost::mutex::scoped_lock lock( *guard );
+				++*runs;
+			}
+			throw std::runtime_error( "task failed" );
+		}
+	};
+} // namespace opc_address_space_test
+
+BOOST_AUTO_TEST_CASE( value_cell_concurrent_snapshot )
+{
+	using namespace frl::opc::address_space;
+	ValueCell cell( data_type::EMPTY, quality::GOOD );
+	bool torn1 = false, torn2 = false;
+	opc_address_space_test::ValueCellWriter writer = { &cell };
+	opc_address_space_test::ValueCellReader reader1 = { &cell, &torn1 };
+	opc_address_space_test::ValueCellReader reader2 = { &cell, &torn2 };
+	boost::thread_group threads;
+	threads.create_thread( writer );
+	threads.create_thread( reader1 );
+	threads.create_thread( reader2 );
+	threads.join_all();
+	BOOST_CHECK( ! torn1 && ! torn2 );
+	BOOST_CHECK( cell.getTimeStamp().getTicks() == 200000 );
+}
+
+BOOST_AUTO_TEST_CASE( bulk_add_leafs )
+{
+	using namespace frl::opc::address_space;
+	AddressSpace addressSpace;
+	addressSpace.finalConstruct( FRL_STR(".") );
+	addressSpace.addBranch( FRL_STR( "area" ) );
+	std::vector< LeafDefinition > leafs;
+	for( int i = 999; i >= 0; --i )
+	{
+		frl::stream_std::OutString ss;
+		ss << FRL_STR( "area.cell" ) << i % 10 << FRL_STR( ".tag" ) << i;
+		leafs.push_back( LeafDefinition( ss.str(), data_type::R4, access_rights::READABLE | access_rights::WRITEABLE, 100 ) );
+	}
+	leafs.push_back( LeafDefinition( FRL_STR( "rootLeaf" ), data_type::BOOL ) );
+	std::vector< Tag* > added;
+	BOOST_CHECK_NO_THROW( addressSpace.addLeafs( leafs, added ) );
+	BOOST_CHECK( added.size() == leafs.size() );
+	for( size_t i = 0; i < leafs.size(); ++i )
+	{
+		BOOST_CHECK( addressSpace.findLeaf( leafs[i].fullPath ) == added[i] );
+		BOOST_CHECK( added[i]->getID() == leafs[i].fullPath );
+		BOOST_CHECK( added[i]->getCanonicalDataType() == leafs[i].dataType );
+	}
+	BOOST_CHECK( added[0]->isWritable() && added[0]->getScanRate() == 100 );
+	BOOST_CHECK( added[0]->getParent() == addressSpace.getBranch( FRL_STR( "area.cell9" ) ) );
+	BOOST_CHECK( added.back()->getParent() == addressSpace.getRootBranch() );
+	std::vector< frl::String > cells;
+	addressSpace.getBranch( FRL_STR( "area" ) )->browseBranches( cells );
+	BOOST_CHECK( cells.size() == 10 );
+
+	// tags created one by one and in bulk live together
+	BOOST_CHECK_NO_THROW( addressSpace.addLeaf( FRL_STR( "area.cell0.single" ) ) );
+	std::vector< frl::String > all;
+	addressSpace.getAllLeafs( all, 0 );
+	BOOST_CHECK( all.size() == leafs.size() + 1 );
+
+	// invalid batch does not change address space
+	std::vector< LeafDefinition > invalid;
+	invalid.push_back( LeafDefinition( FRL_STR( "area2.tag" ) ) );
+	invalid.push_back( LeafDefinition( FRL_STR( "area.cell0.tag0" ) ) );
+	BOOST_CHECK_THROW( addressSpace.addLeafs( invalid ), Tag::IsExistTag );
+	BOOST_CHECK( ! addressSpace.isExistBranch( FRL_STR( "area2" ) ) );
+	invalid[1] = LeafDefinition( FRL_STR( "area2.tag.sub" ) );
+	BOOST_CHECK_THROW( addressSpace.addLeafs( invalid ), Tag::IsNotBranch );
+	invalid[1] = LeafDefinition( FRL_STR( "area2..tag" ) );
+	BOOST_CHECK_THROW( addressSpace.addLeafs( invalid ), AddressSpace::InvalidLeafName );
+	BOOST_CHECK( ! addressSpace.isExistTag( FRL_STR( "area2.tag" ) ) );
+}
+
+BOOST_AUTO_TEST_CASE( tag_memory_usage )
+{
+	using namespace frl::opc::address_space;
+	AddressSpace addressSpace;
+	addressSpace.finalConstruct( FRL_STR(".") );
+	addressSpace.addBranch( FRL_STR( "branch" ) );
+	for( int i = 0; i < 100; ++i )
+	{
+		frl::stream_std::OutString ss;
+		ss << FRL_STR( "branch.long_name_of_leaf_" ) << i;
+		addressSpace.addLeaf( ss.str() );
+	}
+	Tag *leaf = addressSpace.getLeaf( FRL_STR( "branch.long_name_of_leaf_7" ) );
+	BOOST_CHECK( leaf->getShortID() == FRL_STR( "long_name_of_leaf_7" ) );
+	BOOST_CHECK( addressSpace.getBranch( FRL_STR( "branch" ) )->getShortID() == FRL_STR( "branch" ) );
+	BOOST_CHECK_THROW( leaf->addLeaf( FRL_STR( "branch.long_name_of_leaf_7.sub" ) ), Tag::IsNotBranch );
+	BOOST_CHECK( leaf->findChild( FRL_STR( "branch.long_name_of_leaf_7.sub" ) ) == NULL );
+
+	MemoryUsage usage = addressSpace.getMemoryUsage();
+	BOOST_CHECK( usage.leafsNumber == 100 );
+	BOOST_CHECK( usage.branchesNumber == 2 ); // with root
+	BOOST_CHECK( usage.tagsSize >= 102 * sizeof( Tag ) );
+	BOOST_CHECK( usage.idsSize > 0 );
+	BOOST_CHECK( usage.childrenSize > 0 );
+	BOOST_CHECK( usage.subscriptionsSize == 0 );
+	BOOST_CHECK( usage.getTotalSize() == usage.tagsSize + usage.idsSize + usage.childrenSize + usage.indexesSize );
+
+	leaf->subscribeToOpcChange( boost::function< void() >() );
+	BOOST_CHECK( addressSpace.getMemoryUsage().subscriptionsSize > 0 );
+}
+
+BOOST_AUTO_TEST_CASE( browse_by_pages )
+{
+	using namespace frl::opc::address_space;
+	AddressSpace addressSpace;
+	addressSpace.finalConstruct( FRL_STR(".") );
+	std::vector< LeafDefinition > leafs;
+	for( int i = 0; i < 1000; ++i )
+	{
+		frl::stream_std::OutString ss;
+		ss << FRL_STR( "big.leaf" ) << i;
+		leafs.push_back( LeafDefinition( ss.str() ) );
+	}
+	for( int i = 0; i < 15; ++i )
+	{
+		frl::stream_std::OutString ss;
+		ss << FRL_STR( "big.branch" ) << i << FRL_STR( ".leaf" );
+		leafs.push_back( LeafDefinition( ss.str() ) );
+	}
+	addressSpace.addLeafs( leafs );
+	Tag *big = addressSpace.getBranch( FRL_STR( "big" ) );
+
+	std::vector< TagBrowseInfo > page;
+	std::vector< TagBrowseInfo > all;
+	frl::String cp;
+	size_t pages = 0;
+	do
+	{
+		BOOST_CHECK( big->browsePage( page, browse_filter::ALL, cp, 100, NamePattern(), cp ) );
+		BOOST_CHECK( page.size() <= 100 );
+		all.insert( all.end(), page.begin(), page.end() );
+		++pages;
+	}
+	while( ! cp.empty() );
+	BOOST_CHECK( pages == 11 );
+	BOOST_CHECK( all.size() == 1015 );
+	for( size_t i = 0; i < all.size(); ++i )
+	{
+		BOOST_CHECK( all[i].isLeaf == ( i < 1000 ) );
+		if( i > 0 && all[i].isLeaf == all[i-1].isLeaf )
+			BOOST_CHECK( all[i-1].fullID < all[i].fullID );
+	}
+
+	// page ends exactly on last leaf: next page starts from branches
+	BOOST_CHECK( big->browsePage( page, browse_filter::ALL, FRL_STR( "big.leaf998" ), 2, NamePattern(), cp ) );
+	BOOST_CHECK( page.size() == 2 ); // leaf998, leaf999
+	BOOST_CHECK( cp == FRL_STR( "big.branch0" ) );
+	BOOST_CHECK( big->browsePage( page, browse_filter::ALL, FRL_STR( "big.leaf998" ), 3, NamePattern(), cp ) );
+	BOOST_CHECK( page.size() == 3 && ! page.back().isLeaf );
+	BOOST_CHECK( cp == FRL_STR( "big.branch1" ) );
+
+	// filters
+	BOOST_CHECK( big->browsePage( page, browse_filter::BRANCHES, frl::String(), 0, NamePattern(), cp ) );
+	BOOST_CHECK( page.size() == 15 && cp.empty() );
+	NamePattern filter( FRL_STR( "leaf99*" ) );
+	BOOST_CHECK( big->browsePage( page, browse_filter::LEAFS, frl::String(), 5, filter, cp ) );
+	BOOST_CHECK( page.size() == 5 && page[0].shortID == FRL_STR( "leaf99" ) );
+	BOOST_CHECK( cp == FRL_STR( "big.leaf994" ) );
+	BOOST_CHECK( big->browsePage( page, browse_filter::LEAFS, cp, 5, filter, cp ) );
+	BOOST_CHECK( page.size() == 5 && cp == FRL_STR( "big.leaf999" ) );
+	BOOST_CHECK( big->browsePage( page, browse_filter::LEAFS, cp, 5, filter, cp ) );
+	BOOST_CHECK( page.size() == 1 && cp.empty() );
+
+	// invalid continuation points
+	BOOST_CHECK( ! big->browsePage( page, browse_filter::ALL, FRL_STR( "big.unknown" ), 10, NamePattern(), cp ) );
+	BOOST_CHECK( ! big->browsePage( page, browse_filter::LEAFS, FRL_STR( "big.branch0" ), 10, NamePattern(), cp ) );
+}
+
+BOOST_AUTO_TEST_CASE( name_pattern_match )
+{
+	using namespace frl::opc::address_space;
+	BOOST_CHECK( NamePattern().match( FRL_STR( "any" ) ) );
+	BOOST_CHECK( NamePattern( FRL_STR( "*" ) ).isMatchAll() );
+	BOOST_CHECK( NamePattern( FRL_STR( "tag" ) ).match( FRL_STR( "tag" ) ) );
+	BOOST_CHECK( ! NamePattern( FRL_STR( "tag" ) ).match( FRL_STR( "tag1" ) ) );
+	BOOST_CHECK( ! NamePattern( FRL_STR( "tag1" ) ).match( FRL_STR( "tag" ) ) );
+	BOOST_CHECK( NamePattern( FRL_STR( "t?g" ) ).match( FRL_STR( "tag" ) ) );
+	BOOST_CHECK( NamePattern( FRL_STR( "tag#" ) ).match( FRL_STR( "tag7" ) ) );
+	BOOST_CHECK( ! NamePattern( FRL_STR( "tag#" ) ).match( FRL_STR( "tagx" ) ) );
+	BOOST_CHECK( NamePattern( FRL_STR( "a*b*c" ) ).match( FRL_STR( "aXXbYbc" ) ) );
+	BOOST_CHECK( ! NamePattern( FRL_STR( "a*b*c" ) ).match( FRL_STR( "aXXbYbcd" ) ) );
+	BOOST_CHECK( NamePattern( FRL_STR( "*.value" ) ).match( FRL_STR( "area1.tag.value" ) ) );
+	BOOST_CHECK( NamePattern( FRL_STR( "[a-c]x" ) ).match( FRL_STR( "bx" ) ) );
+	BOOST_CHECK( ! NamePattern( FRL_STR( "[a-c]x" ) ).match( FRL_STR( "dx" ) ) );
+	BOOST_CHECK( NamePattern( FRL_STR( "[!a-c]x" ) ).match( FRL_STR( "dx" ) ) );
+	BOOST_CHECK( NamePattern( FRL_STR( "[xyz]" ) ).match( FRL_STR( "y" ) ) );
+	BOOST_CHECK( NamePattern( FRL_STR( "[x" ) ).match( FRL_STR( "[x" ) ) );
+	BOOST_CHECK( ! NamePattern( FRL_STR( "TAG*" ) ).match( FRL_STR( "tag1" ) ) );
+	BOOST_CHECK( NamePattern( FRL_STR( "TAG*" ), frl::False ).match( FRL_STR( "tag1" ) ) );
+	BOOST_CHECK( NamePattern( FRL_STR( "[A-C]*" ), frl::False ).match( FRL_STR( "box" ) ) );
+
+	BOOST_CHECK( NamePattern( FRL_STR( "*.tag" ) ).match( FRL_STR( "a.tag.tag" ) ) );
+	BOOST_CHECK( ! NamePattern( FRL_STR( "*.tag" ) ).match( FRL_STR( "a.tags" ) ) );
+	BOOST_CHECK( ! NamePattern( FRL_STR( "*?tag" ) ).match( FRL_STR( "tag" ) ) );
+
+	BOOST_CHECK( NamePattern( FRL_STR( "area#.x*" ) ).matchBeginning( FRL_STR( "area1." ) ) );
+	BOOST_CHECK( ! NamePattern( FRL_STR( "area#.x*" ) ).matchBeginning( FRL_STR( "areab." ) ) );
+	BOOST_CHECK( NamePattern( FRL_STR( "*.x" ) ).matchBeginning( FRL_STR( "any." ) ) );
+
+	BOOST_CHECK( NamePattern( FRL_STR( "area1.t?g*" ) ).getPrefix() == FRL_STR( "area1.t" ) );
+	BOOST_CHECK( NamePattern( FRL_STR( "area*" ), frl::False ).getPrefix().empty() );
+}
+
+BOOST_AUTO_TEST_CASE( flat_browse_with_pattern )
+{
+	using namespace frl::opc::address_space;
+	AddressSpace addressSpace;
+	addressSpace.finalConstruct( FRL_STR( "." ) );
+	std::vector< LeafDefinition > leafs;
+	for( int area = 1; area <= 12; ++area )
+	{
+		for( int i = 0; i < 10; ++i )
+		{
+			frl::stream_std::OutString ss;
+			ss << FRL_STR( "area" ) << area << FRL_STR( ".tag" ) << i;
+			leafs.push_back( LeafDefinition( ss.str() ) );
+		}
+	}
+	leafs.push_back( LeafDefinition( FRL_STR( "area1.sub.tag0" ) ) );
+	leafs.push_back( LeafDefinition( FRL_STR( "area10x" ) ) );
+	addressSpace.addLeafs( leafs );
+
+	std::vector< frl::String > names;
+	addressSpace.getAllLeafs( names, NamePattern( FRL_STR( "area1.*" ) ), 0 );
+	BOOST_CHECK( names.size() == 11 );
+
+	addressSpace.getAllLeafs( names, NamePattern( FRL_STR( "area1*" ) ), 0 );
+	BOOST_CHECK( names.size() == 11 + 10 + 10 + 10 + 1 );
+
+	addressSpace.getAllLeafs( names, NamePattern( FRL_STR( "area1.sub.*" ) ), 0 );
+	BOOST_CHECK( names.size() == 1 && names[0] == FRL_STR( "area1.sub.tag0" ) );
+
+	addressSpace.getAllLeafs( names, NamePattern( FRL_STR( "*.tag#" ) ), 0 );
+	BOOST_CHECK( names.size() == 121 );
+
+	addressSpace.getAllLeafs( names, NamePattern( FRL_STR( "area2.tag[0-4]" ) ), 0 );
+	BOOST_CHECK( names.size() == 5 );
+
+	addressSpace.getAllLeafs( names, NamePattern( FRL_STR( "AREA3.*" ), frl::False ), 0 );
+	BOOST_CHECK( names.size() == 10 );
+
+	addressSpace.getAllLeafs( names, NamePattern( FRL_STR( "area7.unknown.*" ) ), 0 );
+	BOOST_CHECK( names.empty() );
+
+	// the same result as full walk with filter
+	std::vector< frl::String > all;
+	addressSpace.getAllLeafs( all, 0 );
+	NamePattern pattern( FRL_STR( "area1?.tag[!5-9]" ) );
+	size_t count = 0;
+	for( size_t i = 0; i < all.size(); ++i )
+	{
+		if( pattern.match( all[i] ) )
+			++count;
+	}
+	addressSpace.getAllLeafs( names, pattern, 0 );
+	BOOST_CHECK( names.size() == count && count == 15 );
+}
+
+BOOST_AUTO_TEST_CASE( flat_leafs_enumerator )
+{
+	using namespace frl::opc::address_space;
+	AddressSpace addressSpace;
+	addressSpace.finalConstruct( FRL_STR( "." ) );
+	std::vector< LeafDefinition > leafs;
+	for( int area = 0; area < 5; ++area )
+	{
+		for( int i = 0; i < 20; ++i )
+		{
+			frl::stream_std::OutString ss;
+			ss << FRL_STR( "area" ) << area << FRL_STR( ".cell" ) << i % 3 << FRL_STR( ".tag" ) << i;
+			leafs.push_back( LeafDefinition( ss.str(), data_type::R8,
+				i % 2 ? access_rights::READABLE : access_rights::READABLE | access_rights::WRITEABLE ) );
+		}
+	}
+	leafs.push_back( LeafDefinition( FRL_STR( "area0-x" ) ) );
+	leafs.push_back( LeafDefinition( FRL_STR( "root_leaf" ) ) );
+	addressSpace.addLeafs( leafs );
+
+	std::vector< frl::String > all;
+	addressSpace.getAllLeafs( all, 0 );
+
+	// chunks of 7 leafs give the same sequence as full walk
+	LeafEnumerator enumerator( addressSpace, NamePattern(), 0, 7 );
+	std::vector< frl::String > enumerated;
+	frl::String id;
+	while( enumerator.next( id ) )
+		enumerated.push_back( id );
+	BOOST_CHECK( enumerated == all );
+	BOOST_CHECK( ! enumerator.hasNext() );
+
+	enumerator.reset();
+	BOOST_CHECK( enumerator.skip( 10 ) == 10 );
+	BOOST_CHECK( enumerator.next( id ) && id == all[10] );
+	BOOST_CHECK( enumerator.skip( 1000 ) == all.size() - 11 );
+	BOOST_CHECK( ! enumerator.next( id ) );
+
+	// access rights and pattern are applied while walking
+	LeafEnumerator writable( addressSpace, NamePattern( FRL_STR( "area[1-2].*" ) ), access_rights::WRITEABLE, 3 );
+	size_t count = 0;
+	while( writable.next( id ) )
+	{
+		BOOST_CHECK( addressSpace.getLeaf( id )->checkAccessRight( access_rights::WRITEABLE ) );
+		++count;
+	}
+	BOOST_CHECK( count == 20 );
+
+	// leafs added between chunks do not break enumeration
+	LeafEnumerator growing( addressSpace, NamePattern(), 0, 5 );
+	BOOST_CHECK( growing.skip( 5 ) == 5 );
+	addressSpace.addLeaf( FRL_STR( "area4.new" ) );
+	addressSpace.addLeaf( FRL_STR( "aaa" ) );
+	count = 5;
+	while( growing.next( id ) )
+		++count;
+	BOOST_CHECK( count == all.size() + 1 );
+}
+
+BOOST_AUTO_TEST_CASE( tag_change_listeners )
+{
+	using namespace frl::opc::address_space;
+	using opc_address_space_test::CountingListener;
+	AddressSpace addressSpace;
+	addressSpace.finalConstruct( FRL_STR( "." ) );
+	Tag *tag = addressSpace.addLeaf( FRL_STR( "leaf" ) );
+	Tag *other = addressSpace.addLeaf( FRL_STR( "other" ) );
+
+	CountingListener one, two;
+	tag->addListener( &one );
+	tag->addListener( &two );
+	BOOST_CHECK( one.getListenedTag() == tag && tag->hasListeners() );
+	tag->write( Value( 1.0 ) );
+	tag->write( Value( 1.0 ) ); // value is not changed
+	tag->writeFromOPC( Value( 2.0 ) );
+	tag->setQuality( quality::BAD );
+	BOOST_CHECK( one.changes == 3 && two.changes == 3 );
+
+	two.unsubscribe();
+	tag->write( Value( 3.0 ) );
+	BOOST_CHECK( one.changes == 4 && two.changes == 3 );
+
+	// listener is moved to other tag
+	one.changes = 0;
+	other->addListener( &one );
+	tag->write( Value( 4.0 ) );
+	other->write( Value( 4.0 ) );
+	BOOST_CHECK( one.changes == 1 && ! tag->hasListeners() );
+	{
+		CountingListener scoped;
+		other->addListener( &scoped );
+	}
+	other->write( Value( 5.0 ) );
+	BOOST_CHECK( one.changes == 2 );
+
+	// any number of functions subscribed to OPC writes
+	int calls = 0;
+	tag->subscribeToOpcChange( boost::function< void() >( boost::bind( &opc_address_space_test::countCall, &calls ) ) );
+	tag->subscribeToOpcChange( boost::function< void() >( boost::bind( &opc_address_space_test::countCall, &calls ) ) );
+	tag->writeFromOPC( Value( 6.0 ) );
+	tag->write( Value( 7.0 ) );
+	BOOST_CHECK( calls == 2 );
+
+	// value, quality and time stamp written together notify once
+	one.changes = 0;
+	TimeStamp ts = TimeStamp::fromDate( 25569.0 );
+	other->write( Value( 8.0 ), quality::BAD, ts );
+	BOOST_CHECK( one.changes == 1 );
+	Value value;
+	frl::UShort valueQuality;
+	TimeStamp valueTimeStamp;
+	other->read( value, valueQuality, valueTimeStamp );
+	BOOST_CHECK( double( value ) == 8.0 && valueQuality == quality::BAD && valueTimeStamp.getTicks() == ts.getTicks() );
+	other->write( Value( 8.0 ), quality::BAD, TimeStamp::now() ); // nothing is changed
+	BOOST_CHECK( one.changes == 1 );
+	tag->writeFromOPC( Value( 9.0 ), quality::BAD, ts );
+	BOOST_CHECK( calls == 4 );
+}
+
+BOOST_AUTO_TEST_CASE( change_queue_of_listeners )
+{
+	using namespace frl::opc::address_space;
+	AddressSpace addressSpace;
+	addressSpace.finalConstruct( FRL_STR( "." ) );
+	Tag *first = addressSpace.addLeaf( FRL_STR( "first" ) );
+	Tag *second = addressSpace.addLeaf( FRL_STR( "second" ) );
+
+	ChangeQueue queue;
+	QueuedTagListener items[3];
+	for( frl::UInt i = 0; i < 3; ++i )
+		items[i].setQueue( &queue, i + 1 );
+	first->addListener( &items[0] );
+	first->addListener( &items[1] );
+	second->addListener( &items[2] );
+
+	// burst of changes of one tag gives one entry per item
+	for( int i = 0; i < 10; ++i )
+		first->write( Value( i ) );
+	std::vector< frl::UInt > changed;
+	queue.take( changed );
+	BOOST_CHECK( changed.size() == 2 );
+	BOOST_CHECK( items[0].isDirty() && ! items[2].isDirty() );
+
+	// until consumer clears dirty flag item is not queued again
+	first->write( Value( 100 ) );
+	BOOST_CHECK( queue.size() == 0 );
+	items[0].clearDirty();
+	items[1].clearDirty();
+	first->write( Value( 101 ) );
+	second->write( Value( 101 ) );
+	queue.take( changed );
+	BOOST_CHECK( changed.size() == 3 );
+	std::sort( changed.begin(), changed.end() );
+	BOOST_CHECK( changed[0] == 1 && changed[1] == 2 && changed[2] == 3 );
+
+	items[2].clearDirty();
+	items[2].markChanged();
+	queue.take( changed );
+	BOOST_CHECK( changed.size() == 1 && changed[0] == 3 );
+}
+
+BOOST_AUTO_TEST_CASE( tag_listeners_concurrent_writes )
+{
+	using namespace frl::opc::address_space;
+	AddressSpace addressSpace;
+	addressSpace.finalConstruct( FRL_STR( "." ) );
+	Tag *tag = addressSpace.addLeaf( FRL_STR( "leaf" ) );
+	ChangeQueue queue;
+	QueuedTagListener listener;
+	listener.setQueue( &queue, 1 );
+	tag->addListener( &listener );
+
+	const int count = 100000;
+	opc_address_space_test::TagWriter writer = { tag, count };
+	boost::thread thread( writer );
+	// dirty flag is cleared before reading, so the last change
+	// is either read or queued again
+	std::vector< frl::UInt > changed;
+	int lastRead = 0;
+	for( int i = 0; i < 1000 || thread.joinable(); ++i )
+	{
+		queue.take( changed );
+		if( ! changed.empty() )
+		{
+			BOOST_CHECK( changed.size() == 1 );
+			listener.clearDirty();
+			lastRead = tag->read();
+		}
+		if( i >= 1000 )
+			thread.join();
+	}
+	queue.take( changed );
+	if( ! changed.empty() )
+	{
+		listener.clearDirty();
+		lastRead = tag->read();
+	}
+	BOOST_CHECK( lastRead == count );
+	listener.unsubscribe();
+	BOOST_CHECK( ! tag->hasListeners() );
+}
+
+BOOST_AUTO_TEST_CASE( tag_listeners_unsubscribe_while_tags_removed )
+{
+	using namespace frl::opc::address_space;
+	using opc_address_space_test::CountingListener;
+	AddressSpace addressSpace;
+	addressSpace.finalConstruct( FRL_STR( "." ) );
+	const int count = 2000;
+	boost::scoped_array< CountingListener > listeners( new CountingListener[count] );
+	for( int i = 0; i < count; ++i )
+		addressSpace.addLeaf( FRL_STR( "leaf" ) + frl::lexicalCast< int, frl::String >( i ) )->addListener( &listeners[i] );
+
+	opc_address_space_test::TagRemover remover = { &addressSpace, count };
+	boost::thread thread( remover );
+	for( int i = count - 1; i >= 0; --i )
+		listeners[i].unsubscribe();
+	thread.join();
+	for( int i = 0; i < count; ++i )
+		BOOST_CHECK( listeners[i].getListenedTag() == NULL );
+}
+
+BOOST_AUTO_TEST_CASE( snapshot_save_and_restore )
+{
+	using namespace frl::opc::address_space;
+	AddressSpace source;
+	source.finalConstruct( FRL_STR( "/" ) );
+	std::vector< LeafDefinition > leafs;
+	for( int i = 0; i < 50; ++i )
+	{
+		frl::stream_std::OutString ss;
+		ss << FRL_STR( "area" ) << i % 5 << FRL_STR( "/cell" ) << i % 3 << FRL_STR( "/tag" ) << i;
+		leafs.push_back( LeafDefinition( ss.str(), data_type::R8,
+			i % 2 ? access_rights::READABLE : access_rights::READABLE | access_rights::WRITEABLE, i * 10 ) );
+	}
+	leafs.push_back( LeafDefinition( FRL_STR( "area0/string" ), data_type::STRING ) );
+	leafs.push_back( LeafDefinition( FRL_STR( "root_bool" ), data_type::BOOL ) );
+	leafs.push_back( LeafDefinition( FRL_STR( "root_cy" ), data_type::CY ) );
+	leafs.push_back( LeafDefinition( FRL_STR( "root_empty" ) ) );
+	std::vector< Tag* > added;
+	source.addLeafs( leafs, added );
+	source.addBranch( FRL_STR( "empty_branch" ) );
+	for( int i = 0; i < 50; ++i )
+	{
+		added[i]->write( Value( i * 1.5 ) );
+		added[i]->setTimeStamp( TimeStamp( 1000000 + i ) );
+	}
+	added[50]->write( Value( FRL_STR( "last known" ) ) );
+	added[50]->setQuality( quality::UNCERTAIN );
+	added[51]->write( Value( true ) );
+	Value cy;
+	cy.setCurrency( 123456789 );
+	added[52]->write( cy );
+	added[52]->setQuality( quality::BAD );
+	added[7]->setEURange( -10.0, 250.5 );
+
+	std::vector< char > image;
+	source.saveSnapshot( image );
+
+	AddressSpace restored;
+	restored.loadSnapshot( &image[0], image.size() );
+	BOOST_CHECK( restored.getDelimiter() == FRL_STR( "/" ) );
+	BOOST_CHECK( restored.isExistBranch( FRL_STR( "empty_branch" ) ) );
+	BOOST_CHECK( restored.isExistBranch( FRL_STR( "area3/cell1" ) ) );
+	std::vector< frl::String > sourceLeafs, restoredLeafs;
+	source.getAllLeafs( sourceLeafs, 0 );
+	restored.getAllLeafs( restoredLeafs, 0 );
+	BOOST_CHECK( sourceLeafs == restoredLeafs );
+	for( size_t i = 0; i < added.size(); ++i )
+	{
+		Tag *tag = restored.getLeaf( added[i]->getID() );
+		Value val, restoredVal;
+		frl::UShort q, restoredQ;
+		TimeStamp ts, restoredTs;
+		added[i]->read( val, q, ts );
+		tag->read( restoredVal, restoredQ, restoredTs );
+		BOOST_CHECK( val == restoredVal );
+		BOOST_CHECK( q == restoredQ );
+		BOOST_CHECK( ts.getTicks() == restoredTs.getTicks() );
+		BOOST_CHECK( tag->getAccessRights() == added[i]->getAccessRights() );
+		BOOST_CHECK( tag->getScanRate() == added[i]->getScanRate() );
+		BOOST_CHECK( tag->getCanonicalDataType() == added[i]->getCanonicalDataType() );
+		BOOST_CHECK( tag->isAnalog() == ( i == 7 ) );
+	}
+	Tag *analog = restored.getLeaf( added[7]->getID() );
+	BOOST_CHECK( analog->getLowEU() == -10.0 && analog->getHighEU() == 250.5 );
+	Value eu;
+	BOOST_CHECK( analog->getPropertyValue( property::HIGH_EU, eu ) && double( eu ) == 250.5 );
+	BOOST_CHECK( frl::String( restored.getLeaf( FRL_STR( "area0/string" ) )->read() ) == FRL_STR( "last known" ) );
+	BOOST_CHECK( restored.getLeaf( FRL_STR( "root_cy" ) )->read().getCurrency() == 123456789 );
+	// restored tags are ordinary tags
+	restored.addLeaf( FRL_STR( "area1/cell0/new" ) );
+	BOOST_CHECK( restored.getBranch( FRL_STR( "area1/cell0" ) )->isExistTag( FRL_STR( "area1/cell0/new" ) ) );
+
+	// image file is mapped into memory
+	const frl::String fileName = FRL_STR( "test_opc_address_space.snapshot" );
+	source.saveSnapshot( fileName );
+	AddressSpace fromFile;
+	fromFile.loadSnapshot( fileName );
+	std::vector< frl::String > fileLeafs;
+	fromFile.getAllLeafs( fileLeafs, 0 );
+	BOOST_CHECK( fileLeafs == sourceLeafs );
+	std::remove( "test_opc_address_space.snapshot" );
+	AddressSpace noFile;
+	BOOST_CHECK_THROW( noFile.loadSnapshot( fileName ), AddressSpace::SnapshotFileError );
+}
+
+BOOST_AUTO_TEST_CASE( snapshot_invalid_images )
+{
+	using namespace frl::opc::address_space;
+	AddressSpace source;
+	source.finalConstruct( FRL_STR( "." ) );
+	source.addBranch( FRL_STR( "branch" ) );
+	source.addLeaf( FRL_STR( "branch.leaf1" ) );
+	source.addLeaf( FRL_STR( "branch.leaf2" ) );
+	std::vector< char > image;
+	source.saveSnapshot( image );
+
+	// not empty
+	BOOST_CHECK_THROW( source.loadSnapshot( &image[0], image.size() ), AddressSpace::IsNotEmpty );
+
+	// truncated
+	AddressSpace target;
+	BOOST_CHECK_THROW( target.loadSnapshot( &image[0], image.size() - 1 ), AddressSpace::InvalidSnapshot );
+	BOOST_CHECK_THROW( target.loadSnapshot( &image[0], 10 ), AddressSpace::InvalidSnapshot );
+
+	// other delimiter
+	AddressSpace slash;
+	slash.finalConstruct( FRL_STR( "/" ) );
+	BOOST_CHECK_THROW( slash.loadSnapshot( &image[0], image.size() ), AddressSpace::InvalidSnapshot );
+
+	snapshot::Record *records = reinterpret_cast< snapshot::Record* >( &image[ sizeof( snapshot::Header ) ] );
+	// parent after child
+	std::vector< char > broken( image );
+	reinterpret_cast< snapshot::Record* >( &broken[ sizeof( snapshot::Header ) ] )[1].parent = 2;
+	BOOST_CHECK_THROW( target.loadSnapshot( &broken[0], broken.size() ), AddressSpace::InvalidSnapshot );
+	// duplicate
+	broken = image;
+	reinterpret_cast< snapshot::Record* >( &broken[ sizeof( snapshot::Header ) ] )[2] = records[1];
+	BOOST_CHECK_THROW( target.loadSnapshot( &broken[0], broken.size() ), AddressSpace::InvalidSnapshot );
+	// string out of pool
+	broken = image;
+	reinterpret_cast< snapshot::Record* >( &broken[ sizeof( snapshot::Header ) ] )[2].idLength = 1000;
+	BOOST_CHECK_THROW( target.loadSnapshot( &broken[0], broken.size() ), AddressSpace::InvalidSnapshot );
+	// unknown type of value, array, string of not string value
+	broken = image;
+	reinterpret_cast< snapshot::Record* >( &broken[ sizeof( snapshot::Header ) ] )[2].valueType = 0x7FFF;
+	BOOST_CHECK_THROW( target.loadSnapshot( &broken[0], broken.size() ), AddressSpace::InvalidSnapshot );
+	broken = image;
+	reinterpret_cast< snapshot::Record* >( &broken[ sizeof( snapshot::Header ) ] )[2].valueType = data_type::ARRAY;
+	BOOST_CHECK_THROW( target.loadSnapshot( &broken[0], broken.size() ), AddressSpace::InvalidSnapshot );
+	broken = image;
+	reinterpret_cast< snapshot::Record* >( &broken[ sizeof( snapshot::Header ) ] )[2].strLength = 1;
+	BOOST_CHECK_THROW( target.loadSnapshot( &broken[0], broken.size() ), AddressSpace::InvalidSnapshot );
+	BOOST_CHECK( ! target.isInit() );
+
+	target.loadSnapshot( &image[0], image.size() );
+	BOOST_CHECK( target.isExistLeaf( FRL_STR( "branch.leaf2" ) ) );
+}
+
+BOOST_AUTO_TEST_CASE( namespace_versions )
+{
+	using namespace frl::opc::address_space;
+	AddressSpace space;
+	space.finalConstruct( FRL_STR( "." ) );
+	NamespaceVersionPtr initial = space.getVersion();
+	space.addBranch( FRL_STR( "branch" ) );
+	space.addLeaf( FRL_STR( "branch.leaf1" ) );
+	NamespaceVersionPtr held = space.getVersion();
+	BOOST_CHECK( held->getNumber() == initial->getNumber() + 2 );
+	// failed reconfiguration publishes nothing
+	BOOST_CHECK_THROW( space.addLeaf( FRL_STR( "branch.leaf1" ) ), Tag::IsExistTag );
+	BOOST_CHECK( space.getVersion() == held );
+
+	std::vector< LeafDefinition > batch;
+	batch.push_back( LeafDefinition( FRL_STR( "branch.leaf0" ) ) );
+	batch.push_back( LeafDefinition( FRL_STR( "other.leaf" ) ) );
+	space.addLeafs( batch );
+	BOOST_CHECK( space.getVersion()->getNumber() == held->getNumber() + 1 );
+	BOOST_CHECK( space.isExistLeaf( FRL_STR( "other.leaf" ) ) );
+
+	// reader of held version does not see tags of the batch
+	std::vector< frl::String > leafs;
+	space.getRootBranch()->browseAllLeafs( leafs, 0, held->getNumber() );
+	BOOST_REQUIRE( leafs.size() == 1 );
+	BOOST_CHECK( leafs[0] == FRL_STR( "branch.leaf1" ) );
+	space.getAllLeafs( leafs, 0 );
+	BOOST_CHECK( leafs.size() == 3 );
+	std::vector< TagBrowseInfo > children;
+	space.getBranch( FRL_STR( "branch" ) )->browse( children );
+	BOOST_REQUIRE( children.size() == 2 );
+	BOOST_CHECK( children[0].fullID == FRL_STR( "branch.leaf0" ) );
+}
+
+BOOST_AUTO_TEST_CASE( namespace_reconfiguration_concurrent_reads )
+{
+	using namespace frl::opc::address_space;
+	AddressSpace space;
+	space.finalConstruct( FRL_STR( "." ) );
+	const size_t batchSize = 50;
+	bool torn = false;
+	opc_address_space_test::NamespaceReader reader = { &space, batchSize, &torn };
+	boost::thread first( reader );
+	boost::thread second( reader );
+	// every batch goes to several new and old branches
+	for( size_t b = 0; b < 200; ++b )
+	{
+		std::vector< LeafDefinition > batch;
+		for( size_t i = 0; i < batchSize; ++i )
+		{
+			frl::stream_std::OutString ss;
+			ss << FRL_STR( "device" ) << ( b + i ) % 7 << FRL_STR( ".unit" ) << b % 3 << FRL_STR( ".tag" ) << b << FRL_STR( "_" ) << i;
+			batch.push_back( LeafDefinition( ss.str() ) );
+		}
+		space.addLeafs( batch );
+	}
+	first.join();
+	second.join();
+	BOOST_CHECK( ! torn );
+	std::vector< frl::String > leafs;
+	space.getAllLeafs( leafs, 0 );
+	BOOST_CHECK( leafs.size() == 200 * batchSize );
+}
+
+BOOST_AUTO_TEST_CASE( remove_tags_and_handles )
+{
+	using namespace frl::opc::address_space;
+	AddressSpace space;
+	space.finalConstruct( FRL_STR( "." ) );
+	space.addBranch( FRL_STR( "a" ) );
+	space.addBranch( FRL_STR( "a.b" ) );
+	Tag *leaf = space.addLeaf( FRL_STR( "a.x" ) );
+	space.addLeaf( FRL_STR( "a.b.y" ) );
+	space.addLeaf( FRL_STR( "z" ) );
+	TagHandle leafHandle = space.getHandle( leaf );
+	TagHandle branchHandle = space.getHandle( space.getBranch( FRL_STR( "a.b" ) ) );
+	BOOST_CHECK( space.findTag( leafHandle ) == leaf );
+	BOOST_CHECK( space.getHandle( space.getRootBranch() ).isNull() );
+	opc_address_space_test::CountingListener listener;
+	leaf->addListener( &listener );
+
+	NamespaceVersionPtr held = space.getVersion();
+	space.removeTag( FRL_STR( "a" ) );
+	BOOST_CHECK( space.findTag( leafHandle ) == NULL );
+	BOOST_CHECK( space.findTag( branchHandle ) == NULL );
+	BOOST_CHECK( ! space.isExistLeaf( FRL_STR( "a.b.y" ) ) );
+	BOOST_CHECK( ! space.isExistBranch( FRL_STR( "a" ) ) );
+	BOOST_CHECK( space.getHandle( leaf ).isNull() );
+	BOOST_CHECK( listener.changes == 1 );
+	BOOST_CHECK( listener.getListenedTag() == NULL );
+	// removed tag stays readable for holder of older version
+	BOOST_CHECK( leaf->getID() == FRL_STR( "a.x" ) );
+	held.reset();
+
+	std::vector< frl::String > leafs;
+	space.getAllLeafs( leafs, 0 );
+	BOOST_REQUIRE( leafs.size() == 1 );
+	BOOST_CHECK( leafs[0] == FRL_STR( "z" ) );
+	BOOST_CHECK_THROW( space.removeTag( FRL_STR( "a" ) ), Tag::NotExistTag );
+	BOOST_CHECK_THROW( space.removeTag( frl::String() ), Tag::NotExistTag );
+
+	// same ID gets new handle, old one stays stale
+	space.addBranch( FRL_STR( "a" ) );
+	Tag *again = space.addLeaf( FRL_STR( "a.x" ) );
+	BOOST_CHECK( space.getHandle( again ) != leafHandle );
+	BOOST_CHECK( space.findTag( leafHandle ) == NULL );
+	BOOST_CHECK( space.findTag( space.getHandle( again ) ) == again );
+
+	// memory of removed tags is reused
+	MemoryUsage before = space.getMemoryUsage();
+	for( int i = 0; i < 1000; ++i )
+	{
+		space.addLeaf( FRL_STR( "a.churn" ) );
+		space.removeTag( FRL_STR( "a.churn" ) );
+	}
+	MemoryUsage after = space.getMemoryUsage();
+	BOOST_CHECK( after.tagsSize == before.tagsSize );
+	BOOST_CHECK( after.indexesSize <= before.indexesSize );
+	BOOST_CHECK( after.leafsNumber == before.leafsNumber );
+}
+
+BOOST_AUTO_TEST_CASE( tag_handles_concurrent_removal )
+{
+	using namespace frl::opc::address_space;
+	AddressSpace space;
+	space.finalConstruct( FRL_STR( "." ) );
+	space.addBranch( FRL_STR( "device" ) );
+	TagHandle first = space.getHandle( space.addLeaf( FRL_STR( "device.leaf" ) ) );
+	space.removeTag( FRL_STR( "device.leaf" ) );
+	bool torn = false;
+	opc_address_space_test::HandleReader reader = { &space, first, &torn };
+	boost::thread firstReader( reader );
+	boost::thread secondReader( reader );
+	for( int i = 0; i < 2000; ++i )
+	{
+		space.addLeaf( FRL_STR( "device.leaf" ) );
+		space.removeTag( FRL_STR( "device" ) );
+		space.addBranch( FRL_STR( "device" ) );
+	}
+	firstReader.join();
+	secondReader.join();
+	BOOST_CHECK( ! torn );
+}
+
+BOOST_AUTO_TEST_CASE( sampling_scheduler_by_scan_rates )
+{
+	using namespace frl::opc::address_space;
+	AddressSpace space;
+	space.finalConstruct( FRL_STR( "." ) );
+	std::vector< LeafDefinition > leafs;
+	leafs.push_back( LeafDefinition( FRL_STR( "dev.fast1" ), data_type::I4, access_rights::READABLE, 100 ) );
+	leafs.push_back( LeafDefinition( FRL_STR( "dev.fast2" ), data_type::I4, access_rights::READABLE, 100 ) );
+	leafs.push_back( LeafDefinition( FRL_STR( "dev.slow" ), data_type::I4 ) ); // default rate
+	leafs.push_back( LeafDefinition( FRL_STR( "other.tag" ), data_type::I4, access_rights::READABLE, 100 ) );
+	std::vector< Tag* > tags;
+	space.addLeafs( leafs, tags );
+	opc_address_space_test::RecordingDriver device, other;
+	SamplingScheduler scheduler( space, 10, 1000 );
+	for( size_t i = 0; i < 3; ++i )
+		scheduler.add( tags[i], &device );
+	scheduler.add( tags[3], &other );
+	BOOST_CHECK( scheduler.getBatchesNumber() == 3 );
+
+	// new batches are sampled at once, every driver gets one call per tick
+	scheduler.process( 10 );
+	BOOST_REQUIRE( device.calls.size() == 1 );
+	BOOST_CHECK( device.calls[0] == 3 );
+	BOOST_CHECK( other.calls.size() == 1 );
+	BOOST_CHECK( tags[2]->read() == Value( 1 ) );
+	scheduler.process( 50 );
+	BOOST_CHECK( device.calls.size() == 1 );
+	scheduler.process( 110 );
+	BOOST_REQUIRE( device.calls.size() == 2 );
+	BOOST_CHECK( device.calls[1] == 2 );
+	// both rates are due, missed samples of fast batch are not repeated
+	scheduler.process( 1010 );
+	BOOST_REQUIRE( device.calls.size() == 3 );
+	BOOST_CHECK( device.calls[2] == 3 );
+
+	// removed tag is dropped, changed rate moves tag to other batch
+	space.removeTag( FRL_STR( "dev.fast2" ) );
+	tags[2]->setScanRate( 100 );
+	scheduler.process( 1110 );
+	BOOST_REQUIRE( device.calls.size() == 4 );
+	BOOST_CHECK( device.calls[3] == 1 );
+	scheduler.process( 2010 ); // slow batch is empty now
+	BOOST_CHECK( device.calls.size() == 5 );
+	BOOST_CHECK( scheduler.getBatchesNumber() == 2 );
+	scheduler.process( 2110 );
+	BOOST_REQUIRE( device.calls.size() == 6 );
+	BOOST_CHECK( device.calls[5] == 2 );
+
+	scheduler.remove( &other );
+	size_t otherCalls = other.calls.size();
+	scheduler.process( 3010 );
+	BOOST_CHECK( other.calls.size() == otherCalls );
+	BOOST_CHECK( scheduler.getBatchesNumber() == 1 );
+}
+
+BOOST_AUTO_TEST_CASE( demand_driven_sampling )
+{
+	using namespace frl::opc::address_space;
+	AddressSpace space;
+	space.finalConstruct( FRL_STR( "." ) );
+	std::vector< LeafDefinition > leafs;
+	leafs.push_back( LeafDefinition( FRL_STR( "dev.watched" ), data_type::I4, access_rights::READABLE, 100 ) );
+	leafs.push_back( LeafDefinition( FRL_STR( "dev.idle" ), data_type::I4, access_rights::READABLE, 100 ) );
+	std::vector< Tag* > tags;
+	space.addLeafs( leafs, tags );
+	opc_address_space_test::RecordingDriver device;
+	SamplingScheduler scheduler( space, 10, 1000 );
+	scheduler.setDemandDriven( frl::True, 300 );
+	scheduler.add( tags[0], &device );
+	scheduler.add( tags[1], &device );
+
+	// first sample reads everything, then nobody watches
+	scheduler.process( 10 );
+	BOOST_REQUIRE( device.calls.size() == 1 );
+	BOOST_CHECK( device.calls[0] == 2 );
+	scheduler.process( 110 );
+	BOOST_CHECK( device.calls.size() == 1 );
+
+	tags[0]->addDemand();
+	tags[0]->addDemand();
+	BOOST_CHECK( tags[0]->isDemanded() );
+	scheduler.process( 210 );
+	BOOST_REQUIRE( device.calls.size() == 2 );
+	BOOST_CHECK( device.calls[1] == 1 );
+	// idle tags are sampled with idle rate
+	scheduler.process( 310 );
+	BOOST_REQUIRE( device.calls.size() == 3 );
+	BOOST_CHECK( device.calls[2] == 2 );
+
+	tags[0]->releaseDemand();
+	BOOST_CHECK( tags[0]->isDemanded() );
+	tags[0]->releaseDemand();
+	BOOST_CHECK( ! tags[0]->isDemanded() );
+	scheduler.setDemandDriven( frl::True );
+	scheduler.process( 610 );
+	BOOST_CHECK( device.calls.size() == 3 );
+	scheduler.setDemandDriven( frl::False );
+	scheduler.process( 710 );
+	BOOST_CHECK( device.calls.size() == 4 );
+}
+
+BOOST_AUTO_TEST_CASE( path_view_and_tokenizer )
+{
+	using namespace frl::opc::address_space;
+	frl::String id = FRL_STR( "plant.line_1.motor.speed" );
+	PathTokenizer tokenizer( id, FRL_STR( '.' ) );
+	PathView segment;
+	std::vector< frl::String > segments;
+	while( tokenizer.next( segment ) )
+	{
+		// segments refer to ID itself
+		BOOST_CHECK( segment.data() >= id.data() && segment.data() < id.data() + id.size() );
+		segments.push_back( segment.toString() );
+		if( segments.size() == 2 )
+			BOOST_CHECK( tokenizer.getWalked() == PathView( FRL_STR( "plant.line_1" ) ) );
+	}
+	BOOST_REQUIRE( segments.size() == 4 );
+	BOOST_CHECK( segments[1] == FRL_STR( "line_1" ) );
+	BOOST_CHECK( segments[3] == FRL_STR( "speed" ) );
+	BOOST_CHECK( tokenizer.isLast() );
+
+	PathView path( id );
+	BOOST_CHECK( path.getParent( FRL_STR( '.' ) ) == PathView( FRL_STR( "plant.line_1.motor" ) ) );
+	BOOST_CHECK( path.getShortName( FRL_STR( '.' ) ) == PathView( FRL_STR( "speed" ) ) );
+	BOOST_CHECK( PathView( FRL_STR( "plant" ) ).getParent( FRL_STR( '.' ) ).empty() );
+	BOOST_CHECK( path.isValid( FRL_STR( '.' ) ) );
+	BOOST_CHECK( ! PathView( FRL_STR( "a..b" ) ).isValid( FRL_STR( '.' ) ) );
+	BOOST_CHECK( ! PathView( FRL_STR( ".a" ) ).isValid( FRL_STR( '.' ) ) );
+	BOOST_CHECK( ! PathView( FRL_STR( "a." ) ).isValid( FRL_STR( '.' ) ) );
+	BOOST_CHECK( ! PathView().isValid( FRL_STR( '.' ) ) );
+
+	AddressSpace space;
+	space.finalConstruct( FRL_STR( "." ) );
+	space.addBranch( FRL_STR( "plant" ) );
+	space.addBranch( FRL_STR( "plant.line_1" ) );
+	space.addBranch( FRL_STR( "plant.line_10" ) );
+	space.addBranch( FRL_STR( "plant.line_1.motor" ) );
+	Tag *speed = space.addLeaf( id );
+	// lookups by part of other string, walk by segments
+	BOOST_CHECK( space.findBranch( path.prefix( 12 ) ) == space.findBranch( FRL_STR( "plant.line_1" ) ) );
+	BOOST_CHECK( space.getRootBranch()->findDescendant( id ) == speed );
+	Tag *plant = space.getBranch( FRL_STR( "plant" ) );
+	BOOST_CHECK( plant->findChildByName( FRL_STR( "line_10" ) ) == space.findBranch( FRL_STR( "plant.line_10" ) ) );
+	BOOST_CHECK( plant->findDescendant( FRL_STR( "line_1.motor.speed" ) ) == speed );
+	BOOST_CHECK( plant->findDescendant( FRL_STR( "line_1.pump" ) ) == NULL );
+	BOOST_CHECK( plant->findDescendant( FRL_STR( "line_1..motor" ) ) == NULL );
+	BOOST_CHECK_THROW( space.addLeaf( FRL_STR( "plant..x" ) ), AddressSpace::InvalidLeafName );
+	BOOST_CHECK_THROW( space.addBranch( FRL_STR( "plant." ) ), AddressSpace::InvalidBranchName );
+}
+
+BOOST_AUTO_TEST_CASE( secondary_attribute_indexes )
+{
+	using namespace frl::opc::address_space;
+	AddressSpace space;
+	space.finalConstruct( FRL_STR( "." ) );
+	const frl::UInt rw = access_rights::READABLE | access_rights::WRITEABLE;
+	std::vector< LeafDefinition > leafs;
+	leafs.push_back( LeafDefinition( FRL_STR( "a.z" ), data_type::R8, rw ) );
+	leafs.push_back( LeafDefinition( FRL_STR( "a-b" ), data_type::R8, rw ) );
+	leafs.push_back( LeafDefinition( FRL_STR( "b.x" ), data_type::I4 ) );
+	leafs.push_back( LeafDefinition( FRL_STR( "b.y" ), data_type::R8 ) );
+	for( int i = 0; i < 20; ++i )
+	{
+		frl::stream_std::OutString ss;
+		ss << FRL_STR( "c.t" ) << i;
+		leafs.push_back( LeafDefinition( ss.str(), data_type::I4 ) );
+	}
+	std::vector< Tag* > tags;
+	space.addLeafs( leafs, tags );
+
+	// few writable leafs are taken from index, order is same as of walk over tree
+	std::vector< frl::String > found, walked;
+	space.getAllLeafs( found, access_rights::WRITEABLE );
+	space.getRootBranch()->browseAllLeafs( walked, access_rights::WRITEABLE );
+	BOOST_REQUIRE( found.size() == 2 );
+	BOOST_CHECK( found == walked );
+	BOOST_CHECK( found[0] == FRL_STR( "a.z" ) );
+
+	space.findLeafs( found, access_rights::WRITEABLE, data_type::R8 );
+	BOOST_CHECK( found.size() == 2 );
+	space.findLeafs( found, 0, data_type::R8 );
+	BOOST_CHECK( found.size() == 3 );
+	space.findLeafs( found, 0, data_type::EMPTY );
+	BOOST_CHECK( found.size() == leafs.size() );
+
+	// indexes follow changes of rights and types
+	tags[0]->isWritable( frl::False );
+	tags[4]->write( Value( 1.5 ) );
+	tags[5]->setCanonicalDataType( data_type::R8 );
+	space.removeTag( FRL_STR( "a-b" ) );
+	space.findLeafs( found, access_rights::WRITEABLE, data_type::EMPTY );
+	BOOST_CHECK( found.empty() );
+	space.findLeafs( found, 0, data_type::R8 );
+	std::sort( found.begin(), found.end() );
+	BOOST_REQUIRE( found.size() == 4 );
+	BOOST_CHECK( found[0] == FRL_STR( "a.z" ) );
+	BOOST_CHECK( found[2] == FRL_STR( "c.t0" ) );
+	BOOST_CHECK( found[3] == FRL_STR( "c.t1" ) );
+
+	std::vector< frl::String > shortIDs;
+	space.getBranch( FRL_STR( "b" ) )->browseLeafs( shortIDs, 0, data_type::R8 );
+	BOOST_REQUIRE( shortIDs.size() == 1 );
+	BOOST_CHECK( shortIDs[0] == FRL_STR( "y" ) );
+
+	// loaded leafs are indexed too
+	std::vector< char > image;
+	space.saveSnapshot( image );
+	AddressSpace loaded;
+	loaded.loadSnapshot( &image[0], image.size() );
+	std::vector< frl::String > loadedFound;
+	loaded.findLeafs( loadedFound, 0, data_type::R8 );
+	std::sort( loadedFound.begin(), loadedFound.end() );
+	BOOST_CHECK( loadedFound == found );
+}
+
+BOOST_AUTO_TEST_CASE( parallel_build_and_merge )
+{
+	using namespace frl::opc::address_space;
+	AddressSpace space;
+	space.finalConstruct( FRL_STR( "." ) );
+	space.addBranch( FRL_STR( "plant" ) );
+	space.addLeaf( FRL_STR( "plant.total" ) );
+
+	const int partsNumber = 3;
+	AddressSpace parts[ partsNumber ];
+	std::vector< AddressSpace* > merged;
+	boost::thread_group builders;
+	for( int i = 0; i < partsNumber; ++i )
+	{
+		parts[i].finalConstruct( FRL_STR( "." ) );
+		opc_address_space_test::PartBuilder builder = { &parts[i], i };
+		builders.create_thread( builder );
+		merged.push_back( &parts[i] );
+	}
+	builders.join_all();
+	Tag *built = parts[1].getLeaf( FRL_STR( "plant.dev1.ch2.v5" ) );
+	space.merge( merged );
+
+	// tags are moved, shared branch "plant" is merged with existing one
+	BOOST_CHECK( space.getLeaf( FRL_STR( "plant.dev1.ch2.v5" ) ) == built );
+	BOOST_CHECK( built->getParent() == space.getBranch( FRL_STR( "plant.dev1.ch2" ) ) );
+	BOOST_CHECK( space.getBranch( FRL_STR( "plant.dev1" ) )->getParent() == space.getBranch( FRL_STR( "plant" ) ) );
+	BOOST_CHECK( space.findTag( space.getHandle( built ) ) == built );
+	std::vector< frl::String > leafs;
+	space.getAllLeafs( leafs, 0 );
+	BOOST_CHECK( leafs.size() == partsNumber * 300 + 1 );
+	space.findLeafs( leafs, access_rights::WRITEABLE, data_type::R8 );
+	BOOST_CHECK( leafs.size() == partsNumber );
+	for( int i = 0; i < partsNumber; ++i )
+	{
+		BOOST_CHECK( ! parts[i].isExistBranch( FRL_STR( "plant" ) ) );
+		parts[i].getAllLeafs( leafs, 0 );
+		BOOST_CHECK( leafs.empty() );
+	}
+
+	// collision is found before anything is moved
+	AddressSpace clash;
+	clash.finalConstruct( FRL_STR( "." ) );
+	clash.addBranch( FRL_STR( "plant" ) );
+	clash.addBranch( FRL_STR( "plant.dev9" ) );
+	clash.addLeaf( FRL_STR( "plant.dev9.v" ) );
+	clash.addBranch( FRL_STR( "plant.dev0" ) );
+	clash.addBranch( FRL_STR( "plant.dev0.ch0" ) );
+	clash.addLeaf( FRL_STR( "plant.dev0.ch0.v0" ) );
+	BOOST_CHECK_THROW( space.merge( clash ), Tag::IsExistTag );
+	BOOST_CHECK( ! space.isExistBranch( FRL_STR( "plant.dev9" ) ) );
+	BOOST_CHECK( clash.isExistLeaf( FRL_STR( "plant.dev9.v" ) ) );
+
+	AddressSpace slashed;
+	slashed.finalConstruct( FRL_STR( "/" ) );
+	BOOST_CHECK_THROW( space.merge( slashed ), AddressSpace::DifferentDelimiter );
+}
+
+BOOST_AUTO_TEST_CASE( independent_address_spaces )
+{
+	using namespace frl::opc::address_space;
+	AddressSpace first, second;
+	first.finalConstruct( FRL_STR( "." ) );
+	second.finalConstruct( FRL_STR( "." ) );
+	opc_address_space_test::PartBuilder firstBuilder = { &first, 1 };
+	opc_address_space_test::PartBuilder secondBuilder = { &second, 2 };
+	boost::thread_group builders;
+	builders.create_thread( firstBuilder );
+	builders.create_thread( secondBuilder );
+	builders.join_all();
+
+	AddrSpaceCrawler firstCrawler( first );
+	AddrSpaceCrawler secondCrawler( second );
+	BOOST_REQUIRE( firstCrawler.goTo( FRL_STR( "plant.dev1" ) ) );
+	BOOST_CHECK( ! firstCrawler.goTo( FRL_STR( "plant.dev2" ) ) );
+	BOOST_REQUIRE( secondCrawler.goTo( FRL_STR( "plant.dev2.ch0" ) ) );
+	std::vector< frl::String > branches, leafs;
+	firstCrawler.browseBranches( branches );
+	BOOST_CHECK( branches.size() == 3 );
+	secondCrawler.browseLeafs( leafs );
+	BOOST_CHECK( leafs.size() == 100 );
+	BOOST_CHECK( secondCrawler.goUp() );
+	BOOST_CHECK( secondCrawler.getCurPosPath() == FRL_STR( "plant.dev2" ) );
+	secondCrawler.goToRoot();
+	BOOST_CHECK( ! secondCrawler.goDown( FRL_STR( "plant.dev1" ) ) );
+	BOOST_CHECK( first.findLeaf( FRL_STR( "plant.dev2.ch0.v0" ) ) == NULL );
+}
+
+BOOST_AUTO_TEST_CASE( crawler_browse_refers_to_tag_ids )
+{
+	using namespace frl::opc::address_space;
+	AddressSpace space;
+	space.finalConstruct( FRL_STR( "." ) );
+	opc_address_space_test::PartBuilder builder = { &space, 7 };
+	builder();
+	AddrSpaceCrawler crawler( space );
+	BOOST_REQUIRE( crawler.goDown( FRL_STR( "plant.dev7" ) ) );
+	BOOST_REQUIRE( crawler.goDown( FRL_STR( "ch1" ) ) );
+	NamespaceVersionPtr version = space.getVersion();
+	std::vector< TagBrowseInfo > info;
+	crawler.browse( info );
+	BOOST_REQUIRE( info.size() == 100 );
+	Tag *tag = space.getLeaf( FRL_STR( "plant.dev7.ch1.v1" ) );
+	BOOST_CHECK( info[0].tagPtr == tag );
+	BOOST_CHECK( info[0].fullID.data() == tag->getID().data() );
+	BOOST_CHECK( info[0].shortID == FRL_STR( "v1" ) );
+	BOOST_CHECK( info[0].shortID.data() == tag->getID().data() + 15 );
+
+	// pattern is matched against short IDs in place
+	std::vector< TagBrowseInfo > page;
+	frl::String next;
+	BOOST_REQUIRE( crawler.browsePage( page, browse_filter::LEAFS, frl::String(), 5, NamePattern( FRL_STR( "v2*" ) ), next ) );
+	BOOST_REQUIRE( page.size() == 5 );
+	BOOST_CHECK( page[0].shortID == FRL_STR( "v202" ) );
+	BOOST_CHECK( page[4].fullID == FRL_STR( "plant.dev7.ch1.v214" ) );
+	BOOST_CHECK( next == FRL_STR( "plant.dev7.ch1.v217" ) );
+}
+
+BOOST_AUTO_TEST_CASE( update_scheduler_timer_wheel )
+{
+	using namespace frl::opc;
+	frl::UInt fastRuns = 0, slowRuns = 0;
+	opc_address_space_test::PeriodicTask fast = { &fastRuns, 100 };
+	opc_address_space_test::PeriodicTask slow = { &slowRuns, 3000 }; // longer than turn of inner wheel
+	Executor executor( 2 );
+	UpdateScheduler scheduler( executor, 10 );
+	BOOST_CHECK( scheduler.add( 1, fast, 100 ) );
+	BOOST_CHECK( scheduler.add( 2, slow, 3000 ) );
+	BOOST_CHECK( ! scheduler.add( 1, slow, 3000 ) );
+	BOOST_CHECK( scheduler.size() == 2 );
+
+	scheduler.process( 50 );
+	scheduler.wait();
+	BOOST_CHECK( fastRuns == 0 );
+	scheduler.process( 100 );
+	scheduler.wait();
+	BOOST_CHECK( fastRuns == 1 );
+	scheduler.process( 190 );
+	scheduler.wait();
+	BOOST_CHECK( fastRuns == 1 );
+	scheduler.process( 200 );
+	scheduler.wait();
+	BOOST_CHECK( fastRuns == 2 );
+
+	// missed runs are not repeated, slow task comes from outer wheel in time
+	scheduler.process( 1000 );
+	scheduler.wait();
+	scheduler.process( 2000 );
+	scheduler.wait();
+	scheduler.process( 2990 );
+	scheduler.wait();
+	BOOST_CHECK( fastRuns == 5 );
+	BOOST_CHECK( slowRuns == 0 );
+	scheduler.process( 3000 );
+	scheduler.wait();
+	BOOST_CHECK( fastRuns == 6 );
+	BOOST_CHECK( slowRuns == 1 );
+
+	// long pause
+	scheduler.process( 10000 );
+	scheduler.wait();
+	BOOST_CHECK( fastRuns == 7 );
+	BOOST_CHECK( slowRuns == 2 );
+
+	scheduler.reschedule( 2, 100 );
+	scheduler.process( 10100 );
+	scheduler.wait();
+	BOOST_CHECK( fastRuns == 8 );
+	BOOST_CHECK( slowRuns == 3 );
+
+	scheduler.remove( 1 );
+	BOOST_CHECK( scheduler.size() == 1 );
+	scheduler.process( 20000 );
+	scheduler.wait();
+	BOOST_CHECK( fastRuns == 8 );
+	BOOST_CHECK( slowRuns == 4 );
+	BOOST_CHECK( scheduler.add( 1, fast, 100 ) );
+}
+
+BOOST_AUTO_TEST_CASE( update_scheduler_survives_throwing_tasks )
+{
+	using namespace frl::opc;
+	Executor executor( 2 );
+	UpdateScheduler scheduler( executor, 10 );
+	frl::UInt runs = 0;
+	opc_address_space_test::FailingTask task = { &runs };
+	scheduler.add( 1, task, 100 );
+	// failed task is not left running, it runs again at its period
+	scheduler.process( 100 );
+	scheduler.wait();
+	BOOST_CHECK( runs == 1 );
+	scheduler.process( 200 );
+	scheduler.wait();
+	BOOST_CHECK( runs == 2 );
+	scheduler.remove( 1 );
+	BOOST_CHECK( scheduler.size() == 0 );
+}
+
+BOOST_AUTO_TEST_CASE( update_scheduler_wakes_up_idle_tasks )
+{
+	using namespace frl::opc;
+	Executor executor( 2 );
+	UpdateScheduler scheduler( executor, 10 );
+	address_space::ChangeQueue queue;
+	std::vector< frl::UInt > taken;
+	frl::UInt runs = 0;
+	opc_address_space_test::DrainingTask task = { &queue, &taken, &runs };
+	scheduler.add( 1, task, 100 );
+	queue.setWakeUp( boost::bind( &UpdateScheduler::wakeUp, &scheduler, 1 ) );
+
+	scheduler.process( 100 );
+	scheduler.wait();
+	BOOST_CHECK( runs == 1 );
+	// idle task is not run
+	scheduler.process( 1000 );
+	scheduler.wait();
+	BOOST_CHECK( runs == 1 );
+
+	// period is over, so change is taken at next tick
+	queue.push( 7 );
+	scheduler.process( 1010 );
+	scheduler.wait();
+	BOOST_REQUIRE( runs == 2 );
+	BOOST_CHECK( taken.size() == 1 && taken[0] == 7 );
+
+	// but not earlier than one period after last run
+	queue.push( 8 );
+	queue.push( 9 );
+	scheduler.process( 1050 );
+	scheduler.wait();
+	BOOST_CHECK( runs == 2 );
+	scheduler.process( 1110 );
+	scheduler.wait();
+	BOOST_CHECK( runs == 3 );
+	BOOST_CHECK( taken.size() == 3 );
+
+	// new period of sleeping task is used after wake up
+	scheduler.reschedule( 1, 500 );
+	queue.push( 10 );
+	scheduler.process( 1500 );
+	scheduler.wait();
+	BOOST_CHECK( runs == 3 );
+	scheduler.process( 1610 );
+	scheduler.wait();
+	BOOST_CHECK( runs == 4 );
+	BOOST_CHECK( taken.size() == 4 );
+
+	scheduler.remove( 1 );
+	BOOST_CHECK( scheduler.size() == 0 );
+	queue.push( 11 );
+	scheduler.process( 3000 );
+	scheduler.wait();
+	BOOST_CHECK( runs == 4 );
+}
+
+BOOST_AUTO_TEST_CASE( executor_strands_and_stealing )
+{
+	using namespace frl::opc;
+	const int strandsNumber = 8;
+	const int tasksNumber = 500;
+	std::vector< std::vector< int > > done( strandsNumber );
+	std::vector< int > inside( strandsNumber, 0 );
+	bool overlapped = false;
+	boost::mutex guard;
+	int runs = 0;
+	{
+		Executor executor( 4 );
+		BOOST_CHECK( executor.getWorkersNumber() == 4 );
+		std::vector< Executor::Strand > strands;
+		for( int i = 0; i < strandsNumber; ++i )
+			strands.push_back( Executor::Strand( executor ) );
+		for( int i = 0; i < tasksNumber; ++i )
+		{
+			for( int j = 0; j < strandsNumber; ++j )
+			{
+				opc_address_space_test::OrderedTask task = { &done[j], &inside[j], &overlapped, i };
+				strands[j].post( task );
+			}
+		}
+		// tasks posted by workers are taken by other workers too
+		for( int i = 0; i < 4; ++i )
+		{
+			opc_address_space_test::ChainTask chain = { &executor, &guard, &runs, 999 };
+			executor.post( chain );
+		}
+	} // all posted tasks are run before executor is destroyed
+	BOOST_CHECK( ! overlapped );
+	for( int j = 0; j < strandsNumber; ++j )
+	{
+		BOOST_REQUIRE( done[j].size() == (size_t)tasksNumber );
+		for( int i = 0; i < tasksNumber; ++i )
+			BOOST_CHECK( done[j][i] == i );
+	}
+	BOOST_CHECK( runs == 4000 );
+}
+
+BOOST_AUTO_TEST_CASE( executor_survives_throwing_tasks )
+{
+	using namespace frl::opc;
+	std::vector< int > done;
+	int inside = 0;
+	bool overlapped = false;
+	boost::mutex guard;
+	int runs = 0;
+	{
+		Executor executor( 2 );
+		Executor::Strand strand( executor );
+		// strand goes on after its task throws
+		for( int i = 0; i < 10; ++i )
+		{
+			opc_address_space_test::ThrowingTask failed = { &guard, &runs };
+			strand.post( failed );
+			opc_address_space_test::OrderedTask task = { &done, &inside, &overlapped, i };
+			strand.post( task );
+		}
+		// so does worker
+		opc_address_space_test::ThrowingTask failed = { &guard, &runs };
+		for( int i = 0; i < 4; ++i )
+			executor.post( failed );
+	}
+	BOOST_CHECK( runs == 14 );
+	BOOST_CHECK( ! overlapped );
+	BOOST_REQUIRE( done.size() == 10 );
+	for( int i = 0; i < 10; ++i )
+		BOOST_CHECK( done[i] == i );
+}
+
+BOOST_AUTO_TEST_CASE( percent_deadband_of_analog_tags )
+{
+	using namespace frl::opc::address_space;
+	AddressSpace addressSpace;
+	addressSpace.finalConstruct( FRL_STR(".") );
+	Tag *tag = addressSpace.addLeaf( FRL_STR( "leaf1" ) );
+	Value prop;
+	BOOST_CHECK( ! tag->isAnalog() );
+	BOOST_CHECK( ! tag->getPropertyValue( property::HIGH_EU, prop ) );
+	size_t properties = tag->getAvailableProperties().size();
+	tag->setEURange( 0.0, 200.0 );
+	BOOST_CHECK( tag->isAnalog() );
+	BOOST_CHECK( tag->getAvailableProperties().size() == properties + 3 );
+	BOOST_CHECK( tag->getPropertyValue( property::EU_TYPE, prop ) );
+	BOOST_CHECK( int( prop ) == eu_type::ANALOG );
+	BOOST_CHECK( tag->getPropertyValue( property::HIGH_EU, prop ) );
+	BOOST_CHECK( double( prop ) == 200.0 );
+
+	BOOST_CHECK( DeadbandFilter::getThreshold( 5.0f, tag->getLowEU(), tag->getHighEU() ) == 10.0 );
+	BOOST_CHECK( DeadbandFilter::getThreshold( 0.0f, 0.0, 200.0 ) == DeadbandFilter::noDeadband );
+	BOOST_CHECK( DeadbandFilter::getThreshold( 5.0f, 10.0, 10.0 ) == DeadbandFilter::noDeadband );
+
+	DeadbandFilter filter;
+	filter.add( 50.0, 55.0, 10.0 );
+	filter.add( 50.0, 60.5, 10.0 );
+	filter.add( 50.0, 50.0, DeadbandFilter::noDeadband );
+	filter.add( 50.0, std::numeric_limits< double >::quiet_NaN(), 10.0 );
+	filter.run();
+	BOOST_CHECK( ! filter.isPassed( 0 ) );
+	BOOST_CHECK( filter.isPassed( 1 ) );
+	BOOST_CHECK( filter.isPassed( 2 ) );
+	BOOST_CHECK( filter.isPassed( 3 ) );
+	BOOST_CHECK( filter.getChecked() == 4 );
+	BOOST_CHECK( filter.getSuppressed() == 1 );
+
+	// counters go on after clear
+	filter.clear();
+	filter.add( 0.0, 1.0, 10.0 );
+	filter.run();
+	BOOST_CHECK( filter.size() == 1 );
+	BOOST_CHECK( ! filter.isPassed( 0 ) );
+	BOOST_CHECK( filter.getChecked() == 5 );
+	BOOST_CHECK( filter.getSuppressed() == 2 );
+}
+
+BOOST_AUTO_TEST_CASE( item_table_slots_and_handles )
+{
+	typedef frl::opc::ItemTable< int > Table;
+	Table table;
+	frl::UInt handle1 = table.insert( 10, 100, frl::True, -1.0f );
+	frl::UInt handle2 = table.insert( 20, 200, frl::False, 5.0f );
+	frl::UInt handle3 = table.insert( 30, 300, frl::True, -1.0f );
+	BOOST_CHECK( table.size() == 3 );
+	BOOST_CHECK( handle1 != 0 && handle1 != handle2 && handle2 != handle3 );
+	BOOST_CHECK( table.find( 0 ) == Table::npos );
+	size_t slot = table.find( handle2 );
+	BOOST_REQUIRE( slot != Table::npos );
+	BOOST_CHECK( table.getItem( slot ) == 20 );
+	BOOST_CHECK( table.getClientHandle( slot ) == 200 );
+	BOOST_CHECK( ! table.isActive( slot ) );
+	BOOST_CHECK( table.getDeadband( slot ) == 5.0f );
+	std::vector< frl::UInt > handles;
+	table.getActiveHandles( handles );
+	BOOST_CHECK( handles.size() == 2 && handles[0] == handle1 && handles[1] == handle3 );
+
+	// slot of removed item is reused, old handle stays invalid
+	table.erase( table.find( handle1 ) );
+	BOOST_CHECK( table.size() == 2 );
+	BOOST_CHECK( table.find( handle1 ) == Table::npos );
+	frl::UInt handle4 = table.insert( 40, 400, frl::True, -1.0f );
+	BOOST_CHECK( handle4 != handle1 );
+	BOOST_CHECK( table.find( handle4 ) == 0 );
+	BOOST_CHECK( table.getSlots() == 3 );
+	BOOST_CHECK( table.find( handle1 ) == Table::npos );
+	handles.clear();
+	table.getActiveHandles( handles );
+	BOOST_CHECK( handles.size() == 2 && handles[0] == handle4 && handles[1] == handle3 );
+
+	// slot is reused until its generation would wrap, stale handles never find new item
+	Table cycled;
+	frl::UInt first = cycled.insert( 1, 1, frl::True, -1.0f );
+	frl::UInt handle = first;
+	bool staleFound = false;
+	for( int i = 0; i < 5000; ++i )
+	{
+		frl::UInt stale = handle;
+		cycled.erase( cycled.find( handle ) );
+		handle = cycled.insert( 1, 1, frl::True, -1.0f );
+		staleFound = staleFound || cycled.find( stale ) != Table::npos || cycled.find( first ) != Table::npos;
+	}
+	BOOST_CHECK( ! staleFound );
+	BOOST_CHECK( cycled.getSlots() == 2 );
+	BOOST_CHECK( cycled.find( handle ) == 1 );
+	cycled.clear();
+	BOOST_CHECK( cycled.empty() && cycled.find( handle ) == Table::npos );
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 #endif // opc_address_space_test_suite_h_
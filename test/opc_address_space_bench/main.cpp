@@ -0,0 +1,290 @@
+// Benchmark of OPC address space core.
+// Usage: test_opc_address_space_bench [tags number] (500000 by default)
+#include <iostream>
+#include <vector>
+#include <cstdlib>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/scoped_array.hpp>
+#include "opc/address_space/frl_opc_address_space.h"
+#include "opc/address_space/frl_opc_leaf_enumerator.h"
+#include "opc/address_space/frl_opc_change_queue.h"
+#include "stream_std/frl_sstream.h"
+
+using namespace frl;
+using namespace frl::opc::address_space;
+
+namespace
+{
+	const size_t leafsInBranch = 100;
+	const size_t cellsInArea = 10;
+
+	class Timer
+	{
+	private:
+		const char *name;
+		size_t count;
+		boost::posix_time::ptime start;
+	public:
+		Timer( const char *name_, size_t count_ )
+			:	name( name_ ), count( count_ ),
+				start( boost::posix_time::microsec_clock::universal_time() )
+		{
+		}
+
+		~Timer()
+		{
+			boost::posix_time::time_duration d = boost::posix_time::microsec_clock::universal_time() - start;
+			double ms = d.total_microseconds() / 1000.0;
+			std::cout << name << ": " << count << " ops, " << ms << " ms";
+			if( count != 0 )
+				std::cout << ", " << ( ms * 1000000.0 / count ) << " ns/op";
+			std::cout << std::endl;
+		}
+	};
+
+	String makeName( const String &parent, const Char *prefix, size_t number )
+	{
+		stream_std::OutString ss;
+		if( ! parent.empty() )
+			ss << parent << FRL_STR( '.' );
+		ss << prefix << number;
+		return ss.str();
+	}
+}
+
+int main( int argc, char *argv[] )
+{
+	size_t tagsNumber = 500000;
+	if( argc > 1 )
+		tagsNumber = (size_t)std::atol( argv[1] );
+	if( tagsNumber == 0 )
+		tagsNumber = 1;
+
+	size_t branchesNumber = ( tagsNumber + leafsInBranch - 1 ) / leafsInBranch;
+	size_t areasNumber = ( branchesNumber + cellsInArea - 1 ) / cellsInArea;
+
+	std::vector< String > areas;
+	std::vector< String > branches;
+	std::vector< String > leafs;
+	areas.reserve( areasNumber );
+	branches.reserve( branchesNumber );
+	leafs.reserve( tagsNumber );
+	for( size_t a = 0; a < areasNumber; ++a )
+	{
+		areas.push_back( makeName( String(), FRL_STR( "area" ), a ) );
+		for( size_t c = 0; c < cellsInArea && branches.size() < branchesNumber; ++c )
+		{
+			branches.push_back( makeName( areas.back(), FRL_STR( "cell" ), c ) );
+			for( size_t t = 0; t < leafsInBranch && leafs.size() < tagsNumber; ++t )
+				leafs.push_back( makeName( branches.back(), FRL_STR( "tag" ), t ) );
+		}
+	}
+
+	std::cout << "OPC address space benchmark: " << leafs.size() << " tags in "
+		<< branches.size() << " branches" << std::endl;
+
+	AddressSpace addressSpace;
+	addressSpace.finalConstruct( FRL_STR( "." ) );
+	std::vector< Tag* > tags( leafs.size() );
+
+	{
+		Timer timer( "add", areas.size() + branches.size() + leafs.size() );
+		for( size_t i = 0; i < areas.size(); ++i )
+			addressSpace.addBranch( areas[i] );
+		for( size_t i = 0; i < branches.size(); ++i )
+			addressSpace.addBranch( branches[i] );
+		for( size_t i = 0; i < leafs.size(); ++i )
+			tags[i] = addressSpace.addLeaf( leafs[i] );
+	}
+
+	{
+		MemoryUsage usage = addressSpace.getMemoryUsage();
+		std::cout << "memory: " << usage.getTotalSize() / 1024 << " KB, "
+			<< usage.getBytesPerTag() << " bytes/tag (sizeof(Tag) = " << sizeof( Tag )
+			<< ", objects " << usage.tagsSize / 1024
+			<< " KB, IDs " << usage.idsSize / 1024
+			<< " KB, children " << usage.childrenSize / 1024
+			<< " KB, indexes " << usage.indexesSize / 1024 << " KB)" << std::endl;
+	}
+
+	size_t found = 0;
+	{
+		Timer timer( "lookup (getLeaf)", leafs.size() );
+		for( size_t i = 0; i < leafs.size(); ++i )
+			found += ( addressSpace.getLeaf( leafs[i] ) == tags[i] );
+	}
+
+	{
+		std::vector< TagHandle > handles( tags.size() );
+		for( size_t i = 0; i < tags.size(); ++i )
+			handles[i] = addressSpace.getHandle( tags[i] );
+		Timer timer( "lookup by handle (findTag)", tags.size() );
+		for( size_t i = 0; i < tags.size(); ++i )
+			found += ( addressSpace.findTag( handles[i] ) == tags[i] );
+	}
+
+	{
+		Timer timer( "exist (isExistLeaf)", leafs.size() );
+		for( size_t i = 0; i < leafs.size(); ++i )
+			found += addressSpace.isExistLeaf( leafs[i] );
+	}
+
+	{
+		Timer timer( "write", tags.size() );
+		for( size_t i = 0; i < tags.size(); ++i )
+			tags[i]->write( Value( (double)i ) );
+	}
+
+	size_t queued = 0;
+	{
+		// every tag listened by group item
+		ChangeQueue queue;
+		boost::scoped_array< QueuedTagListener > listeners( new QueuedTagListener[ tags.size() ] );
+		for( size_t i = 0; i < tags.size(); ++i )
+		{
+			listeners[i].setQueue( &queue, (UInt)i );
+			tags[i]->addListener( &listeners[i] );
+		}
+		Timer timer( "write with listener (change queue)", tags.size() );
+		for( size_t i = 0; i < tags.size(); ++i )
+			tags[i]->write( Value( i + 0.5 ) );
+		queued = queue.size();
+	}
+
+	size_t browsed = 0;
+	{
+		Timer timer( "browse", branches.size() );
+		std::vector< TagBrowseInfo > info;
+		for( size_t i = 0; i < branches.size(); ++i )
+		{
+			info.clear();
+			addressSpace.getBranch( branches[i] )->browse( info );
+			browsed += info.size();
+		}
+	}
+
+	{
+		Timer timer( "getAllLeafs", 1 );
+		std::vector< String > all;
+		addressSpace.getAllLeafs( all, 0 );
+		browsed += all.size();
+	}
+
+	{
+		// the same leafs by chunks, only one chunk of names at once
+		Timer timer( "flat enumeration (LeafEnumerator)", leafs.size() );
+		LeafEnumerator enumerator( addressSpace );
+		String id;
+		while( enumerator.next( id ) )
+			++browsed;
+	}
+
+	// flat browse with filter: prefix selects one area, wildcard walks everything
+	size_t filtered = 0, expected = 0;
+	{
+		NamePattern pattern( FRL_STR( "area1.*" ) );
+		for( size_t i = 0; i < leafs.size(); ++i )
+			expected += pattern.match( leafs[i] );
+		std::vector< String > names;
+		Timer timer( "flat browse with filter (area1.*)", 1 );
+		addressSpace.getAllLeafs( names, pattern, 0 );
+		filtered += names.size();
+	}
+	{
+		NamePattern pattern( FRL_STR( "*.cell#.tag7" ) );
+		for( size_t i = 0; i < leafs.size(); ++i )
+			expected += pattern.match( leafs[i] );
+		std::vector< String > names;
+		Timer timer( "flat browse with filter (*.cell#.tag7)", 1 );
+		addressSpace.getAllLeafs( names, pattern, 0 );
+		filtered += names.size();
+	}
+
+	// every 100th leaf is writable R8: queries by secondary indexes
+	for( size_t i = 0; i < tags.size(); i += 100 )
+	{
+		tags[i]->isWritable( True );
+		tags[i]->setCanonicalDataType( data_type::R8 );
+		expected += 2;
+	}
+	{
+		std::vector< String > names;
+		Timer timer( "writable leafs (getAllLeafs by index)", 1 );
+		addressSpace.getAllLeafs( names, access_rights::WRITEABLE );
+		filtered += names.size();
+	}
+	{
+		std::vector< String > names;
+		Timer timer( "writable R8 leafs (findLeafs)", 1 );
+		addressSpace.findLeafs( names, access_rights::WRITEABLE, data_type::R8 );
+		filtered += names.size();
+	}
+
+	{
+		AddressSpace bulkSpace;
+		bulkSpace.finalConstruct( FRL_STR( "." ) );
+		std::vector< LeafDefinition > definitions;
+		definitions.reserve( leafs.size() );
+		for( size_t i = 0; i < leafs.size(); ++i )
+			definitions.push_back( LeafDefinition( leafs[i], data_type::R8 ) );
+		std::vector< Tag* > added;
+		{
+			Timer timer( "bulk add (addLeafs)", areas.size() + branches.size() + leafs.size() );
+			bulkSpace.addLeafs( definitions, added );
+		}
+		for( size_t i = 0; i < added.size(); ++i )
+			found += ( bulkSpace.findLeaf( leafs[i] ) == added[i] );
+		{
+			Timer timer( "remove every 10th leaf (removeTag)", ( leafs.size() + 9 ) / 10 );
+			for( size_t i = 0; i < leafs.size(); i += 10 )
+				bulkSpace.removeTag( leafs[i] );
+		}
+	}
+
+	size_t restoredNumber = 0;
+	{
+		// binary image of whole address space instead of tag by tag construction
+		std::vector< char > image;
+		{
+			Timer timer( "save snapshot", areas.size() + branches.size() + leafs.size() );
+			addressSpace.saveSnapshot( image );
+		}
+		AddressSpace restored;
+		{
+			Timer timer( "load snapshot", areas.size() + branches.size() + leafs.size() );
+			restored.loadSnapshot( &image[0], image.size() );
+		}
+		for( size_t i = 0; i < leafs.size(); ++i )
+			restoredNumber += ( restored.findLeaf( leafs[i] ) != NULL );
+	}
+
+	size_t paged = 0;
+	{
+		// one big branch browsed by pages of 1000 elements
+		AddressSpace pagedSpace;
+		pagedSpace.finalConstruct( FRL_STR( "." ) );
+		std::vector< LeafDefinition > definitions;
+		definitions.reserve( leafs.size() );
+		for( size_t i = 0; i < leafs.size(); ++i )
+			definitions.push_back( LeafDefinition( makeName( FRL_STR( "big" ), FRL_STR( "tag" ), i ) ) );
+		pagedSpace.addLeafs( definitions );
+		Tag *big = pagedSpace.getBranch( FRL_STR( "big" ) );
+		std::vector< TagBrowseInfo > page;
+		String cp;
+		Timer timer( "paged browse (one branch, 1000 per page)", leafs.size() / 1000 + 1 );
+		do
+		{
+			big->browsePage( page, browse_filter::ALL, cp, 1000, NamePattern(), cp );
+			paged += page.size();
+		}
+		while( ! cp.empty() );
+	}
+
+	if( found != 4 * leafs.size() || browsed != 3 * leafs.size() || paged != leafs.size() || queued != leafs.size()
+		|| filtered != expected || restoredNumber != leafs.size() )
+	{
+		std::cout << "benchmark check failed" << std::endl;
+		return 1;
+	}
+	return 0;
+}